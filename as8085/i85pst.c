@@ -115,7 +115,8 @@ struct mne mne[] = {
     {NULL, ".title", S_HEADER, 0, O_TITLE},
     {NULL, ".sbttl", S_HEADER, 0, O_SBTTL},
     {NULL, ".module", S_MODUL, 0, 0},
-    {NULL, ".include", S_INCL, 0, 0},
+    {NULL, ".include", S_INCL, 0, O_INCL},
+    {NULL, ".incbin", S_INCL, 0, O_INCBIN},
     {NULL, ".area", S_AREA, 0, 0},
     {NULL, ".bank", S_BANK, 0, 0},
     {NULL, ".org", S_ORG, 0, 0},
@@ -0,0 +1,325 @@
+/* asxxbgen.c */
+
+/*
+ *  Copyright (C) 1989-2014  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Synthetic benchmark source generator.
+ *
+ * asxxbgen creates a corpus of assembler source files
+ * for the benchmark harness asxxbnch.sh:
+ *
+ *	bmNN.asm	the program modules
+ *	bincN.inc	a chain of nested include files
+ *	blNN.asm	the library member modules
+ *	bench.lib	the library file listing the members
+ *
+ * The number of source lines the assembler will read,
+ * counting the include files once for each module, is
+ * written to stdout.
+ */
+
+int nmod = 4;   /* Program Modules		*/
+int nlab = 500; /* Labels per Module		*/
+int ndef = 100; /* .defines per Module		*/
+int nmac = 10;  /* Macros per Module		*/
+int ninc = 4;   /* Include Depth		*/
+int ntmp = 2;   /* n$ Temporaries per Label	*/
+int nrel = 2;   /* External References per Label */
+int nlib = 8;   /* Library Members		*/
+int nent = 16;  /* Entry Points per Member	*/
+int i8085 = 0;  /* 8085 Source Flag		*/
+
+char *odir = "."; /* Output Directory		*/
+long nlines;      /* Lines Generated		*/
+long nincl;       /* Include File Lines		*/
+
+/*)Function	FILE *	bopen(name)
+ *
+ *		char *	name		file name
+ *
+ *	The function bopen() creates the file name
+ *	in the output directory.
+ */
+
+FILE *bopen(name)
+char *name;
+{
+  char fn[1024];
+  FILE *fp;
+
+  sprintf(fn, "%s/%s", odir, name);
+  if ((fp = fopen(fn, "w")) == NULL) {
+    fprintf(stderr, "?ASxxxx-Error-<cannot create> : \"%s\"\n", fn);
+    exit(1);
+  }
+  return (fp);
+}
+
+/*
+ * Output and count a source line.
+ */
+#define bline nlines++, fprintf
+
+/*)Function	VOID	bincl()
+ *
+ *	The function bincl() creates the include file chain,
+ *	each file defines symbols and .defines and includes
+ *	the next file.
+ */
+
+void bincl() {
+  FILE *fp;
+  char fn[32];
+  int i, j;
+
+  for (i = 0; i < ninc; i++) {
+    sprintf(fn, "binc%d.inc", i);
+    fp = bopen(fn);
+    bline(fp, "\t; Include level %d\n", i);
+    for (j = 0; j < 16; j++) {
+      bline(fp, "\tI%d_%d = 0x%X\n", i, j, (i * 16 + j) & 0xFF);
+    }
+    bline(fp, "\t.define\tIDEF%d, ^/I%d_0 + %d/\n", i, i, i);
+    if (i + 1 < ninc) {
+      bline(fp, "\t.include \"binc%d.inc\"\n", i + 1);
+    }
+    fclose(fp);
+  }
+  nincl = nlines;
+}
+
+/*)Function	VOID	bmod(m)
+ *
+ *		int	m		module number
+ *
+ *	The function bmod() creates program module m with
+ *	.defines, macros, labels, n$ temporaries, and
+ *	references to the library members.
+ */
+
+void bmod(m)
+int m;
+{
+  FILE *fp;
+  char fn[32];
+  int i, j, k, n;
+
+  sprintf(fn, "bm%02d.asm", m);
+  fp = bopen(fn);
+  bline(fp, "\t.title\tBenchmark Module %d\n", m);
+  bline(fp, "\t.module\tbm%02d\n", m);
+  if (ninc) {
+    bline(fp, "\t.include \"binc0.inc\"\n");
+  }
+  for (i = 0; i < ndef; i++) {
+    bline(fp, "\t.define\tD%d_%d, ^/0x%X/\n", m, i, (i * 7) & 0xFFFF);
+  }
+  for (i = 0; i < nmac; i++) {
+    bline(fp, "\t.macro\tM%d_%d\tv, lbl\n", m, i);
+    if (i8085) {
+      bline(fp, "\tmvi\ta,#v\n");
+      bline(fp, "\tlxi\th,#lbl\n");
+    } else {
+      bline(fp, "\tld\ta,#v\n");
+      bline(fp, "\tld\thl,#lbl\n");
+    }
+    bline(fp, "\t.endm\n");
+  }
+  for (i = 0; i < nlib; i++) {
+    for (j = 0; j < nent; j++) {
+      bline(fp, "\t.globl\tg%d_%d\n", i, j);
+    }
+  }
+  bline(fp, "\t.area\t_CODE (REL,CON)\n");
+  bline(fp, "bm%02d::\n", m);
+  for (i = 0; i < nlab; i++) {
+    if (i8085) {
+      bline(fp, "L%d_%d:\tlxi\th,#D%d_%d\n", m, i, m, ndef ? i % ndef : 0);
+      bline(fp, "\tmvi\ta,#%d\n", i & 0xFF);
+    } else {
+      bline(fp, "L%d_%d:\tld\thl,#D%d_%d\n", m, i, m, ndef ? i % ndef : 0);
+      bline(fp, "\tld\ta,#%d\n", i & 0xFF);
+    }
+    for (j = 1; j <= ntmp; j++) {
+      if (i8085) {
+        bline(fp, "%d$:\tdcr\ta\n", j);
+        bline(fp, "\tjnz\t%d$\n", j);
+      } else {
+        bline(fp, "%d$:\tdec\ta\n", j);
+        bline(fp, "\tjr\tnz,%d$\n", j);
+      }
+    }
+    for (j = 0; j < nrel; j++) {
+      n = nlib ? (i * nrel + j + m) % nlib : 0;
+      k = (i + j) % nent;
+      if (nlib) {
+        bline(fp, "\tcall\tg%d_%d\n", n, k);
+      }
+    }
+    if (nmac) {
+      bline(fp, "\tM%d_%d\t%d, L%d_%d\n", m, i % nmac, i & 0x7F, m, i);
+    }
+    if (ninc) {
+      bline(fp, "\t.db\tIDEF%d, I%d_%d, >L%d_%d\n", i % ninc, i % ninc,
+            i % 16, m, i);
+    }
+  }
+  bline(fp, "\tret\n");
+  bline(fp, "\t.end\n");
+  fclose(fp);
+}
+
+/*)Function	VOID	blib()
+ *
+ *	The function blib() creates the library members
+ *	and the library file bench.lib.
+ */
+
+void blib() {
+  FILE *fp, *lfp;
+  char fn[32];
+  int i, j;
+
+  lfp = bopen("bench.lib");
+  for (i = 0; i < nlib; i++) {
+    sprintf(fn, "bl%02d.asm", i);
+    fprintf(lfp, "bl%02d.rel\n", i);
+    fp = bopen(fn);
+    bline(fp, "\t.module\tbl%02d\n", i);
+    bline(fp, "\t.area\t_CODE (REL,CON)\n");
+    for (j = 0; j < nent; j++) {
+      if (i8085) {
+        bline(fp, "g%d_%d::\tmvi\ta,#%d\n", i, j, j);
+      } else {
+        bline(fp, "g%d_%d::\tld\ta,#%d\n", i, j, j);
+      }
+      bline(fp, "\tret\n");
+    }
+    fclose(fp);
+  }
+  fclose(lfp);
+}
+
+char *usetxt[] = {
+    "Usage: asxxbgen [-Options]",
+    "  -n   program modules         (4)",
+    "  -l   labels per module       (500)",
+    "  -d   .defines per module     (100)",
+    "  -m   macros per module       (10)",
+    "  -i   include depth           (4)",
+    "  -t   n$ temporaries per label (2)",
+    "  -r   external references per label (2)",
+    "  -b   library members         (8)",
+    "  -e   entry points per member (16)",
+    "  -8   8085 source (default Z80)",
+    "  -o   output directory        (.)",
+    0};
+
+/*)Function	int	main(argc, argv)
+ *
+ *		int	argc		argument count
+ *		char *	argv		array of pointers to argument strings
+ *
+ *	The function main() evaluates the options and
+ *	generates the benchmark corpus.
+ */
+
+int main(argc, argv)
+int argc;
+char *argv[];
+{
+  char **dp;
+  int i, *np;
+
+  for (i = 1; i < argc; i++) {
+    if (argv[i][0] != '-' || argv[i][1] == 0 || argv[i][2] != 0) {
+      goto usage;
+    }
+    switch (argv[i][1]) {
+    case '8':
+      i8085 = 1;
+      continue;
+    case 'o':
+      if (++i >= argc)
+        goto usage;
+      odir = argv[i];
+      continue;
+    case 'n':
+      np = &nmod;
+      break;
+    case 'l':
+      np = &nlab;
+      break;
+    case 'd':
+      np = &ndef;
+      break;
+    case 'm':
+      np = &nmac;
+      break;
+    case 'i':
+      np = &ninc;
+      break;
+    case 't':
+      np = &ntmp;
+      break;
+    case 'r':
+      np = &nrel;
+      break;
+    case 'b':
+      np = &nlib;
+      break;
+    case 'e':
+      np = &nent;
+      break;
+    default:
+      goto usage;
+    }
+    if (++i >= argc)
+      goto usage;
+    *np = atoi(argv[i]);
+    if (*np < 0)
+      goto usage;
+  }
+  if (nent < 1)
+    nent = 1;
+  if (ntmp > 9)
+    ntmp = 9;
+
+  bincl();
+  for (i = 0; i < nmod; i++) {
+    bmod(i);
+  }
+  blib();
+  fprintf(stdout, "%ld\n", nlines + nincl * (nmod - 1));
+  return (0);
+
+usage:
+  for (dp = usetxt; *dp; dp++) {
+    fprintf(stderr, "%s\n", *dp);
+  }
+  return (1);
+}
@@ -0,0 +1,137 @@
+#!/bin/sh
+#
+# asxxbnch.sh
+#
+# Benchmark harness for asz80, as8085 and aslink.
+#
+# Usage: asxxbnch.sh bindir workdir [baseline]
+#
+#	bindir		directory containing asz80, as8085,
+#			aslink and asxxbgen
+#	workdir		scratch directory for the corpora
+#	baseline	stored results, each line "metric value"
+#
+# Environment:
+#	BENCH_RUNS	timed runs of each step, the best
+#			time is reported (5)
+#	BENCH_TOL	allowed slowdown in percent before a
+#			metric is reported as a regression (15)
+#	BENCH_SAVE	if set the results replace the baseline
+#
+# Each corpus is generated by asxxbgen, assembled with
+# -glos, and linked with -u -i -m against a library.
+# The assembler throughput is reported as source lines
+# per second, the linker throughput as relocations per
+# second (from the aslink -aa statistics).  The exit
+# status is 1 if any metric regressed.
+#
+
+BIN=$1
+WRK=$2
+BASE=$3
+RUNS=${BENCH_RUNS:-5}
+TOL=${BENCH_TOL:-15}
+
+if [ -z "$BIN" ] || [ -z "$WRK" ]; then
+	echo "Usage: asxxbnch.sh bindir workdir [baseline]" >&2
+	exit 2
+fi
+BIN=`cd $BIN && pwd`
+if [ -n "$BASE" ]; then
+	BASE=`cd \`dirname $BASE\` && pwd`/`basename $BASE`
+fi
+rm -rf $WRK
+mkdir -p $WRK || exit 2
+WRK=`cd $WRK && pwd`
+RES=$WRK/results.txt
+: > $RES
+
+# now - current time in nanoseconds
+now() {
+	date +%s%N
+}
+
+# best cmd... - run cmd $RUNS times, print best time in nanoseconds
+best() {
+	b=0
+	r=0
+	while [ $r -lt $RUNS ]; do
+		t0=`now`
+		"$@" > /dev/null 2>&1
+		t1=`now`
+		t=`expr $t1 - $t0`
+		if [ $b -eq 0 ] || [ $t -lt $b ]; then
+			b=$t
+		fi
+		r=`expr $r + 1`
+	done
+	echo $b
+}
+
+# asmall as - assemble all modules of the corpus
+asmall() {
+	for f in bl*.asm bm*.asm; do
+		$1 -glos ${f%.asm} || return 1
+	done
+}
+
+# corpus name assembler [asxxbgen options] - time one corpus
+corpus() {
+	name=$1
+	as=$BIN/$2
+	shift 2
+	dir=$WRK/$name
+	mkdir -p $dir
+	cd $dir
+	lines=`$BIN/asxxbgen -o $dir "$@"`
+	mods=`ls bm*.asm | sed 's/\.asm$//'`
+	if ! asmall $as > $dir/asm.log 2>&1; then
+		echo "$name: assembly failed, see $dir/asm.log" >&2
+		exit 2
+	fi
+
+	tasm=`best asmall $as`
+	tlnk=`best $BIN/aslink -n -u -i -m bench $mods -l bench.lib`
+	relocs=`$BIN/aslink -n -aa -u -i bench $mods -l bench.lib | \
+		sed -n 's/.*"relocations": \([0-9]*\).*/\1/p'`
+
+	echo "$name.asm.lines_per_sec" `expr $lines \* 1000000 / \( $tasm / 1000 + 1 \)` >> $RES
+	echo "$name.link.relocs_per_sec" `expr ${relocs:-0} \* 1000000 / \( $tlnk / 1000 + 1 \)` >> $RES
+	printf "%-10s %8d lines %8d ms asm %8d relocations %8d ms link\n" \
+		$name $lines `expr $tasm / 1000000` ${relocs:-0} `expr $tlnk / 1000000`
+	cd $WRK
+}
+
+echo "ASxxxx Benchmark ($RUNS runs, best time)"
+corpus z80     asz80
+corpus z80defs asz80 -d 1000 -m 100 -i 6 -l 400
+corpus z80rel  asz80 -r 6 -t 0 -l 400 -b 32
+corpus i8085   as8085 -8
+echo
+
+# Compare with the baseline
+status=0
+printf "%-28s %12s %12s %8s\n" "Metric" "Current" "Baseline" "Change"
+while read metric value; do
+	old=""
+	if [ -n "$BASE" ] && [ -f "$BASE" ]; then
+		old=`sed -n "s/^$metric  *\([0-9]*\)$/\1/p" $BASE`
+	fi
+	if [ -z "$old" ] || [ "$old" -eq 0 ]; then
+		printf "%-28s %12d %12s %8s\n" $metric $value "-" "-"
+		continue
+	fi
+	pct=`expr \( $value - $old \) \* 100 / $old`
+	flag=""
+	if [ $pct -lt -$TOL ]; then
+		flag="  REGRESSION"
+		status=1
+	fi
+	printf "%-28s %12d %12d %7d%%%s\n" $metric $value $old $pct "$flag"
+done < $RES
+
+if [ -n "$BENCH_SAVE" ] && [ -n "$BASE" ]; then
+	cp $RES $BASE
+	echo "Baseline saved in $BASE"
+fi
+exit $status
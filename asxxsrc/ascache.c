@@ -0,0 +1,607 @@
+/* ascache.c */
+
+/*
+ *  Copyright (C) 1989-2019  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include "asxxxx.h"
+
+#include <sys/stat.h>
+
+/*)Module	ascache.c
+ *
+ *	The module ascache.c contains the functions of the
+ *	-k result cache.  An assembly is identified by a key
+ *	made from the assembler version and cpu, the command
+ *	line arguments, and the contents of the source files.
+ *	The files read by the assembly on any pass (found by
+ *	depadd()) are saved with their content hashes in the
+ *	manifest file KEY.m of the cache directory.  An
+ *	assembly reading a different set of files on some
+ *	pass is not saved and is always assembled.
+ *
+ *	Before assembling, the files named in the manifest are
+ *	hashed again.  When all are unchanged the result key,
+ *	made from the key and these hashes, names the saved
+ *	output files RESULT.rel, RESULT.lst, ... which are
+ *	copied to the output files and no assembly is done.
+ *	Otherwise the assembly is made and, when there are no
+ *	errors, the manifest and outputs are saved.
+ *
+ *	The cache directory is taken from the ASXCACHE
+ *	environment variable, .asxcache by default.
+ *
+ *	ascache.c contains the following functions:
+ *		VOID	chbgn(hp)
+ *		int	chcopy(from, to)
+ *		char *	chext(i)
+ *		int	chfile(fn, hp)
+ *		VOID	chkey(argc, argv)
+ *		int	chload(q)
+ *		char *	chname(hp, ext)
+ *		VOID	chsave(q)
+ *		VOID	chstr(hp, bp, n)
+ *
+ *	ascache.c contains the following local variables:
+ *		struct chash	chk	key of the assembly
+ *		char	chfn[]		cache file name
+ *		char *	chdr		cache directory
+ */
+
+static struct chash chk;
+static char chfn[FILSPC + FILSPC + 32];
+static char *chdr;
+
+/*)Function	VOID	chbgn(hp)
+ *)Function	VOID	chstr(hp, bp, n)
+ *
+ *		chash *	hp		pointer to a hash value
+ *		char *	bp		pointer to the bytes
+ *		int	n		number of bytes
+ *
+ *	The function chbgn() starts a hash value and the
+ *	function chstr() adds n bytes to a hash value.
+ *	The two 32-bit halves are the FNV-1a hash and a
+ *	shift-add-xor hash of the bytes.
+ *
+ *	local variables:
+ *		unsigned INT32	a	FNV-1a hash
+ *		unsigned INT32	b	shift-add-xor hash
+ *		int	c		current byte
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The hash value is updated.
+ */
+
+VOID chbgn(hp)
+struct chash *hp;
+{
+  hp->h_a = 2166136261U;
+  hp->h_b = 5381;
+}
+
+VOID chstr(hp, bp, n)
+struct chash *hp;
+char *bp;
+int n;
+{
+  unsigned INT32 a, b;
+  int c;
+
+  a = hp->h_a;
+  b = hp->h_b;
+  while (n-- > 0) {
+    c = *bp++ & 0xFF;
+    a = (a ^ c) * 16777619U;
+    b = ((b << 5) + (b >> 2) + c) ^ b;
+  }
+  hp->h_a = a & 0xFFFFFFFF;
+  hp->h_b = b & 0xFFFFFFFF;
+}
+
+/*)Function	int	chfile(fn, hp)
+ *
+ *		char *	fn		file specification
+ *		chash *	hp		pointer to a hash value
+ *
+ *	The function chfile() adds the contents of the
+ *	file fn to the hash value.
+ *
+ *	chfile() returns a (1) if the file was read
+ *	else a (0).
+ *
+ *	local variables:
+ *		FILE *	fp		file handle
+ *		char	buf[]		read buffer
+ *		int	n		bytes read
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID	chstr()		ascache.c
+ *		int	fclose()	c_library
+ *		FILE *	fopen()		c_library
+ *		size_t	fread()		c_library
+ *
+ *	side effects:
+ *		The hash value is updated.
+ */
+
+int chfile(fn, hp)
+char *fn;
+struct chash *hp;
+{
+  FILE *fp;
+  char buf[4096];
+  int n;
+
+  if ((fp = fopen(fn, "rb")) == NULL) {
+    return (0);
+  }
+  while ((n = (int)fread(buf, 1, sizeof(buf), fp)) > 0) {
+    chstr(hp, buf, n);
+  }
+  fclose(fp);
+  return (1);
+}
+
+/*)Function	char *	chname(hp, ext)
+ *
+ *		chash *	hp		pointer to a hash value
+ *		char *	ext		file extension
+ *
+ *	The function chname() returns the name of the cache
+ *	file for the hash value with the extension ext.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		char	chfn[]		cache file name
+ *		char *	chdr		cache directory
+ *
+ *	functions called:
+ *		int	sprintf()	c_library
+ *
+ *	side effects:
+ *		The name is built in chfn[].
+ */
+
+char *chname(hp, ext)
+struct chash *hp;
+char *ext;
+{
+  sprintf(chfn, "%.*s/%08lX%08lX.%s", FILSPC, chdr, (unsigned long)hp->h_a,
+          (unsigned long)hp->h_b, ext);
+  return (chfn);
+}
+
+/*)Function	char *	chext(i)
+ *
+ *		int	i		output file index
+ *
+ *	The function chext() returns the extension of the
+ *	i'th output file created by this assembly or NULL
+ *	if the file is not created.  The index i runs from
+ *	0 to NCHEXT - 1.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		int	lflag		-l, generate listing flag
+ *		int	mflag		-m, generate dependency file flag
+ *		int	oflag		-o, generate relocatable output flag
+ *		int	sflag		-s, generate symbol table flag
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+char *chext(i)
+int i;
+{
+  switch (i) {
+  case 0:
+    return (oflag ? "rel" : NULL);
+  case 1:
+    return (lflag ? "lst" : NULL);
+  case 2:
+    return ((lflag && oflag) ? "hlr" : NULL);
+  case 3:
+    return (sflag ? "sym" : NULL);
+  case 4:
+    return (mflag ? "d" : NULL);
+  default:
+    break;
+  }
+  return (NULL);
+}
+
+/*)Function	int	chcopy(from, to)
+ *
+ *		char *	from		file to copy
+ *		char *	to		file to create
+ *
+ *	The function chcopy() copies the file from to the
+ *	file to.  The copy is made in a temporary file which
+ *	is then renamed so that an incomplete file is never
+ *	found in the cache.
+ *
+ *	chcopy() returns a (1) if the file was copied
+ *	else a (0).
+ *
+ *	local variables:
+ *		FILE *	ifp		input file handle
+ *		FILE *	ofp		output file handle
+ *		char	buf[]		copy buffer
+ *		char	tmp[]		temporary file name
+ *		int	n		bytes read
+ *		int	ok		copy status
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		int	fclose()	c_library
+ *		FILE *	fopen()		c_library
+ *		size_t	fread()		c_library
+ *		size_t	fwrite()	c_library
+ *		int	remove()	c_library
+ *		int	rename()	c_library
+ *		int	sprintf()	c_library
+ *
+ *	side effects:
+ *		The file to is created.
+ */
+
+int chcopy(from, to)
+char *from;
+char *to;
+{
+  FILE *ifp, *ofp;
+  char buf[4096];
+  char tmp[FILSPC + FILSPC + 40];
+  int n, ok;
+
+  if ((ifp = fopen(from, "rb")) == NULL) {
+    return (0);
+  }
+  sprintf(tmp, "%.*s.tmp", FILSPC + FILSPC + 32, to);
+  if ((ofp = fopen(tmp, "wb")) == NULL) {
+    fclose(ifp);
+    return (0);
+  }
+  ok = 1;
+  while ((n = (int)fread(buf, 1, sizeof(buf), ifp)) > 0) {
+    if (fwrite(buf, 1, (size_t)n, ofp) != (size_t)n) {
+      ok = 0;
+      break;
+    }
+  }
+  fclose(ifp);
+  if (fclose(ofp) != 0) {
+    ok = 0;
+  }
+  if (ok) {
+    remove(to);
+    ok = (rename(tmp, to) == 0);
+  }
+  if (!ok) {
+    remove(tmp);
+  }
+  return (ok);
+}
+
+/*)Function	VOID	chkey(argc, argv)
+ *
+ *		int	argc		argument count
+ *		char *	argv		array of pointers to argument strings
+ *
+ *	The function chkey() makes the key of the assembly
+ *	from the assembler version and cpu, the command line
+ *	arguments, and the contents of the source files.
+ *
+ *	local variables:
+ *		asmf *	ap		pointer to an asmf structure
+ *		int	i		loop counter
+ *
+ *	global variables:
+ *		asmf *	asmp		pointer to first assembler file
+ *		struct chash	chk	key of the assembly
+ *		char *	chdr		cache directory
+ *		char *	cpu		assembler type string
+ *
+ *	functions called:
+ *		VOID	chbgn()		ascache.c
+ *		int	chfile()	ascache.c
+ *		VOID	chstr()		ascache.c
+ *		char *	getenv()	c_library
+ *		int	mkdir()		c_library
+ *		int	strlen()	c_library
+ *
+ *	side effects:
+ *		The key is made and the cache
+ *		directory may be created.
+ */
+
+VOID chkey(argc, argv)
+int argc;
+char *argv[];
+{
+  struct asmf *ap;
+  int i;
+
+  if (((chdr = getenv("ASXCACHE")) == NULL) || (*chdr == 0)) {
+    chdr = ".asxcache";
+  }
+#if ASMCACHE
+  mkdir(chdr, 0777);
+#endif
+
+  chbgn(&chk);
+  chstr(&chk, VERSION, (int)strlen(VERSION) + 1);
+  chstr(&chk, cpu, (int)strlen(cpu) + 1);
+  for (i = 1; i < argc; i++) {
+    chstr(&chk, argv[i], (int)strlen(argv[i]) + 1);
+  }
+  for (ap = asmp; ap != NULL; ap = ap->next) {
+    if (ap->objtyp == T_ASM) {
+      chfile(ap->afn, &chk);
+    }
+  }
+}
+
+/*)Function	int	chload(q)
+ *
+ *		char *	q		output file specification
+ *
+ *	The function chload() looks up the assembly in the
+ *	cache.  Each file named in the manifest is hashed and
+ *	compared with the saved hash.  When all files are
+ *	unchanged and all output files are in the cache the
+ *	outputs are copied from the cache.
+ *
+ *	chload() returns a (1) if the outputs were restored
+ *	else a (0).
+ *
+ *	local variables:
+ *		FILE *	fp		manifest file handle
+ *		struct chash	rk	result key
+ *		struct chash	h	file hash
+ *		char	buf[]		manifest line
+ *		char	fn[]		cached file name
+ *		char *	p		file name in buf[]
+ *		char *	ext		output file extension
+ *		unsigned long	a	saved hash first half
+ *		unsigned long	b	saved hash second half
+ *		int	i		loop counter
+ *		int	n		manifest line length
+ *
+ *	global variables:
+ *		char	afntmp[]	afilex() constructed filespec
+ *		struct chash	chk	key of the assembly
+ *
+ *	functions called:
+ *		VOID	afilex()	asmain.c
+ *		VOID	chbgn()		ascache.c
+ *		int	chcopy()	ascache.c
+ *		char *	chext()		ascache.c
+ *		int	chfile()	ascache.c
+ *		char *	chname()	ascache.c
+ *		VOID	chstr()		ascache.c
+ *		int	fclose()	c_library
+ *		char *	fgets()		c_library
+ *		FILE *	fopen()		c_library
+ *		int	sscanf()	c_library
+ *		char *	strcpy()	c_library
+ *
+ *	side effects:
+ *		The output files may be created.
+ */
+
+int chload(q)
+char *q;
+{
+  FILE *fp;
+  struct chash rk, h;
+  char buf[FILSPC + FILSPC + 32];
+  char fn[FILSPC + FILSPC + 32];
+  char *p, *ext;
+  unsigned long a, b;
+  int i, n;
+
+  if ((fp = fopen(chname(&chk, "m"), "r")) == NULL) {
+    return (0);
+  }
+  rk = chk;
+  while (fgets(buf, sizeof(buf), fp) != NULL) {
+    n = (int)strlen(buf);
+    while ((n > 0) && ((buf[n - 1] == '\n') || (buf[n - 1] == '\r'))) {
+      buf[--n] = 0;
+    }
+    if ((n < 18) || (sscanf(buf, "%8lX%8lX", &a, &b) != 2)) {
+      fclose(fp);
+      return (0);
+    }
+    p = &buf[17];
+    chbgn(&h);
+    if (!chfile(p, &h) || (h.h_a != a) || (h.h_b != b)) {
+      fclose(fp);
+      return (0);
+    }
+    chstr(&rk, buf, 16);
+  }
+  fclose(fp);
+
+  for (i = 0; i < NCHEXT; i++) {
+    if ((ext = chext(i)) != NULL) {
+      if ((fp = fopen(chname(&rk, ext), "rb")) == NULL) {
+        return (0);
+      }
+      fclose(fp);
+    }
+  }
+  for (i = 0; i < NCHEXT; i++) {
+    if ((ext = chext(i)) != NULL) {
+      strcpy(fn, chname(&rk, ext));
+      afilex(q, ext);
+      if (!chcopy(fn, afntmp)) {
+        return (0);
+      }
+    }
+  }
+  return (1);
+}
+
+/*)Function	VOID	chsave(q)
+ *
+ *		char *	q		output file specification
+ *
+ *	The function chsave() saves the manifest and the
+ *	output files of the assembly in the cache.  The files
+ *	read by the assembly are listed in the manifest with
+ *	their content hashes.  Nothing is saved when a file
+ *	was not read on all the passes reading the first
+ *	source file, the file set then depends on the pass
+ *	and the manifest could miss a changed file.
+ *
+ *	local variables:
+ *		depf *	dp		pointer to a depf structure
+ *		FILE *	fp		manifest file handle
+ *		struct chash	rk	result key
+ *		struct chash	h	file hash
+ *		char	hb[]		file hash string
+ *		char	fn[]		output file name
+ *		char	tmp[]		temporary manifest name
+ *		char *	ext		output file extension
+ *		int	i		loop counter
+ *
+ *	global variables:
+ *		char	afntmp[]	afilex() constructed filespec
+ *		struct chash	chk	key of the assembly
+ *		depf *	depp		pointer to the first depf
+ *		FILE *	hfp		relocation helper file handle
+ *		FILE *	lfp		list output file handle
+ *		FILE *	ofp		relocation output file handle
+ *		FILE *	tfp		symbol table output file handle
+ *
+ *	functions called:
+ *		VOID	afilex()	asmain.c
+ *		VOID	chbgn()		ascache.c
+ *		int	chcopy()	ascache.c
+ *		char *	chext()		ascache.c
+ *		int	chfile()	ascache.c
+ *		char *	chname()	ascache.c
+ *		VOID	chstr()		ascache.c
+ *		int	fclose()	c_library
+ *		int	fflush()	c_library
+ *		FILE *	fopen()		c_library
+ *		int	fprintf()	c_library
+ *		int	remove()	c_library
+ *		int	rename()	c_library
+ *		int	sprintf()	c_library
+ *		char *	strcpy()	c_library
+ *
+ *	side effects:
+ *		Files are created in the cache directory.
+ */
+
+VOID chsave(q)
+char *q;
+{
+  struct depf *dp;
+  FILE *fp;
+  struct chash rk, h;
+  char hb[20];
+  char fn[FILSPC + FILSPC + 32];
+  char tmp[FILSPC + FILSPC + 40];
+  char *ext;
+  int i;
+
+  /*
+   * The same files must be read on each pass
+   */
+  for (dp = depp; dp != NULL; dp = dp->f_fp) {
+    if (dp->f_pass != depp->f_pass) {
+      return;
+    }
+  }
+
+  /*
+   * The outputs are saved first so that a
+   * manifest always names complete results.
+   */
+  if (lfp != NULL)
+    fflush(lfp);
+  if (hfp != NULL)
+    fflush(hfp);
+  if (ofp != NULL)
+    fflush(ofp);
+  if (tfp != NULL)
+    fflush(tfp);
+  rk = chk;
+  for (dp = depp; dp != NULL; dp = dp->f_fp) {
+    chbgn(&h);
+    if (!chfile(dp->f_fn, &h)) {
+      return;
+    }
+    sprintf(hb, "%08lX%08lX", (unsigned long)h.h_a, (unsigned long)h.h_b);
+    chstr(&rk, hb, 16);
+  }
+  for (i = 0; i < NCHEXT; i++) {
+    if ((ext = chext(i)) != NULL) {
+      afilex(q, ext);
+      strcpy(fn, afntmp);
+      if (!chcopy(fn, chname(&rk, ext))) {
+        return;
+      }
+    }
+  }
+
+  sprintf(tmp, "%s.tmp", chname(&chk, "m"));
+  if ((fp = fopen(tmp, "w")) == NULL) {
+    return;
+  }
+  for (dp = depp; dp != NULL; dp = dp->f_fp) {
+    chbgn(&h);
+    chfile(dp->f_fn, &h);
+    fprintf(fp, "%08lX%08lX %s\n", (unsigned long)h.h_a, (unsigned long)h.h_b,
+            dp->f_fn);
+  }
+  if (fclose(fp) == 0) {
+    remove(chname(&chk, "m"));
+    if (rename(tmp, chfn) == 0) {
+      return;
+    }
+  }
+  remove(tmp);
+}
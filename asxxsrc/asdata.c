@@ -168,6 +168,10 @@ struct memlnk *pmcrmem; /*	First Macro Memory Allocation Structure
                          */
 struct memlnk *mcrmem;  /*	Macro Memory Allocation Structure
                          */
+struct astat astat[NSTPASS]; /*	-tt statistics for each pass
+                              */
+struct astat *stp = &astat[0]; /*	pointer to the current pass statistics
+                                */
 int asmblk;             /*	new data blocks allocated
                          */
 int mcrblk;             /*	new data blocks allocated
@@ -241,8 +245,13 @@ int iflag;              /*	-i, insert command line string flag
                          */
 int jflag;              /*	-j, enable NoICE Debug Symbols
                          */
+int kflag;              /*	-k, use the assembly result cache
+                         */
 int lflag;              /*	-l, generate listing flag
                          */
+int mflag;              /*	-m, generate dependency file flag
+                         *	-mm, dependency file only
+                         */
 int oflag;              /*	-o, generate relocatable output flag
                          */
 int pflag;              /*	-p, disable listing pagination
@@ -252,6 +261,8 @@ int rflag;              /*	-r, line numbers output to .lst to .rst hint file
 int sflag;              /*	-s, generate symbol table flag
                          */
 int tflag;              /*	-t, output diagnostic parameters from assembler
+                         *	-tt, and timing statistics
+                         *	-ttt, as JSON
                          */
 int uflag;              /*	-u, disable .list/.nlist processing flag
                          */
@@ -281,6 +292,13 @@ int as_msb;             /*	current MSB byte select
                          *	2 == third byte
                          *	3 == fourth byte
                          */
+int rxmode;             /*	merge mode of the relaxable jumps
+                         *	0 == jumps are not relaxable
+                         */
+int rxdef;              /*	merge mode of the relaxable jumps
+                         *	of the module
+                         *	0 == no branch relaxation
+                         */
 a_uint laddr;           /*	address of current assembler line
                          *	or value of .if argument
                          */
@@ -319,6 +337,9 @@ int *cpt;               /*	pointer to assembler relocation type
 int cbt[NCODE];         /*	array of assembler relocation types
                          *	describing the data in cb[]
                          */
+a_uint ibnb;            /*	.incbin bytes output by this line
+                         *	which are not saved in cb[]
+                         */
 int opcycles;           /*	opcode execution cycles
                          */
 char tb[NTITL];         /*	Title string buffer
@@ -358,6 +379,61 @@ char module[NCPS + 2]; /*	module name string
  */
 struct mne *mnehash[NHASH];
 
+/*
+ *	The skip structure records a run of source file
+ *	lines in a false conditional block.
+ *
+ *	struct	skip
+ *	{
+ *		struct	skip *k_kp;	link to next skip
+ *		char *	k_fn;		source file name
+ *		long	k_bgn;		file offset of the first line
+ *		long	k_end;		file offset following the run
+ *		int	k_lines;	number of lines in the run
+ *	};
+ */
+struct skip *skphash[NHASH];
+
+/*
+ *	The incg structure records the include
+ *	guard symbol of an .include file.
+ *
+ *	struct	incg
+ *	{
+ *		struct	incg *g_gp;	link to next include guard
+ *		char *	g_fn;		include file name
+ *		char *	g_id;		guard symbol or NULL
+ *		int	g_lvl;		maximum .if nesting in the file
+ *	};
+ */
+struct incg *incgp;
+
+/*
+ *	The depf structure records a file read
+ *	by the assembler for the -m option.
+ *
+ *	struct	depf
+ *	{
+ *		struct	depf *f_fp;	link to next dependency
+ *		char *	f_fn;		file name
+ *		int	f_pass;		passes reading the file
+ *	};
+ */
+struct depf *depp;
+
+/*
+ *	The rxj structure records the address
+ *	of a relaxable jump assembled on pass 1.
+ *
+ *	struct	rxj
+ *	{
+ *		struct	rxj *r_rp;	link to next jump
+ *		struct	area *r_ap;	area of the jump
+ *		a_uint	r_addr;		address of the jump
+ *	};
+ */
+struct rxj *rxjp;
+
 /*
  *	The sym structure is a linked list of symbols defined
  *	in the assembler source files.  The first symbol is "."
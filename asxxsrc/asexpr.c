@@ -47,6 +47,7 @@
  *		VOID	clrexpr()
  *		int	digit()
  *		VOID	expr()
+ *		int	exprlit()
  *		VOID	exprmasks()
  *		int	oprio()
  *		VOID	term()
@@ -78,12 +79,14 @@
  *		int	c		current assembler-source
  *					text character
  *		int	p		current operator priority
+ *		int	ph		previous statistics phase
  *		area *	ap		pointer to an area structure
  *		exp	re		internal expr structure
  *
  *	global variables:
  *		char	ctype[]		array of character types, one per
  *					ASCII character
+ *		struct astat *	stp	current pass statistics
  *
  *	functions called:
  *		VOID	abscheck()	asexpr.c
@@ -94,6 +97,8 @@
  *		int	oprio()		asexpr.c
  *		VOID	qerr()		assubr.c
  *		VOID	rerr()		assubr.c
+ *		int	rxspan()	asout.c
+ *		int	stphase()	asstat.c
  *		VOID	term()		asexpr.c
  *		VOID	unget()		aslex.c
  *
@@ -110,10 +115,14 @@ struct expr *esp;
 int n;
 {
   a_uint ae, ar;
-  int c, p;
+  int c, p, ph;
   struct area *ap;
   struct expr re;
 
+  if (n == 0) {
+    stp->st_cnt[ST_EXPR] += 1;
+  }
+  ph = stphase(PH_EXPR);
   term(esp);
   while (ctype[c = getnb()] & BINOP) {
     /*
@@ -161,6 +170,12 @@ int n;
       if ((ap = re.e_base.e_ap) != NULL) {
         if (esp->e_base.e_ap == ap) {
           esp->e_base.e_ap = NULL;
+          /*
+           * A relaxable jump between
+           * the addresses may shrink
+           */
+          if (rxspan(ap, ae, ar))
+            rerr();
         } else {
           rerr();
         }
@@ -229,6 +244,7 @@ int n;
     esp->e_addr = rngchk(ae);
   }
   unget(c);
+  stphase(ph);
 }
 
 /*)Function	a_uint	absexpr()
@@ -530,6 +546,122 @@ struct expr *esp;
   qerr();
 }
 
+/*)Function	int	exprlit(vp)
+ *
+ *		a_uint *	vp	pointer to the returned value
+ *
+ *	The function exprlit() evaluates the next operand
+ *	if it is a single numeric constant, in the current
+ *	radix or with a 0b, 0o, 0q, 0d, 0h or 0x prefix,
+ *	followed by a ',', a ';' or the end of the line.
+ *	The value is returned in *vp, ip is left at the
+ *	terminator, and 1 is returned.  Otherwise ip is
+ *	unchanged and 0 is returned so that the operand
+ *	can be evaluated by expr().
+ *
+ *	exprlit() lets the data directives evaluate tables
+ *	of constants without the recursion of expr().
+ *
+ *	local variables:
+ *		char *	p		scan pointer
+ *		int	c		current character
+ *		int	r		current radix
+ *		int	v		digit value
+ *		a_uint	n		value of the constant
+ *
+ *	global variables:
+ *		char	ctype[]		array of character types, one per
+ *					ASCII character
+ *		char *	ip		pointer into the assembler-source
+ *					text line
+ *		int	radix		current number conversion radix
+ *		struct astat *	stp	current pass statistics
+ *
+ *	functions called:
+ *		a_uint	rngchk()	asexpr.c
+ *
+ *	side effects:
+ *		The constant is skipped.
+ */
+
+int exprlit(vp)
+a_uint *vp;
+{
+  char *p;
+  int c, r, v;
+  a_uint n;
+
+  p = ip;
+  while (*p == ' ' || *p == '\t')
+    p++;
+  if (!(ctype[*p & 0x007F] & DIGIT))
+    return (0);
+
+  r = radix;
+  if ((*p == '0') && (*(p + 1) != 0)) {
+    switch (*(p + 1) & 0x007F) {
+    case 'b':
+    case 'B':
+      r = 2;
+      p += 2;
+      break;
+    case 'o':
+    case 'O':
+    case 'q':
+    case 'Q':
+      r = 8;
+      p += 2;
+      break;
+    case 'd':
+    case 'D':
+      r = 10;
+      p += 2;
+      break;
+    case 'h':
+    case 'H':
+    case 'x':
+    case 'X':
+      r = 16;
+      p += 2;
+      break;
+    default:
+      break;
+    }
+  }
+
+  n = 0;
+  for (;;) {
+    c = *p & 0x007F;
+    if (r == 16) {
+      if (!(ctype[c] & RAD16))
+        break;
+      if (c >= 'A' && c <= 'F') {
+        v = c - 'A' + 10;
+      } else if (c >= 'a' && c <= 'f') {
+        v = c - 'a' + 10;
+      } else {
+        v = c - '0';
+      }
+    } else if ((ctype[c] & DIGIT) && (c - '0' < r)) {
+      v = c - '0';
+    } else {
+      break;
+    }
+    n = r * n + v;
+    p++;
+  }
+
+  while (*p == ' ' || *p == '\t')
+    p++;
+  if ((*p != 0) && (*p != ',') && (*p != ';'))
+    return (0);
+
+  stp->st_cnt[ST_EXPR] += 1;
+  ip = p;
+  *vp = rngchk(n);
+  return (1);
+}
+
 /*)Function	int	digit(c, r)
  *
  *		int	c		digit character
@@ -45,6 +45,8 @@
  *		int	nxtline()
  *		int	replace()
  *		VOID	scanline()
+ *		int	skpchk()
+ *		int	skpline()
  *		VOID	unget()
  *
  *	aslex.c contains no local/static variables
@@ -81,6 +83,7 @@
  *					type of character being processed.
  *					This index is the character
  *					being processed.
+ *		struct astat *	stp	current pass statistics
  *
  *	called functions:
  *		int	get()		aslex.c
@@ -105,6 +108,7 @@ char *id;
     if ((ctype[c] & LETTER) == 0)
       qerr();
   }
+  stp->st_cnt[ST_TOKENS] += 1;
   p = id;
   do {
     if (p < &id[NCPS - 1])
@@ -510,16 +514,21 @@ int flag;
  *	include file) until the end of the include file is found.
  *	The input text line is transferred into the global string
  *	ib[], converted to a NULL terminated string, and is used for
- *	for internal processing by the assembler.  The string
- *	is then copied into the global string ic[] which is used
- *	during the listing process.  The function scanline()
+ *	for internal processing by the assembler.  The listing
+ *	pointer il is set to ib[], replace() copies the line into
+ *	the global string ic[] for the listing only when a pass 2
+ *	.define substitution is made.  The function scanline()
  *	is called to process any .define substitutions
  *	in the assembler-source text line.  The function
  *	nxtline() returns a (1) after succesfully reading
  *	a line,	or a (0) if all files have been read.
  *
+ *	In a false conditional block the function skpline()
+ *	passes over the source file lines which can not change
+ *	the state of the assembler before the next line is read.
+ *
  *	local variables:
- *		none
+ *		int	ph		previous statistics phase
  *
  *	global variables:
  *		char	afn[]		afile() constructed filespec
@@ -529,13 +538,16 @@ int flag;
  *structure asmf *	asmp		pointer to first assembler file
  *structure asmf *	asmq 		pointer to a queued macro structure char
  *ib[]		string buffer containing assembler-source text line for
- *processing char	ic[]		string buffer containing
- *					assembler-source text line for listing
+ *processing char *	il		pointer to the assembler-source
+ *					text line to be listed
  *		int	asmline		source file line number
+ *		int	flevel		IF-ELSE-ENDIF flag
  *		int	incline		include file line number
  *		int	lnlist		LIST-NLIST state
  *		int	mcrline		macro line number
+ *		int	rxmode		merge mode of the relaxable jumps
  *		int	srcline		current source line number
+ *		struct astat *	stp	current pass statistics
  *
  *	called functions:
  *		VOID	chopcrlf()	aslex.c
@@ -543,11 +555,14 @@ int flag;
  *		char *	fgets()		c_library
  *		char *	fgetm()		asmcro.c
  *		VOID	scanline()	aslex.c
+ *		int	skpline()	aslex.c
+ *		int	stphase()	asstat.c
  *		char *	strcpy()	c_library
  *
  *	side effects:
  *		include file will be closed at detection of end of file.
- *		the next sequential source file may be selected.
+ *		the next sequential source file may be selected,
+ *		a .relax of the previous file is then ended.
  *		The current file specification afn[] and the path
  *		length afp may be changed.
  *		The respective line counter will be updated.
@@ -637,6 +652,7 @@ int flag;
 
 int nxtline() {
   struct asmf *asmt;
+  int ph;
 
 loop:
   if (asmc == NULL)
@@ -669,6 +685,9 @@ loop:
     break;
 
   case T_ASM:
+    if (flevel && asmline) {
+      asmline += skpline(asmc);
+    }
     if (fgets(ib, NINPUT, asmc->fp) == NULL) {
       if ((asmc->flevel != flevel) || (asmc->tlevel != tlevel)) {
         err('i');
@@ -682,6 +701,7 @@ loop:
       if (asmc != NULL) {
         asmline = 0;
       }
+      rxmode = 0;
       if ((lnlist & LIST_PAG) || (uflag == 1)) {
         lop = NLPP;
       }
@@ -696,6 +716,9 @@ loop:
     break;
 
   case T_INCL:
+    if (flevel && incline) {
+      incline += skpline(asmc);
+    }
     if (fgets(ib, NINPUT, asmc->fp) == NULL) {
       fclose(asmc->fp);
       incfil -= 1;
@@ -747,7 +770,9 @@ loop:
     break;
 
   case T_MACRO:
+    ph = stphase(PH_MACRO);
     if (fgetm(ib, NINPUT, asmc->fp) == NULL) {
+      stphase(ph);
       mcrfil -= 1;
       srcline = asmc->line;
       flevel = asmc->flevel;
@@ -768,6 +793,8 @@ loop:
       }
       goto loop;
     } else {
+      stphase(ph);
+      stp->st_cnt[ST_MLINES] += 1;
       if (mcrline++ == 0) {
         ;
       }
@@ -781,11 +808,180 @@ loop:
     break;
   }
   chopcrlf(ib);
-  strcpy(ic, ib);
+  /*
+   * The listing line ic[] is only made
+   * when replace() changes ib[].
+   */
+  il = ib;
+  stp->st_cnt[ST_LINES] += 1;
+  ph = stphase(PH_SCAN);
   scanline();
+  stphase(ph);
   return (1);
 }
 
+/*)Function	int	skpline(ap)
+ *
+ *		asmf *	ap		pointer to the source file structure
+ *
+ *	The function skpline() passes over a run of source file
+ *	lines in a false conditional block.  Such a line is only
+ *	assembled when skpchk() finds that it can change the
+ *	state of the assembler, all other lines are skipped
+ *	without being scanned.  The extent of each run is saved
+ *	in the skphash[] table, keyed by the file name and the
+ *	offset of its first line, so that later passes seek over
+ *	the whole run.  The runs are not skipped on pass 2 when
+ *	a listing is being made.
+ *
+ *	skpline() returns the number of lines skipped, the file
+ *	is positioned at the next line to be assembled.
+ *
+ *	local variables:
+ *		skip *	kp		pointer to a skip structure
+ *		long	bgn		offset of the first line
+ *		long	end		offset following the run
+ *		int	h		hash index
+ *		int	n		number of lines skipped
+ *
+ *	global variables:
+ *		int	ftflevel	IIFF-IIFT-IIFTF flag
+ *		char	ib[]		assembler-source text line
+ *		FILE *	lfp		list output file handle
+ *		int	pass		assembler pass number
+ *		skip *	skphash[]	array of skip lists
+ *		struct astat *	stp	current pass statistics
+ *
+ *	called functions:
+ *		char *	fgets()		c_library
+ *		int	fseek()		c_library
+ *		long	ftell()		c_library
+ *		VOID *	new()		assym.c
+ *		int	skpchk()	aslex.c
+ *		int	strcmp()	c_library
+ *		char *	strsto()	assym.c
+ *
+ *	side effects:
+ *		The file position is advanced and a
+ *		new skip structure may be created.
+ */
+
+int skpline(ap)
+struct asmf *ap;
+{
+  struct skip *kp;
+  long bgn, end;
+  int h, n;
+
+  if (ftflevel || ((pass == 2) && (lfp != NULL))) {
+    return (0);
+  }
+  if ((bgn = ftell(ap->fp)) < 0) {
+    return (0);
+  }
+  h = (int)(bgn & HMASK);
+  for (kp = skphash[h]; kp != NULL; kp = kp->k_kp) {
+    if ((kp->k_bgn == bgn) && (strcmp(kp->k_fn, ap->afn) == 0)) {
+      if (fseek(ap->fp, kp->k_end, SEEK_SET) != 0) {
+        fseek(ap->fp, bgn, SEEK_SET);
+        return (0);
+      }
+      stp->st_cnt[ST_LINES] += kp->k_lines;
+      return (kp->k_lines);
+    }
+  }
+
+  n = 0;
+  end = bgn;
+  while (fgets(ib, NINPUT, ap->fp) != NULL) {
+    if (skpchk(ib)) {
+      break;
+    }
+    end = ftell(ap->fp);
+    n += 1;
+  }
+  fseek(ap->fp, end, SEEK_SET);
+  if (n != 0) {
+    kp = (struct skip *)new (sizeof(struct skip));
+    kp->k_kp = skphash[h];
+    kp->k_fn = strsto(ap->afn);
+    kp->k_bgn = bgn;
+    kp->k_end = end;
+    kp->k_lines = n;
+    skphash[h] = kp;
+    stp->st_cnt[ST_LINES] += n;
+  }
+  return (n);
+}
+
+/*)Function	int	skpchk(str)
+ *
+ *		char *	str		assembler-source text line
+ *
+ *	The function skpchk() checks if a line in a false
+ *	conditional block must be assembled.  Only a line
+ *	beginning with a .if, .iif, .else, .endif, .list,
+ *	.nlist, or .page directive can change the state of
+ *	the assembler.  A ;! comment line is passed to the
+ *	output file on pass 1 and must also be read.
+ *
+ *	skpchk() returns a (1) if the line must be assembled
+ *	else a (0).
+ *
+ *	local variables:
+ *		mne *	mp		pointer to a mne structure
+ *		char *	p		pointer into str
+ *		char	id[]		directive name
+ *		int	i		characters in id[]
+ *
+ *	global variables:
+ *		char	ctype[]		array of character types
+ *		int	oflag		-o, generate relocatable output flag
+ *
+ *	called functions:
+ *		mne *	mlookup()	assym.c
+ *
+ *	side effects:
+ *		none
+ */
+
+int skpchk(str)
+char *str;
+{
+  struct mne *mp;
+  char *p;
+  char id[NCPS];
+  int i;
+
+  if (oflag && (str[0] == ';') && (str[1] == '!')) {
+    return (1);
+  }
+  p = str;
+  while ((*p == ' ') || (*p == '\t')) {
+    p++;
+  }
+  if (*p != '.') {
+    return (0);
+  }
+  i = 0;
+  while ((ctype[*p & 0x7F] & (LETTER | DIGIT)) && (i < NCPS - 1)) {
+    id[i++] = *p++;
+  }
+  id[i] = 0;
+  if ((mp = mlookup(id)) == NULL) {
+    return (0);
+  }
+  switch (mp->m_type) {
+  case S_CONDITIONAL:
+  case S_LISTING:
+  case S_PAGE:
+    return (1);
+  default:
+    break;
+  }
+  return (0);
+}
+
 /*)Function	VOID	scanline()
  *
  *	The function scanline() scans the assembler-source text line
@@ -885,7 +1081,9 @@ VOID scanline() {
  *
  *	If the -bb option was specified and a listing file is open then
  *	the current assembler-source text line is listed before the
- *	substitution is made.
+ *	substitution is made.  Without a -b option the first pass 2
+ *	substitution in a line saves the unsubstituted line in ic[]
+ *	and points il to it for the listing.
  *
  *	local variables:
  *		char *	p		pointer to beginning of id
@@ -902,6 +1100,9 @@ VOID scanline() {
  *					The index is the character
  *					being processed.
  *		char	ib[]		assembler-source text line
+ *		char	ic[]		assembler-source text line for listing
+ *		char *	il		pointer to the assembler-source
+ *					text line to be listed
  *		char *	ip		pointer into the assembler-source text
  *line FILE *	lfp		list output file handle int	line
  *current assembler source line number int	lmode		listing mode int
@@ -935,6 +1136,7 @@ char *id;
   /*
    * Check for .define substitution
    */
+  stp->st_cnt[ST_DLKUP] += 1;
   dp = defp;
   while (dp) {
     if (dp->d_dflag && symeq(id, dp->d_id, zflag)) {
@@ -974,6 +1176,13 @@ char *id;
       if ((strlen(ib) - strlen(id) + strlen(dp->d_define)) > (NINPUT * 2 - 1)) {
         return (1);
       }
+      /*
+       * Save the unsubstituted line for the listing
+       */
+      if ((bflag == 0) && (il != ic) && (pass == 2) && (lfp != NULL)) {
+        strcpy(ic, ib);
+        il = ic;
+      }
       /*
        * Beginning of Substitutable string
        */
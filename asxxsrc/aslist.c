@@ -41,11 +41,23 @@
  *		VOID	list()
  *		VOID	list1()
  *		VOID	list2()
+ *		VOID	listhbin()
  *		VOID	listhlr()
+ *		VOID	lstinit()
+ *		char *	lstnum()
+ *		VOID	lstout()
+ *		VOID	lstpad()
+ *		char *	lstsrc()
  *		VOID	slew()
  *		VOID	lstsym()
  *
- *	The module aslist.c contains no local/static variables
+ *	The module aslist.c contains the following local variables:
+ *		struct lstfmt lstcol[][] listing column / width table
+ *		int	lstrdx[]	listing radix table
+ *		char	lb[]		listing line buffer
+ *		char *	lbp		pointer into lb[]
+ *		char	lbyt[][]	data byte digit table
+ *		int	lbytx		radix index of lbyt[]
  */
 
 /*)Function	VOID	list()
@@ -58,8 +70,7 @@
  *	local variables:
  *		int	a		beginning character position for option
  *		int	b		number of character positions for option
- *		char *	frmt		format string
- *		int	i		for loop index
+ *		lstfmt * lf		pointer to column / width table entry
  *		int	hlr_lst		listed parameters for current line
  *		int	listing		LIST-NLIST state for current line
  *		int	n		maximum number of bytes listed per line
@@ -86,6 +97,8 @@
  *		a_uint	laddr		address of current assembler line,
  *				 	equate, or value of .if argument
  *		FILE *	lfp		list output file handle
+ *		char	lb[]		listing line buffer
+ *		char *	lbp		pointer into lb[]
  *		int	line		current assembler source line number
  *		int	lmode		listing mode
  *		int	lnlist		LIST-NLIST state
@@ -95,10 +108,14 @@
  *		int	xflag		-x, listing radix flag
  *
  *	functions called:
- *		int	fprintf()	c_library
  *		VOID	list1()		aslist.c
+ *		VOID	listhbin()	aslist.c
  *		VOID	listhlr()	aslist.c
- *		int	putc()		c_library
+ *		VOID	lstinit()	aslist.c
+ *		char *	lstnum()	aslist.c
+ *		VOID	lstout()	aslist.c
+ *		VOID	lstpad()	aslist.c
+ *		char *	lstsrc()	aslist.c
  *		VOID	slew()		asslist.c
  *
  *	side effects:
@@ -178,9 +195,9 @@ ee DDDDDDDDDD ddd ddd ddd ddd [nn]LLLLL *********	DECIMAL(32)
 /*
  *	The listing of the current assembler line is determined
  *	by the enabled listing parameters, lnlist, and the current
- *	listing mode, lmode.  The line is output to the listing
- *	file on the fly, ie not bufferred.  Therefor the sequence
- *	of the generated output is all important.  The following
+ *	listing mode, lmode.  The line is built in the listing
+ *	line buffer lb[] and written when complete.  Therefor the
+ *	sequence of the generated output is all important.  The following
  *	table is organized as lmode versus lnlist parameters
  *	ordered by location in the output listing line.
  *
@@ -200,13 +217,57 @@ ee DDDDDDDDDD ddd ddd ddd ddd [nn]LLLLL *********	DECIMAL(32)
  *
  */
 
+/*
+ *	The listing line builder assembles each listing line
+ *	into the buffer lb[] and writes the completed line to
+ *	the listing file with a single fwrite().  Column positions
+ *	and field widths for each radix (xflag) and address size
+ *	(a_bytes) are selected from the table lstcol[][] and the
+ *	listed data bytes are copied from the digit table lbyt[]
+ *	which is built by lstinit() for the current radix.
+ */
+
+/*
+ * Column / Width Table
+ *	indexed by [xflag][a_bytes - 2]
+ */
+static struct lstfmt {
+  int loc_a, loc_b;        /* LIST_LOC column / width */
+  int bin_a, bin_b, bin_n; /* LIST_BIN column / width / bytes per line */
+  int eqt_a, eqt_b;        /* LIST_EQT column / width */
+} lstcol[3][3] = {
+    {/* HEX */
+     {3, 4, 7, 3, 6, 21, 4},
+     {6, 6, 12, 3, 7, 27, 6},
+     {4, 8, 12, 3, 7, 25, 8}},
+    {/* OCTAL */
+     {3, 6, 9, 4, 4, 19, 6},
+     {5, 8, 13, 4, 5, 25, 8},
+     {2, 11, 13, 4, 5, 22, 11}},
+    {/* DECIMAL */
+     {4, 5, 9, 4, 4, 20, 5},
+     {5, 8, 13, 4, 5, 25, 8},
+     {3, 10, 13, 4, 5, 23, 10}}};
+
+/*
+ * Radix Table
+ *	indexed by [xflag]
+ */
+static int lstrdx[3] = {16, 8, 10};
+
+static char lb[NINPUT * 2 + 64]; /* listing line buffer */
+static char *lbp;                /* pointer into lb[] */
+static char lbyt[256][4];        /* data byte digit table */
+static int lbytx = -1;           /* radix index of lbyt[] */
+
 VOID list() {
-  char *frmt, *wp;
+  struct lstfmt *lf;
+  char *wp;
   int *wpt;
   int n, nb, nl;
   int listing, paging;
   int hlr_lst;
-  int a, b, i, op;
+  int a, b, op;
 
   /*
    * Get Correct Line Number
@@ -228,11 +289,6 @@ VOID list() {
     }
   }
 
-  /*
-   * Paging Control
-   */
-  paging = !pflag && ((lnlist & LIST_PAG) || (uflag == 1)) ? 1 : 0;
-
   /*
    * ALIST/BLIST Output Processing
    */
@@ -244,23 +300,10 @@ VOID list() {
   }
 
   /*
-   * Check NO-LIST Conditions
+   * Check NO-LIST Conditions and Listing Nothing
    */
-  if ((lfp == NULL) || (lmode == NLIST)) {
-    if ((cp - cb) || (rflag > 1)) {
-      listhlr(HLR_NLST, lmode, (int)(cp - cb));
-    }
-    return;
-  }
-
-  /*
-   * Check Listing Nothing
-   */
-  if (listing == LIST_NONE) {
-    if ((cp - cb) || (rflag > 1)) {
-      listhlr(HLR_NLST, lmode, (int)(cp - cb));
-    }
-    return;
+  if ((lfp == NULL) || (lmode == NLIST) || (listing == LIST_NONE)) {
+    goto nolist;
   }
 
   /*
@@ -295,23 +338,21 @@ VOID list() {
             /* Priority 3
              * Default - Listing inhibited
              */
-            listing = LIST_NONE;
-            if ((cp - cb) || (rflag > 1)) {
-              listhlr(HLR_NLST, lmode, (int)(cp - cb));
-            }
-            return;
+            goto nolist;
           }
       }
       break;
 
     default:
-      if ((cp - cb) || (rflag > 1)) {
-        listhlr(HLR_NLST, lmode, (int)(cp - cb));
-      }
-      return;
+      goto nolist;
     }
   }
 
+  /*
+   * Paging Control
+   */
+  paging = !pflag && ((lnlist & LIST_PAG) || (uflag == 1)) ? 1 : 0;
+
   /*
    * Move to next line.
    */
@@ -320,6 +361,10 @@ VOID list() {
   /*
    * Initialize parameters
    */
+  lstinit();
+  lf = &lstcol[(xflag >= 0 && xflag <= 2) ? xflag : 0]
+              [(a_bytes >= 2 && a_bytes <= 4) ? (a_bytes - 2) : 0];
+  lbp = lb;
   hlr_lst = LIST_NONE;
   op = 0;
   n = nb = nl = (int)(cp - cb);
@@ -342,7 +387,8 @@ VOID list() {
         hlr_lst |= LIST_ERR;
         while (ep < &eb[NERR])
           *ep++ = ' ';
-        fprintf(lfp, "%.2s", eb);
+        *lbp++ = eb[0];
+        *lbp++ = eb[1];
         op = 2;
         break;
       }
@@ -362,139 +408,11 @@ VOID list() {
     case BLIST:
     case CLIST:
       hlr_lst |= LIST_LOC;
-      switch (xflag) {
-      default:
-      case 0: /* HEX */
-#ifdef LONGINT
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 3;
-          b = 4;
-          frmt = "%04lX";
-          break;
-        case 3:
-          a = 6;
-          b = 6;
-          frmt = "%06lX";
-          break;
-        case 4:
-          a = 4;
-          b = 8;
-          frmt = "%08lX";
-          break;
-        }
-#else
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 3;
-          b = 4;
-          frmt = "%04X";
-          break;
-        case 3:
-          a = 6;
-          b = 6;
-          frmt = "%06X";
-          break;
-        case 4:
-          a = 4;
-          b = 8;
-          frmt = "%08X";
-          break;
-        }
-#endif
-        break;
-
-      case 1: /* OCTAL */
-#ifdef LONGINT
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 3;
-          b = 6;
-          frmt = "%06lo";
-          break;
-        case 3:
-          a = 5;
-          b = 8;
-          frmt = "%08lo";
-          break;
-        case 4:
-          a = 2;
-          b = 11;
-          frmt = "%011lo";
-          break;
-        }
-#else
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 3;
-          b = 6;
-          frmt = "%06o";
-          break;
-        case 3:
-          a = 5;
-          b = 8;
-          frmt = "%08o";
-          break;
-        case 4:
-          a = 2;
-          b = 11;
-          frmt = "%011o";
-          break;
-        }
-#endif
-        break;
-
-      case 2: /* DECIMAL */
-#ifdef LONGINT
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 4;
-          b = 5;
-          frmt = "%05lu";
-          break;
-        case 3:
-          a = 5;
-          b = 8;
-          frmt = "%08lu";
-          break;
-        case 4:
-          a = 3;
-          b = 10;
-          frmt = "%010lu";
-          break;
-        }
-#else
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 4;
-          b = 5;
-          frmt = "%05u";
-          break;
-        case 3:
-          a = 5;
-          b = 8;
-          frmt = "%08u";
-          break;
-        case 4:
-          a = 3;
-          b = 10;
-          frmt = "%010u";
-          break;
-        }
-#endif
-        break;
-      }
-      for (i = 0; i < (a - op); i++) {
-        fprintf(lfp, " ");
-      }
+      a = lf->loc_a;
+      b = lf->loc_b;
+      lstpad(a - op);
       op = a;
-      fprintf(lfp, frmt, laddr & a_mask);
+      lbp = lstnum(lbp, laddr & a_mask, lstrdx[lbytx], b, '0');
       op += b;
     }
   }
@@ -513,62 +431,10 @@ VOID list() {
         break;
       case CLIST:
         hlr_lst |= LIST_BIN;
-        switch (xflag) {
-        default:
-        case 0: /* HEX */
-          switch (a_bytes) {
-          default:
-          case 2:
-            a = 7;
-            b = 3;
-            n = 6;
-            break;
-          case 3:
-          case 4:
-            a = 12;
-            b = 3;
-            n = 7;
-            break;
-          }
-          break;
-
-        case 1: /* OCTAL */
-          switch (a_bytes) {
-          default:
-          case 2:
-            a = 9;
-            b = 4;
-            n = 4;
-            break;
-          case 3:
-          case 4:
-            a = 13;
-            b = 4;
-            n = 5;
-            break;
-          }
-          break;
-
-        case 2: /* DECIMAL */
-          switch (a_bytes) {
-          default:
-          case 2:
-            a = 9;
-            b = 4;
-            n = 4;
-            break;
-          case 3:
-          case 4:
-            a = 13;
-            b = 4;
-            n = 5;
-            break;
-          }
-          break;
-        }
-        for (i = 0; i < (a - op); i++) {
-          fprintf(lfp, " ");
-        }
+        a = lf->bin_a;
+        b = lf->bin_b;
+        n = lf->bin_n;
+        lstpad(a - op);
         op = a;
 
         /*
@@ -599,139 +465,11 @@ VOID list() {
       break;
     case ELIST:
       hlr_lst |= LIST_EQT;
-      switch (xflag) {
-      default:
-      case 0: /* HEX */
-#ifdef LONGINT
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 21;
-          b = 4;
-          frmt = "%04lX";
-          break;
-        case 3:
-          a = 27;
-          b = 6;
-          frmt = "%06lX";
-          break;
-        case 4:
-          a = 25;
-          b = 8;
-          frmt = "%08lX";
-          break;
-        }
-#else
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 21;
-          b = 4;
-          frmt = "%04X";
-          break;
-        case 3:
-          a = 27;
-          b = 6;
-          frmt = "%06X";
-          break;
-        case 4:
-          a = 25;
-          b = 8;
-          frmt = "%08X";
-          break;
-        }
-#endif
-        break;
-
-      case 1: /* OCTAL */
-#ifdef LONGINT
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 19;
-          b = 6;
-          frmt = "%06lo";
-          break;
-        case 3:
-          a = 25;
-          b = 8;
-          frmt = "%08lo";
-          break;
-        case 4:
-          a = 22;
-          b = 11;
-          frmt = "%011lo";
-          break;
-        }
-#else
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 19;
-          b = 6;
-          frmt = "%06o";
-          break;
-        case 3:
-          a = 25;
-          b = 8;
-          frmt = "%08o";
-          break;
-        case 4:
-          a = 22;
-          b = 11;
-          frmt = "%011o";
-          break;
-        }
-#endif
-        break;
-
-      case 2: /* DECIMAL */
-#ifdef LONGINT
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 20;
-          b = 5;
-          frmt = "%05lu";
-          break;
-        case 3:
-          a = 25;
-          b = 8;
-          frmt = "%08lu";
-          break;
-        case 4:
-          a = 23;
-          b = 10;
-          frmt = "%%010lu";
-          break;
-        }
-#else
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 20;
-          b = 5;
-          frmt = "%05u";
-          break;
-        case 3:
-          a = 25;
-          b = 8;
-          frmt = "%08u";
-          break;
-        case 4:
-          a = 23;
-          b = 10;
-          frmt = "%010u";
-          break;
-        }
-#endif
-        break;
-      }
-      for (i = 0; i < (a - op); i++) {
-        fprintf(lfp, " ");
-      }
+      a = lf->eqt_a;
+      b = lf->eqt_b;
+      lstpad(a - op);
       op = a;
-      fprintf(lfp, frmt, laddr & a_mask);
+      lbp = lstnum(lbp, laddr & a_mask, lstrdx[lbytx], b, '0');
       op += b;
       break;
     }
@@ -751,23 +489,18 @@ VOID list() {
         break;
       case CLIST:
         hlr_lst |= LIST_CYC;
-        switch (a_bytes) {
-        default:
-        case 2:
-          a = 22;
-          b = 4;
-          break;
-        case 3:
-        case 4:
-          a = 30;
-          b = 4;
-          break;
-        }
-        for (i = 0; i < (a - op); i++) {
-          fprintf(lfp, " ");
-        }
+        a = (a_bytes > 2) ? 30 : 22;
+        b = 4;
+        lstpad(a - op);
         op = a;
-        fprintf(lfp, "%c%2d%c", CYCNT_BGN, opcycles, CYCNT_END);
+        *lbp++ = CYCNT_BGN;
+        if (opcycles < 0) {
+          *lbp++ = '-';
+          lbp = lstnum(lbp, (a_uint)(-opcycles), 10, 1, ' ');
+        } else {
+          lbp = lstnum(lbp, (a_uint)opcycles, 10, 2, ' ');
+        }
+        *lbp++ = CYCNT_END;
         op += b;
         break;
       }
@@ -787,23 +520,11 @@ VOID list() {
     case ELIST:
     case CLIST:
       hlr_lst |= LIST_LIN;
-      switch (a_bytes) {
-      default:
-      case 2:
-        a = 26;
-        b = 5;
-        break;
-      case 3:
-      case 4:
-        a = 34;
-        b = 5;
-        break;
-      }
-      for (i = 0; i < (a - op); i++) {
-        fprintf(lfp, " ");
-      }
+      a = (a_bytes > 2) ? 34 : 26;
+      b = 5;
+      lstpad(a - op);
       op = a;
-      fprintf(lfp, "%5u", line);
+      lbp = lstnum(lbp, (a_uint)((unsigned int)line), 10, b, ' ');
       op += b;
       break;
     }
@@ -822,20 +543,9 @@ VOID list() {
     case ELIST:
     case CLIST:
       hlr_lst |= LIST_SRC;
-      switch (a_bytes) {
-      default:
-      case 2:
-        a = 32;
-        break;
-      case 3:
-      case 4:
-        a = 40;
-        break;
-      }
-      for (i = 0; i < (a - op); i++) {
-        fprintf(lfp, " ");
-      }
-      fprintf(lfp, "%s", il);
+      a = (a_bytes > 2) ? 40 : 32;
+      lstpad(a - op);
+      lbp = lstsrc(lbp, il);
       break;
     }
   }
@@ -844,18 +554,16 @@ VOID list() {
    * Check Listing Nothing
    */
   if (hlr_lst == LIST_NONE) {
-    if ((cp - cb) || (rflag > 1)) {
-      listhlr(HLR_NLST, lmode, (int)(cp - cb));
-    }
-    return;
+    goto nolist;
   }
 
   /*
    * Listing output line complete
    */
-  fprintf(lfp, "\n");
+  *lbp++ = '\n';
+  lstout();
   if (!(hlr_lst & LIST_BIN)) {
-    listhlr(hlr_lst, lmode, (int)(cp - cb));
+    listhbin(hlr_lst, lmode, (a_uint)(cp - cb) + ibnb);
     return;
   } else if (nb == 0) {
     listhlr(hlr_lst, lmode, 0);
@@ -872,63 +580,217 @@ VOID list() {
    * Subsequent lines of output if more data.
    */
   if (listing & LIST_BIN) {
-    /*
-     * Format
-     */
-    switch (xflag) {
-    default:
-    case 0: /* HEX */
-      switch (a_bytes) {
-      default:
-      case 2:
-        frmt = "%7s";
-        break;
-      case 3:
-      case 4:
-        frmt = "%12s";
-        break;
-      }
-      break;
-
-    case 1: /* OCTAL */
-      switch (a_bytes) {
-      default:
-      case 2:
-        frmt = "%9s";
-        break;
-      case 3:
-      case 4:
-        frmt = "%13s";
-        break;
-      }
-      break;
-
-    case 2: /* DECIMAL */
-      switch (a_bytes) {
-      default:
-      case 2:
-        frmt = "%9s";
-        break;
-      case 3:
-      case 4:
-        frmt = "%13s";
-        break;
-      }
-      break;
-    }
-
     while (nb > 0) {
       nl = (nb > n) ? n : nb;
       slew(lfp, paging);
-      fprintf(lfp, frmt, "");
+      lbp = lb;
+      lstpad(lf->bin_a);
       list1(wp, wpt, nl);
-      putc('\n', lfp);
+      *lbp++ = '\n';
+      lstout();
       listhlr(LIST_BIN, lmode, nl);
       nb -= nl;
       wp += nl;
       wpt += nl;
     }
   }
+  return;
+
+  /*
+   * Not listed, only the hint is required
+   * when there is code or -rr is specified.
+   */
+nolist:
+  if ((cp - cb) || ibnb || (rflag > 1)) {
+    listhbin(HLR_NLST, lmode, (a_uint)(cp - cb) + ibnb);
+  }
+}
+
+/*)Function	VOID	lstinit()
+ *
+ *	The function lstinit() builds the data byte digit
+ *	table lbyt[] for the current listing radix.  Each
+ *	entry is the 2 (HEX) or 3 (OCTAL / DECIMAL) digit
+ *	representation of the byte value terminated by a
+ *	null.  The table is only rebuilt when xflag changes.
+ *
+ *	local variables:
+ *		int	i		loop counter
+ *		int	r		radix
+ *		int	w		digits per byte
+ *
+ *	global variables:
+ *		char	lbyt[][]	data byte digit table
+ *		int	lbytx		radix index of lbyt[]
+ *		int	xflag		-x, listing radix flag
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		lbyt[] and lbytx may be updated.
+ */
+
+VOID lstinit() {
+  int i, j, r, v, w, x;
+
+  x = (xflag >= 0 && xflag <= 2) ? xflag : 0;
+  if (lbytx == x) {
+    return;
+  }
+  r = lstrdx[x];
+  w = (r == 16) ? 2 : 3;
+  for (i = 0; i < 256; i++) {
+    v = i;
+    for (j = w - 1; j >= 0; j--) {
+      lbyt[i][j] = "0123456789ABCDEF"[v % r];
+      v /= r;
+    }
+    lbyt[i][w] = 0;
+  }
+  lbytx = x;
+}
+
+/*)Function	VOID	lstpad(n)
+ *
+ *		int	n		number of spaces
+ *
+ *	The function lstpad() appends n spaces
+ *	to the listing line buffer.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		char *	lbp		pointer into lb[]
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		lbp is advanced.
+ */
+
+VOID lstpad(n)
+int n;
+{
+  while (n-- > 0) {
+    *lbp++ = ' ';
+  }
+}
+
+/*)Function	char *	lstnum(p, v, r, w, c)
+ *
+ *		char *	p		pointer into output buffer
+ *		a_uint	v		value to convert
+ *		int	r		radix 8, 10, or 16
+ *		int	w		minimum field width
+ *		int	c		fill character
+ *
+ *	The function lstnum() places the value v in radix r,
+ *	right justified in a field of at least w characters
+ *	and filled with the character c, into the buffer at p.
+ *	The result matches the printf() formats %0wX, %0wo,
+ *	%0wu (c == '0') and %wu (c == ' ').
+ *
+ *	lstnum() returns a pointer past the last character.
+ *
+ *	local variables:
+ *		char	tmp[]		reversed digit string
+ *		int	i		digit count
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+char *lstnum(p, v, r, w, c)
+char *p;
+a_uint v;
+int r, w, c;
+{
+  char tmp[40];
+  int i;
+
+  i = 0;
+  do {
+    tmp[i++] = "0123456789ABCDEF"[v % r];
+    v /= r;
+  } while (v != 0);
+  while (w-- > i) {
+    *p++ = c;
+  }
+  while (i > 0) {
+    *p++ = tmp[--i];
+  }
+  return (p);
+}
+
+/*)Function	char *	lstsrc(p, str)
+ *
+ *		char *	p		pointer into output buffer
+ *		char *	str		string to copy
+ *
+ *	The function lstsrc() copies the string str, including
+ *	its terminating null, into the buffer at p.
+ *
+ *	lstsrc() returns a pointer to the copied null.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+char *lstsrc(p, str)
+char *p;
+char *str;
+{
+  while ((*p = *str++) != 0) {
+    p++;
+  }
+  return (p);
+}
+
+/*)Function	VOID	lstout()
+ *
+ *	The function lstout() writes the contents
+ *	of the listing line buffer to the listing file.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		char	lb[]		listing line buffer
+ *		char *	lbp		pointer into lb[]
+ *		FILE *	lfp		list output file handle
+ *		struct astat *	stp	current pass statistics
+ *
+ *	functions called:
+ *		int	fwrite()	c_library
+ *
+ *	side effects:
+ *		Listing line written to the listing file.
+ */
+
+VOID lstout() {
+  if (lbp != lb) {
+    stp->st_cnt[ST_LST] += 1;
+    fwrite(lb, 1, (size_t)(lbp - lb), lfp);
+    lbp = lb;
+  }
 }
 
 /*)Function	VOID	list1(wp, wpt, n)
@@ -937,19 +799,23 @@ VOID list() {
  *		int *	wp		pointer to data bytes
  *		int *	wpt		pointer to data byte mode
  *
+ *	The function list1() appends the relocation flag
+ *	and the digits from lbyt[] for each data byte to
+ *	the listing line buffer.
+ *
  *	local variables:
  *		int	i		loop counter
- *		char *	frmt		data format
+ *		char *	p		pointer into lbyt[]
  *
  *	global variables:
- *		int	xflag		-x, listing radix flag
+ *		char	lbyt[][]	data byte digit table
+ *		char *	lbp		pointer into lb[]
  *
  *	functions called:
  *		VOID	list2()		asslist.c
- *		int	fprintf()	c_library
  *
  *	side effects:
- *		Data formatted and output to listing.
+ *		Data formatted and added to the listing line.
  */
 
 VOID list1(wp, wpt, nb)
@@ -957,29 +823,17 @@ char *wp;
 int *wpt, nb;
 {
   int i;
-  char *frmt;
-
-  switch (xflag) {
-  default:
-  case 0: /* HEX */
-    frmt = "%02X";
-    break;
-
-  case 1: /* OCTAL */
-    frmt = "%03o";
-    break;
-
-  case 2: /* DECIMAL */
-    frmt = "%03u";
-    break;
-  }
+  char *p;
 
   /*
    * Output bytes.
    */
   for (i = 0; i < nb; ++i) {
     list2(*wpt++);
-    fprintf(lfp, frmt, (*wp++) & 0377);
+    p = lbyt[(*wp++) & 0377];
+    while (*p) {
+      *lbp++ = *p++;
+    }
   }
 }
 
@@ -995,12 +849,13 @@ int *wpt, nb;
  *
  *	global variables:
  *		int	fflag		-f(f), relocations flagged flag
+ *		char *	lbp		pointer into lb[]
  *
  *	functions called:
- *		int	putc()		c_library
+ *		none
  *
  *	side effects:
- *		Relocation flag output to listing file.
+ *		Relocation flag added to the listing line.
  */
 
 VOID list2(t)
@@ -1055,7 +910,7 @@ int t;
   /*
    * Output the selected mode.
    */
-  putc(c, lfp);
+  *lbp++ = c;
 }
 
 /*)Function	VOID	listhlr(hlr_lst, hlr_mode, nb)
@@ -1068,7 +923,10 @@ int t;
  *	the hints for this assembled line.
  *
  *	local variables:
- *		char *	frmt		output format specifier
+ *		char	hb[]		hint line buffer
+ *		char *	p		pointer into hb[]
+ *		int	r		radix
+ *		int	w		digits per value
  *
  *	global variables:
  *		char *	eqt_area	.area of equate evaluation
@@ -1077,7 +935,9 @@ int t;
  *		int	xflag		listing radix flag
  *
  *	functions called:
- *		int	fprintf()		c_library
+ *		int	fwrite()	c_library
+ *		char *	lstnum()	aslist.c
+ *		char *	lstsrc()	aslist.c
  *
  *	side effects:
  *		A line of hint parameters
@@ -1089,36 +949,79 @@ int hlr_lst;
 int hlr_mode;
 int hlr_nb;
 {
-  char *frmt;
+  char hb[NCPS + 64];
+  char *p;
+  int r, w;
 
   if (hfp == NULL)
     return;
 
+  p = hb;
   if (rflag) {
-    fprintf(hfp, "  %5u", line);
+    *p++ = ' ';
+    *p++ = ' ';
+    p = lstnum(p, (a_uint)((unsigned int)line), 10, 5, ' ');
   }
 
-  switch (xflag) {
-  default:
-  case 0: /* HEX */
-    frmt = " %02X %02X %02X";
-    break;
-
-  case 1: /* OCTAL */
-    frmt = " %03o %03o %03o";
-    break;
-
-  case 2: /* DECIMAL */
-    frmt = " %03u %03u %03u";
-    break;
-  }
-  fprintf(hfp, frmt, hlr_lst, hlr_mode, hlr_nb);
+  r = lstrdx[(xflag >= 0 && xflag <= 2) ? xflag : 0];
+  w = (r == 16) ? 2 : 3;
+  *p++ = ' ';
+  p = lstnum(p, (a_uint)((unsigned int)hlr_lst), r, w, '0');
+  *p++ = ' ';
+  p = lstnum(p, (a_uint)((unsigned int)hlr_mode), r, w, '0');
+  *p++ = ' ';
+  p = lstnum(p, (a_uint)((unsigned int)hlr_nb), r, w, '0');
   if (lmode == ELIST) {
     if (eqt_area != NULL) {
-      fprintf(hfp, " %s", eqt_area);
+      *p++ = ' ';
+      p = lstsrc(p, eqt_area);
     }
   }
-  fprintf(hfp, "\n");
+  *p++ = '\n';
+  fwrite(hb, 1, (size_t)(p - hb), hfp);
+}
+
+/*)Function	VOID	listhbin(hlr_lst, hlr_mode, nb)
+ *
+ *		int	hlr_lst		output listing flags for src line
+ *		int	hlr_mode	output listing mode for src line
+ *		a_uint	hlr_nb		number of bytes output for this line
+ *
+ *	The function listhbin() outputs the hints for an
+ *	assembled line which may have more bytes than a
+ *	single hint can count (.incbin).  The first hint
+ *	describes the listed line, the remaining bytes are
+ *	described by unlisted hints of at most HLR_NBMAX
+ *	bytes so the linker skips them when updating the
+ *	listing.
+ *
+ *	local variables:
+ *		int	n		bytes in this hint
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID	listhlr()	aslist.c
+ *
+ *	side effects:
+ *		Lines of hint parameters
+ *		are written to the HLR file.
+ */
+
+VOID listhbin(hlr_lst, hlr_mode, hlr_nb)
+int hlr_lst;
+int hlr_mode;
+a_uint hlr_nb;
+{
+  int n;
+
+  n = (hlr_nb > HLR_NBMAX) ? HLR_NBMAX : (int)hlr_nb;
+  listhlr(hlr_lst, hlr_mode, n);
+  for (hlr_nb -= n; hlr_nb != 0; hlr_nb -= n) {
+    n = (hlr_nb > HLR_NBMAX) ? HLR_NBMAX : (int)hlr_nb;
+    listhlr(HLR_NLST, NLIST, n);
+  }
 }
 
 /*)Function	VOID	slew(fp, flag)
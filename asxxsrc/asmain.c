@@ -36,6 +36,11 @@
 
 #include "asxxxx.h"
 
+#include <sys/stat.h>
+#if ASMMAP
+#include <sys/mman.h>
+#endif
+
 /*)Module	asmain.c
  *
  *	The module asmain.c includes the command argument parser,
@@ -47,7 +52,13 @@
  *		VOID	asexit(n)
  *		VOID	asmbl()
  *		FILE *	afile(fn, ft, md)
+ *		VOID	depadd(fn)
+ *		VOID	deplst(fp, tgt)
+ *		VOID	depput(fp, str)
  *		int	fndidx(str)
+ *		VOID	incbin(fn, offset, length)
+ *		VOID	incgrd(fn, fp)
+ *		int	incskp(fn)
  *		int	intsiz()
  *		VOID	newdot(nap)
  *		VOID	phase(ap, a)
@@ -78,8 +89,14 @@
  *	and all-global (-a) variable definitions, and dumping the
  *	REL file header information.
  *
+ *	With -m the files read by the assembly are written to
+ *	a dependency file (D).  With -mm the passes are run with
+ *	the listing, relocation and symbol outputs disabled and
+ *	only the dependency file is created.
+ *
  *	local variables:
  *		char *	p		pointer to argument string
+ *		char *	t		dependency file target
  *		int	c		character from argument string
  *		int	i		argument loop counter
  *		area *	ap		pointer to area structure
@@ -117,9 +134,11 @@
  *		int	lflag		-l, generate listing flag
  *		int	line		current assembler source
  *					line number
+ *		int	kflag		-k, use the assembly result cache
  *		int	lnlist		current LIST-NLIST state
  *		int	lop		current line number on page
  *		int	maxinc		maximum include file nesting counter
+ *		int	mflag		-m, generate dependency file flag
  *		int	oflag		-o, generate relocatable output flag
  *		int	page		current page number
  *		int	pflag		enable listing pagination
@@ -144,8 +163,14 @@
  *
  *	called functions:
  *		FILE *	afile()		asmain.c
+ *		VOID	afilex()	asmain.c
  *		VOID	allglob()	assym.c
  *		VOID	asexit()	asmain.c
+ *		VOID	chkey()		ascache.c
+ *		int	chload()	ascache.c
+ *		VOID	chsave()	ascache.c
+ *		VOID	depadd()	asmain.c
+ *		VOID	deplst()	asmain.c
  *		VOID	diag()		assubr.c
  *		VOID	err()		assubr.c
  *		VOID	exprmasks()	asexpr.c
@@ -164,6 +189,10 @@
  *		int	rewind()	c_library
  *		int	setjmp()	c_library
  *		char *	strcpy()	c_library
+ *		char *	strsto()	assym.c
+ *		VOID	stinit()	asstat.c
+ *		VOID	stpass()	asstat.c
+ *		int	stphase()	asstat.c
  *		VOID	symglob()	assym.c
  *		VOID	syminit()	assym.c
  *		time_t	time()		c_library
@@ -171,17 +200,18 @@
  *
  *	side effects:
  *		Completion of main() completes the assembly process.
- *		REL, LST, HLR, and/or SYM files may be generated.
+ *		REL, LST, HLR, SYM, and/or D files may be generated.
  */
 
 int main(argc, argv)
 int argc;
 char *argv[];
 {
-  char *p, *q;
+  char *p, *q, *t;
   int c, i;
   struct area *ap;
   struct def *dp;
+  FILE *fp;
 
   if (intsiz() < 4) {
     fprintf(stderr,
@@ -218,6 +248,8 @@ char *argv[];
          *   -l   Create list   file/outfile[.lst]
          *   -o   Create object file/outfile[.rel]
          *   -s   Create symbol file/outfile[.sym]
+         *   -m   Create dependency file/outfile[.d]
+         *   -mm  Create only the dependency file
          */
         case 'l':
         case 'L':
@@ -234,6 +266,11 @@ char *argv[];
           ++sflag;
           break;
 
+        case 'm':
+        case 'M':
+          ++mflag;
+          break;
+
         /*
          * Listing:
          *   -d   Decimal listing
@@ -297,6 +334,7 @@ char *argv[];
          * Assembly Processing Options:",
          *   -i   Insert assembler line before input file(s)
          *   -v   Enable out of range signed / unsigned errors
+         *   -k   Use the assembly result cache
          */
         case 'i':
         case 'I':
@@ -311,6 +349,11 @@ char *argv[];
           ++vflag;
           break;
 
+        case 'k':
+        case 'K':
+          ++kflag;
+          break;
+
         /*
          * Symbol Options:
          *   -a   All user symbols made global
@@ -357,6 +400,8 @@ char *argv[];
          *   -r   list line numbers in .hst help file
          *   -rr  list line numbers of NON listed lines
          *   -t   show internal block allocations
+         *   -tt  also show timing and counter statistics
+         *   -ttt statistics as JSON
          */
         case 'r':
         case 'R':
@@ -425,6 +470,29 @@ char *argv[];
     }
     asexit(ER_WARNING);
   }
+  if (mflag > 1) {
+    /*
+     * Dependency Scan Only
+     */
+    lflag = 0;
+    oflag = 0;
+    sflag = 0;
+#if NOICE
+    jflag = 0;
+#endif
+#if SDCDB
+    yflag = 0;
+#endif
+  }
+  if (kflag) {
+    /*
+     * Restore The Outputs From The Cache
+     */
+    chkey(argc, argv);
+    if (chload(q)) {
+      asexit(ER_NONE);
+    }
+  }
   if (lflag)
     lfp = afile(q, "lst", 1);
   if (oflag)
@@ -435,20 +503,21 @@ char *argv[];
     tfp = afile(q, "sym", 1);
   exprmasks(2);
   syminit();
+  stinit();
   curtim = time(NULL);
-  if (bflag != 0) {
-    il = ib;
-  } else {
-    il = ic;
-  }
+  il = ib;
   for (pass = 0; pass < 3; ++pass) {
+    stpass(pass);
     aserr = 0;
     if (gflag && pass == 1)
       symglob();
     if (aflag && pass == 1)
       allglob();
-    if (oflag && pass == 2)
+    if (oflag && pass == 2) {
+      stphase(PH_OUTPUT);
       outgsd();
+      stphase(PH_OTHER);
+    }
     dp = defp;
     while (dp) {
       dp->d_dflag = 0;
@@ -474,6 +543,8 @@ char *argv[];
     while (asmc) {
       if (asmc->fp)
         rewind(asmc->fp);
+      if (asmc->objtyp == T_ASM)
+        depadd(asmc->afn);
       asmc = asmc->next;
     }
     asmc = asmo;
@@ -485,6 +556,7 @@ char *argv[];
     }
     fuzz = 0;
     as_msb = 1;
+    rxmode = 0;
     p_mask = DEFAULT_PMASK;
     dot.s_addr = 0;
     dot.s_area = &dca;
@@ -493,9 +565,12 @@ char *argv[];
     symp = &dot;
     mcrinit();
     minit();
+    stphase(PH_INPUT);
     while ((i = nxtline()) != 0) {
+      stphase(PH_PARSE);
       cp = cb;
       cpt = cbt;
+      ibnb = 0;
       ep = eb;
       ip = ib;
 
@@ -510,17 +585,22 @@ char *argv[];
       if (setjmp(jump_env) == 0)
         asmbl();
       if (pass == 2) {
+        stphase(PH_OUTPUT);
         diag();
         list();
       }
+      stphase(PH_INPUT);
     }
+    stphase(PH_OTHER);
     newdot(dot.s_area); /* Flush area info */
   }
+  stpass(NSTPASS - 1);
   if (flevel || tlevel) {
     err('i');
     fprintf(stderr, "?ASxxxx-Error-<i> at end of assembly\n");
     fprintf(stderr, "              %s\n", geterr('i'));
   }
+  stphase(PH_OUTPUT);
   if (oflag)
     outchk(HUGE, HUGE); /* Flush */
   if (sflag) {
@@ -528,6 +608,17 @@ char *argv[];
   } else if (lflag) {
     lstsym(lfp);
   }
+  if (mflag) {
+    afilex(q, "rel");
+    t = strsto(afntmp);
+    fp = afile(q, "d", 1);
+    deplst(fp, t);
+    fclose(fp);
+  }
+  if (kflag && !aserr) {
+    chsave(q);
+  }
+  stphase(PH_OTHER);
   asexit(aserr ? ER_ERROR : ER_NONE);
   return (0);
 }
@@ -620,6 +711,7 @@ int i;
  *		int	fclose()	c_library
  *		VOID	exit()		c_library
  *		VOID	old()		assym.c
+ *		VOID	stlist()	asstat.c
  *
  *	side effects:
  *		All files closed. Program terminates.
@@ -661,6 +753,11 @@ int i;
     fprintf(stderr, "mcrblk(1K Byte Allocations)   = %3d\n", mcrblk);
     fprintf(stderr, "\n");
   }
+  if (tflag > 2) {
+    stlist(stdout);
+  } else if (tflag > 1) {
+    stlist(stderr);
+  }
 
   exit(i);
 }
@@ -692,6 +789,7 @@ int i;
  *		char	fn[]		filename string
  *		char *	p		pointer into a string
  *		int	d		temporary value
+ *		int	ph		previous timing phase
  *		int	uf		area options
  *		int	con_ovr		concatenate / overlay flag
  *		int	rel_abs		relocatable / absolute flag
@@ -706,6 +804,8 @@ int i;
  *		int	flags		temporary flag
  *		FILE *	fp		include file handle
  *		int	m_type		mnemonic type
+ *		a_uint	dv[]		constant data values
+ *		int	nv		number of data values
  *
  *	global variables:
  *		area *	areap		pointer to an area structure
@@ -749,6 +849,7 @@ int i;
  *		VOID	equate()	asmain.c
  *		VOID	err()		assubr.c
  *		VOID	expr()		asexpr.c
+ *		int	exprlit()	asexpr.c
  *		int	fndidx()	asmain.c
  *		FILE *	fopen()		c_library
  *		int	get()		aslex.c
@@ -757,6 +858,10 @@ int i;
  *		int	getnb()		aslex.c
  *		VOID	getst()		aslex.c
  *		VOID	getxstr()	asmcro.c
+ *		VOID	depadd()	asmain.c
+ *		VOID	incbin()	asmain.c
+ *		VOID	incgrd()	asmain.c
+ *		int	incskp()	asmain.c
  *		sym *	lookup()	assym.c
  *		VOID	machine()	___mch.c
  *		int	macro()		asmcro.c
@@ -768,6 +873,7 @@ int i;
  *		VOID	newdot()	asmain.c
  *		VOID	outall()	asout.c
  *		VOID	outab()		asout.c
+ *		VOID	outablk()	asout.c
  *		VOID	outchk()	asout.c
  *		VOID	outrb()		asout.c
  *		VOID	outrw()		asout.c
@@ -797,12 +903,14 @@ VOID asmbl() {
   char opt[NCPS];
   char fn[FILSPC + FILSPC];
   char *p;
-  int d, nc, uf;
+  int d, nc, ph, uf;
   int con_ovr, rel_abs, npg_pag, csg_dsg;
   a_uint base, size, map, n, v;
   int cnt, flags;
   FILE *fp;
   int m_type;
+  a_uint dv[NDATA];
+  int nv;
 
   laddr = dot.s_addr;
   lmode = SLIST;
@@ -1611,6 +1719,25 @@ loop:
     break;
 
   case S_INCL:
+    if (mp->m_valu == O_INCBIN) {
+      /*
+       * .incbin "file"[,offset[,length]]
+       */
+      strncpy(fn, afn, afp);
+      getdstr(fn + afp, FILSPC + FILSPC - afp);
+      p = (fndidx(fn + afp) != 0) ? fn + afp : fn;
+      base = 0;
+      size = ~((a_uint)0);
+      if (comma(0)) {
+        base = absexpr();
+        if (comma(0)) {
+          size = absexpr();
+        }
+      }
+      incbin(p, base, size);
+      lmode = CLIST;
+      break;
+    }
     lmode = SLIST;
     if (++incfil > MAXINC) {
       --incfil;
@@ -1639,6 +1766,13 @@ loop:
     } else {
       afilex(fn, "");
     }
+    /*
+     * Skip a guarded file whose guard is defined
+     */
+    if (incskp(afntmp)) {
+      --incfil;
+      break;
+    }
     /*
      * Open File
      */
@@ -1646,6 +1780,9 @@ loop:
       --incfil;
       err('i');
     } else {
+      incgrd(afntmp, fp);
+      depadd(afntmp);
+      stp->st_cnt[ST_INCL] += 1;
       asmi = (struct asmf *)new (sizeof(struct asmf));
       asmi->next = asmc;
       asmi->objtyp = T_INCL;
@@ -1963,7 +2100,23 @@ loop:
      * Use full relocation mode
      */
     if ((n == 1) || (n == size)) {
+      nv = 0;
       do {
+        /*
+         * Constants are collected and
+         * output as a block by outablk()
+         */
+        if (exprlit(&dv[nv])) {
+          if (++nv == NDATA) {
+            outablk((int)size, dv, nv);
+            nv = 0;
+          }
+          continue;
+        }
+        if (nv != 0) {
+          outablk((int)size, dv, nv);
+          nv = 0;
+        }
         clrexpr(&e1);
         expr(&e1, 0);
         /*
@@ -1988,6 +2141,9 @@ loop:
           break;
         }
       } while (comma(0));
+      if (nv != 0) {
+        outablk((int)size, dv, nv);
+      }
     } else
       /*
        * Data size == 1
@@ -2395,7 +2551,10 @@ loop:
       macro(np);
       lmode = SLIST;
     } else {
+      ph = stphase(PH_MACH);
+      stp->st_cnt[ST_MACH] += 1;
       machine(mp);
+      stphase(ph);
     }
 
     /*
@@ -2433,7 +2592,9 @@ loop:
  *
  *	The function boundary() adds a boundary value required
  *	by the assembled code in the current area and determines
- *	the smallest common boundary of all boundaries.
+ *	the smallest common boundary of all boundaries.  A 'c'
+ *	error is reported when a relaxable jump of the area lies
+ *	before the boundary, the linker may shorten the jump.
  *
  *	boundary has no return value
  *
@@ -2451,6 +2612,7 @@ loop:
  *	functions called:
  *		VOID	err()		assubr.c
  *              char *	new()		assym.c
+ *		int	rxspan()	asout.c
  *
  *	side effects:
  *		A new boundary structure may be created
@@ -2468,6 +2630,14 @@ a_uint n;
 
   ap = dot.s_area;
 
+  /*
+   * A relaxable jump before the
+   * boundary may shrink
+   */
+  if (rxspan(ap, 0, dot.s_addr)) {
+    err('c');
+  }
+
 #ifdef LONGINT
   m = 0x00010000l; /* last 'l' is lower case L */
 #else
@@ -2637,6 +2807,570 @@ a_uint equtype;
   }
 }
 
+/*)Function	VOID	incbin(fn, offset, length)
+ *
+ *		char *	fn		binary file specification
+ *		a_uint	offset		offset of the first byte
+ *		a_uint	length		number of bytes, all ones
+ *					for the rest of the file
+ *
+ *	The function incbin() processes the .incbin directive.
+ *	On passes 0 and 1 the size of the file is taken from
+ *	stat() and only the location counter is advanced.  On
+ *	pass 2 the file is mapped into memory (or read in
+ *	blocks when it can not be mapped) and the bytes are
+ *	output as absolute data by outabin().  In an area of
+ *	2 to 4 byte words the bytes are packed into words like
+ *	the characters of .ascii.  The bytes are not kept
+ *	for the listing, only their count in ibnb so that
+ *	the listing hints let the linker skip them.
+ *
+ *	An 'i' error is reported if the file can not be read
+ *	or the offset or length is beyond the end of the file,
+ *	no data is then output.
+ *
+ *	local variables:
+ *		struct stat	st	file status
+ *		FILE *	fp		binary file handle
+ *		char	buf[]		read buffer
+ *		char *	mp		file mapping
+ *		char *	bp		pointer to the next bytes
+ *		a_uint	nb		number of bytes in bp
+ *		a_uint	a		starting location
+ *		a_uint	v		packed word
+ *		int	n		intrinsic size of the area
+ *		int	cnt		bytes in the packed word
+ *		int	i		loop counter
+ *
+ *	global variables:
+ *		char	cb[]		array of assembler output values
+ *		int	cbt[]		array of assembler relocation types
+ *		char *	cp		pointer to assembler output array cb[]
+ *		int *	cpt		pointer to assembler relocation type
+ *		sym	dot		defined as sym[0]
+ *		int	hilo		byte order
+ *		a_uint	ibnb		.incbin bytes not saved in cb[]
+ *		int	pass		assembler pass number
+ *
+ *	functions called:
+ *		VOID	depadd()	asmain.c
+ *		VOID	err()		assubr.c
+ *		int	fclose()	c_library
+ *		FILE *	fopen()		c_library
+ *		size_t	fread()		c_library
+ *		int	fseek()		c_library
+ *		VOID *	mmap()		c_library
+ *		int	munmap()	c_library
+ *		VOID	outabin()	asout.c
+ *		VOID	outaxb()	asout.c
+ *		int	stat()		c_library
+ *
+ *	side effects:
+ *		The binary data is output and
+ *		the location counter advanced.
+ */
+
+VOID incbin(fn, offset, length)
+char *fn;
+a_uint offset;
+a_uint length;
+{
+  struct stat st;
+  FILE *fp;
+  char buf[4096];
+  char *mp, *bp;
+  a_uint nb, v, a;
+  int n, cnt, i;
+
+  if (stat(fn, &st) != 0) {
+    err('i');
+    return;
+  }
+  depadd(fn);
+  if (offset > (a_uint)st.st_size) {
+    err('i');
+    return;
+  }
+  if (length > (a_uint)st.st_size - offset) {
+    if (length != ~((a_uint)0)) {
+      err('i');
+      return;
+    }
+    length = (a_uint)st.st_size - offset;
+  }
+  if (length == 0) {
+    return;
+  }
+
+  n = 1 + ((dot.s_area->a_flag) & A_BYTES);
+  if (pass != 2) {
+    dot.s_addr += (length / n) + (length % n ? 1 : 0);
+    dot.s_area->a_flag |= A_OUT;
+    return;
+  }
+
+  mp = NULL;
+  fp = NULL;
+#if ASMMAP
+  if ((fp = fopen(fn, "rb")) != NULL) {
+    mp = (char *)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                      fileno(fp), 0);
+    if (mp == (char *)MAP_FAILED) {
+      mp = NULL;
+    }
+  }
+#else
+  fp = fopen(fn, "rb");
+#endif
+  if ((fp == NULL) || ((mp == NULL) && fseek(fp, (long)offset, SEEK_SET))) {
+    if (fp != NULL) {
+      fclose(fp);
+    }
+    err('i');
+    return;
+  }
+
+  a = dot.s_addr;
+  cnt = 0;
+  v = 0;
+  while (length != 0) {
+    if (mp != NULL) {
+      bp = mp + offset;
+      nb = length;
+    } else {
+      bp = buf;
+      nb = (length < sizeof(buf)) ? length : sizeof(buf);
+      if (fread(buf, 1, (size_t)nb, fp) != (size_t)nb) {
+        err('i');
+        break;
+      }
+    }
+    length -= nb;
+    if (n == 1) {
+      outabin(bp, nb);
+      continue;
+    }
+    for (i = 0; i < (int)nb; i++) {
+      if ((int)hilo) {
+        cnt += 1;
+        v |= ((bp[i] & 0xFF) << 8 * (n - cnt));
+      } else {
+        v |= ((bp[i] & 0xFF) << 8 * cnt);
+        cnt += 1;
+      }
+      if (cnt == n) {
+        outaxb(n, v);
+        cnt = 0;
+        v = 0;
+      }
+    }
+  }
+  if (cnt != 0) {
+    outaxb(n, v);
+  }
+  cp = cb;
+  cpt = cbt;
+  ibnb = (dot.s_addr - a) * n;
+
+#if ASMMAP
+  if (mp != NULL) {
+    munmap(mp, (size_t)st.st_size);
+  }
+#endif
+  fclose(fp);
+}
+
+/*)Function	VOID	incgrd(fn, fp)
+ *
+ *		char *	fn		include file specification
+ *		FILE *	fp		include file handle
+ *
+ *	The function incgrd() finds the include guard of an
+ *	.include file the first time the file is opened.  The
+ *	first line of the file, other than blank and comment
+ *	lines, must be .ifndef (or .if ndef) and its matching
+ *	.endif the last.  The file is not guarded if the guard
+ *	block has a .else or an .iiff, .iift, or .iiftf at its
+ *	own level, or if the file has a .list, .nlist, .page or
+ *	;! line, as these are processed in a false block.
+ *	The file is rewound after the scan.
+ *
+ *	local variables:
+ *		incg *	gp		pointer to an incg structure
+ *		mne *	mp		pointer to a mne structure
+ *		char	buf[]		file text line
+ *		char	id[]		guard symbol
+ *		char	dir[]		directive name
+ *		char *	p		pointer into buf[]
+ *		int	i		characters in a name
+ *		int	lvl		current .if nesting
+ *		int	max		maximum .if nesting
+ *		int	state		0 before, 1 in, 2 after the
+ *					guard block, -1 not guarded
+ *
+ *	global variables:
+ *		char	ctype[]		array of character types
+ *		incg *	incgp		pointer to the first incg
+ *		int	oflag		-o, generate relocatable output flag
+ *
+ *	functions called:
+ *		char *	fgets()		c_library
+ *		mne *	mlookup()	assym.c
+ *		VOID *	new()		assym.c
+ *		VOID	rewind()	c_library
+ *		int	strcmp()	c_library
+ *		char *	strcpy()	c_library
+ *		char *	strsto()	assym.c
+ *
+ *	side effects:
+ *		A new incg structure may be created.
+ */
+
+VOID incgrd(fn, fp)
+char *fn;
+FILE *fp;
+{
+  struct incg *gp;
+  struct mne *mp;
+  char buf[NINPUT];
+  char id[NCPS];
+  char dir[NCPS];
+  char *p;
+  int i, lvl, max, state;
+
+  for (gp = incgp; gp != NULL; gp = gp->g_gp) {
+    if (strcmp(gp->g_fn, fn) == 0) {
+      return;
+    }
+  }
+
+  lvl = max = state = 0;
+  while ((state >= 0) && (fgets(buf, NINPUT, fp) != NULL)) {
+    p = buf;
+    while ((*p == ' ') || (*p == '\t')) {
+      p++;
+    }
+    if ((*p == ';') && oflag && (buf[0] == ';') && (buf[1] == '!')) {
+      state = -1;
+      break;
+    }
+    if ((*p == 0) || (*p == ';') || (*p == '\r') || (*p == '\n')) {
+      continue;
+    }
+    if (state == 2) {
+      state = -1;
+      break;
+    }
+    mp = NULL;
+    if (*p == '.') {
+      for (i = 0; (ctype[*p & 0x7F] & (LETTER | DIGIT)) && (i < NCPS - 1);) {
+        dir[i++] = *p++;
+      }
+      dir[i] = 0;
+      mp = mlookup(dir);
+    }
+    if (state == 0) {
+      /*
+       * .ifndef sym  or  .if ndef(,) sym
+       */
+      if ((mp != NULL) && (mp->m_type == S_CONDITIONAL) &&
+          (mp->m_valu == O_IF)) {
+        while ((*p == ' ') || (*p == '\t')) {
+          p++;
+        }
+        strcpy(dir, ".if");
+        for (i = 3; (ctype[*p & 0x7F] & (LETTER | DIGIT)) && (i < NCPS - 1);) {
+          dir[i++] = *p++;
+        }
+        dir[i] = 0;
+        mp = mlookup(dir);
+        while ((*p == ' ') || (*p == '\t')) {
+          p++;
+        }
+        if (*p == ',') {
+          p++;
+        }
+      }
+      if ((mp == NULL) || (mp->m_type != S_CONDITIONAL) ||
+          (mp->m_valu != O_IFNDEF)) {
+        state = -1;
+        break;
+      }
+      while ((*p == ' ') || (*p == '\t')) {
+        p++;
+      }
+      if (!(ctype[*p & 0x7F] & LETTER)) {
+        state = -1;
+        break;
+      }
+      for (i = 0; (ctype[*p & 0x7F] & (LETTER | DIGIT)) && (i < NCPS - 1);) {
+        id[i++] = *p++;
+      }
+      id[i] = 0;
+      lvl = max = 1;
+      state = 1;
+      continue;
+    }
+    if (mp == NULL) {
+      continue;
+    }
+    switch (mp->m_type) {
+    case S_LISTING:
+    case S_PAGE:
+      state = -1;
+      break;
+
+    case S_CONDITIONAL:
+      if (mp->m_valu < O_IFEND) {
+        if (++lvl > max) {
+          max = lvl;
+        }
+      } else if (mp->m_valu < O_IIFEND) {
+        switch (mp->m_valu) {
+        case O_IIFF:
+        case O_IIFT:
+        case O_IIFTF:
+          if (lvl == 1) {
+            state = -1;
+          }
+          break;
+        default:
+          break;
+        }
+      } else if (mp->m_valu == O_ELSE) {
+        if (lvl == 1) {
+          state = -1;
+        }
+      } else if (mp->m_valu == O_ENDIF) {
+        if (--lvl == 0) {
+          state = 2;
+        }
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+  rewind(fp);
+
+  gp = (struct incg *)new (sizeof(struct incg));
+  gp->g_gp = incgp;
+  gp->g_fn = strsto(fn);
+  gp->g_id = (state == 2) ? strsto(id) : NULL;
+  gp->g_lvl = max;
+  incgp = gp;
+}
+
+/*)Function	int	incskp(fn)
+ *
+ *		char *	fn		include file specification
+ *
+ *	The function incskp() checks if the .include of the
+ *	file fn can be skipped.  The file must have an include
+ *	guard (found by incgrd() when the file was first opened)
+ *	and the guard symbol must be defined, as .ifndef would
+ *	find it, so that the whole file would be assembled as a
+ *	false conditional block.  Files are not skipped on pass
+ *	2 when a listing is being made.
+ *
+ *	incskp() returns a (1) if the file is skipped else a (0).
+ *
+ *	local variables:
+ *		incg *	gp		pointer to an incg structure
+ *		def *	dp		pointer to a def structure
+ *		sym *	sp		pointer to a sym structure
+ *
+ *	global variables:
+ *		incg *	incgp		pointer to the first incg
+ *		FILE *	lfp		list output file handle
+ *		int	pass		assembler pass number
+ *		int	tlevel		current conditional level
+ *
+ *	functions called:
+ *		def *	dlookup()	assym.c
+ *		sym *	slookup()	assym.c
+ *		int	strcmp()	c_library
+ *
+ *	side effects:
+ *		none
+ */
+
+int incskp(fn)
+char *fn;
+{
+  struct incg *gp;
+  struct def *dp;
+  struct sym *sp;
+
+  if ((pass == 2) && (lfp != NULL)) {
+    return (0);
+  }
+  for (gp = incgp; gp != NULL; gp = gp->g_gp) {
+    if (strcmp(gp->g_fn, fn) == 0) {
+      break;
+    }
+  }
+  if ((gp == NULL) || (gp->g_id == NULL) || (tlevel + gp->g_lvl > MAXIF)) {
+    return (0);
+  }
+  if (((dp = dlookup(gp->g_id)) != NULL) && (dp->d_dflag != 0)) {
+    return (1);
+  }
+  if (((sp = slookup(gp->g_id)) != NULL) && (sp->s_type == S_USER)) {
+    return (1);
+  }
+  return (0);
+}
+
+/*)Function	VOID	depadd(fn)
+ *
+ *		char *	fn		file specification
+ *
+ *	The function depadd() adds a source, .include, or
+ *	.incbin file read on any pass to the list of files
+ *	written to the -m dependency file and hashed by the
+ *	-k result cache.  A file assembled only on a later
+ *	pass (as below an .ifdef of a symbol defined after
+ *	it) is also listed.  Each file is listed once, in
+ *	the order first read, with the passes reading it.
+ *
+ *	local variables:
+ *		depf *	fp		pointer to a depf structure
+ *		depf *	lp		last depf structure
+ *
+ *	global variables:
+ *		depf *	depp		pointer to the first depf
+ *		int	kflag		-k, use the assembly result cache
+ *		int	mflag		-m, generate dependency file flag
+ *		int	pass		assembler pass number
+ *
+ *	functions called:
+ *		VOID *	new()		assym.c
+ *		int	strcmp()	c_library
+ *		char *	strsto()	assym.c
+ *
+ *	side effects:
+ *		A new depf structure may be created.
+ */
+
+VOID depadd(fn)
+char *fn;
+{
+  struct depf *fp, *lp;
+
+  if (!mflag && !kflag) {
+    return;
+  }
+  lp = NULL;
+  for (fp = depp; fp != NULL; fp = fp->f_fp) {
+    if (strcmp(fp->f_fn, fn) == 0) {
+      fp->f_pass |= 1 << pass;
+      return;
+    }
+    lp = fp;
+  }
+  fp = (struct depf *)new (sizeof(struct depf));
+  fp->f_fp = NULL;
+  fp->f_fn = strsto(fn);
+  fp->f_pass = 1 << pass;
+  if (lp == NULL) {
+    depp = fp;
+  } else {
+    lp->f_fp = fp;
+  }
+}
+
+/*)Function	VOID	deplst(fp, tgt)
+ *
+ *		FILE *	fp		dependency file handle
+ *		char *	tgt		object file specification
+ *
+ *	The function deplst() writes the make rule for the
+ *	object file tgt listing all files read by the assembly.
+ *	An empty rule is also written for each file after the
+ *	first so make does not fail when a file is removed.
+ *
+ *	local variables:
+ *		depf *	dp		pointer to a depf structure
+ *
+ *	global variables:
+ *		depf *	depp		pointer to the first depf
+ *
+ *	functions called:
+ *		VOID	depput()	asmain.c
+ *		int	fprintf()	c_library
+ *
+ *	side effects:
+ *		The dependency file is written.
+ */
+
+VOID deplst(fp, tgt)
+FILE *fp;
+char *tgt;
+{
+  struct depf *dp;
+
+  depput(fp, tgt);
+  fprintf(fp, ":");
+  for (dp = depp; dp != NULL; dp = dp->f_fp) {
+    fprintf(fp, " \\\n  ");
+    depput(fp, dp->f_fn);
+  }
+  fprintf(fp, "\n");
+  if (depp != NULL) {
+    for (dp = depp->f_fp; dp != NULL; dp = dp->f_fp) {
+      fprintf(fp, "\n");
+      depput(fp, dp->f_fn);
+      fprintf(fp, ":\n");
+    }
+  }
+}
+
+/*)Function	VOID	depput(fp, str)
+ *
+ *		FILE *	fp		dependency file handle
+ *		char *	str		file specification
+ *
+ *	The function depput() writes a file specification
+ *	to the dependency file with the SPACE, '#', and '$'
+ *	characters escaped for make.
+ *
+ *	local variables:
+ *		int	c		character from str
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		int	putc()		c_library
+ *
+ *	side effects:
+ *		The file specification is written.
+ */
+
+VOID depput(fp, str)
+FILE *fp;
+char *str;
+{
+  int c;
+
+  while ((c = *str++) != 0) {
+    switch (c) {
+    case ' ':
+    case '#':
+      putc('\\', fp);
+      break;
+    case '$':
+      putc('$', fp);
+      break;
+    default:
+      break;
+    }
+    putc(c, fp);
+  }
+}
+
 /*)Function	FILE *	afile(fn, ft, wf)
  *
  *		char *	fn		file specification string
@@ -2931,6 +3665,8 @@ char *usetxt[] = {
     "  -l   Create list   file/outfile[.lst]",
     "  -o   Create object file/outfile[.rel]",
     "  -s   Create symbol file/outfile[.sym]",
+    "  -m   Create dependency file/outfile[.d]",
+    "  -mm  Create only the dependency file (no other output)",
     "Listing:",
     "  -d   Decimal listing",
     "  -q   Octal   listing",
@@ -2946,6 +3682,7 @@ char *usetxt[] = {
     "Assembly:",
     "  -i   Insert assembler line before input file(s)",
     "  -v   Enable out of range signed / unsigned errors",
+    "  -k   Use the assembly result cache (ASXCACHE or .asxcache)",
     "Symbols:",
     "  -a   All user symbols made global",
     "  -g   Undefined symbols made global",
@@ -2967,6 +3704,10 @@ char *usetxt[] = {
  *	prints the maximum include file and macro nesting
  *	during the assembly process and also prints the
  *	'hunk' allocations required during the assembly.
+ *	-tt adds the time spent in each phase of each pass
+ *	and the line, identifier, lookup, and output counts,
+ *	-ttt outputs these statistics as a JSON object
+ *	on stdout.
  */
 
 /*)Function	VOID	usage()
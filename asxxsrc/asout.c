@@ -253,6 +253,8 @@
  *		VOID	outa4b();
  *		VOID	outaxb();
  *		VOID	outatxb();
+ *		VOID	outablk();
+ *		VOID	outabin();
  *		VOID	outrb();
  *		VOID	outrw();
  *		VOID	outr3b();
@@ -270,6 +272,8 @@
  *		VOID	out_lxb();
  *		VOID	out_rw();
  *		VOID	out_txb();
+ *		VOID	rxadd();
+ *		int	rxspan();
  */
 
 /*)Function	VOID	outab(v)
@@ -417,6 +421,140 @@ a_uint v;
   }
 }
 
+/*)Function	VOID	outablk(i, vp, nv)
+ *
+ *		int	i		output byte count of each value
+ *		a_uint *	vp	pointer to the values
+ *		int	nv		number of values
+ *
+ *	The function outablk() processes nv absolute values of
+ *	i bytes each, the constants of a data directive.  The
+ *	result is the same as nv calls of outaxb().  The values
+ *	are listed in one loop and copied into the T Line
+ *	Buffer as many at a time as the buffer will hold.
+ *
+ *	local variables:
+ *		int	k		value index
+ *		int	m		last value index of a T line
+ *		int	n		address increment of a value
+ *
+ *	global variables:
+ *		char	cb[]		listing code buffer
+ *		char *	cp		pointer to listing code buffer
+ *		sym	dot		defined as sym[0]
+ *		int	oflag		-o, generate relocatable output flag
+ *		int	pass		assembler pass number
+ *		char	txt[]		assembled code/data array
+ *		char *	txtp		pointer to txt array
+ *
+ *	functions called:
+ *		VOID	outatxb()	asout.c
+ *		VOID	outchk()	asout.c
+ *		VOID	out_lxb()	asout.c
+ *
+ *	side effects:
+ *		The current assembly address is incremented
+ *		by nv values of i bytes.
+ */
+
+VOID outablk(i, vp, nv)
+int i;
+a_uint *vp;
+int nv;
+{
+  int k, m, n;
+
+  /*
+   * Program Counter increment
+   * based upon the area type.
+   */
+  n = 1 + ((dot.s_area->a_flag) & A_BYTES);
+  n = (i / n) + (i % n ? 1 : 0);
+
+  k = 0;
+  if (pass == 2) {
+    for (m = 0; (m < nv) && (cp < &cb[NCODE]); m++) {
+      out_lxb(i, vp[m], 0);
+    }
+    if (oflag) {
+      while (k < nv) {
+        outchk(i, 0);
+        /*
+         * Last value that fits the T line
+         */
+        m = k + (int)(&txt[NTXT] - 1 - txtp) / i - 1;
+        if (m >= nv) {
+          m = nv - 1;
+        }
+        for (; k <= m; k++) {
+          outatxb(i, vp[k]);
+          dot.s_addr += n;
+        }
+      }
+    }
+  }
+  dot.s_addr += (nv - k) * n;
+  /*
+   * Area has code
+   */
+  dot.s_area->a_flag |= A_OUT;
+}
+
+/*)Function	VOID	outabin(bp, nb)
+ *
+ *		char *	bp		pointer to the bytes
+ *		a_uint	nb		number of bytes
+ *
+ *	The function outabin() processes nb bytes of absolute
+ *	data from a binary file (.incbin).  The bytes are
+ *	copied into the T Line Buffer as many at a time as
+ *	the buffer will hold.  The bytes are not listed.
+ *
+ *	local variables:
+ *		int	m		bytes copied into the T line
+ *
+ *	global variables:
+ *		sym	dot		defined as sym[0]
+ *		int	oflag		-o, generate relocatable output flag
+ *		int	pass		assembler pass number
+ *		char	txt[]		assembled code/data array
+ *		char *	txtp		pointer to txt array
+ *
+ *	functions called:
+ *		VOID	outchk()	asout.c
+ *		VOID *	memcpy()	c_library
+ *
+ *	side effects:
+ *		The current assembly address is incremented by nb.
+ */
+
+VOID outabin(bp, nb)
+char *bp;
+a_uint nb;
+{
+  int m;
+
+  if ((pass == 2) && oflag) {
+    while (nb != 0) {
+      outchk(1, 0);
+      m = (int)(&txt[NTXT] - 1 - txtp);
+      if ((a_uint)m > nb) {
+        m = (int)nb;
+      }
+      memcpy(txtp, bp, m);
+      txtp += m;
+      bp += m;
+      nb -= m;
+      dot.s_addr += m;
+    }
+  }
+  dot.s_addr += nb;
+  /*
+   * Area has code
+   */
+  dot.s_area->a_flag |= A_OUT;
+}
+
 /*)Function	VOID	outrb(esp, r)
  *)Function	VOID	outrw(esp, r)
  *)Function	VOID	outr3b(esp, r)
@@ -1189,18 +1327,20 @@ int nr;
  *	buffer pointers and counters are initialized.
  *
  *	local variables:
- *		none
+ *		int	ph		previous statistics phase
  *
  *	global variables:
  *		FILE *	ofp		relocation output file handle
  *		char	rel[]		relocation data for code/data array
  *		char *	relp		pointer to rel array
+ *		struct astat *	stp	current pass statistics
  *		char	txt[]		assembled code/data array
  *		char *	txtp		pointer to txt array
  *
  *	functions called:
  *		int	fprintf()	c_library
  *		VOID	out()		asout.c
+ *		int	stphase()	asstat.c
  *
  *	side effects:
  *		All bufferred data written to .REL file and
@@ -1210,7 +1350,11 @@ int nr;
 VOID outbuf(s)
 char *s;
 {
+  int ph;
+
+  ph = stphase(PH_OUTPUT);
   if (txtp > &txt[a_bytes]) {
+    stp->st_cnt[ST_REC] += 1;
     fprintf(ofp, "T");
     out(txt, (int)(txtp - txt));
     fprintf(ofp, "\n");
@@ -1220,6 +1364,7 @@ char *s;
   }
   txtp = txt;
   relp = rel;
+  stphase(ph);
 }
 
 /*)Function	VOID	outgsd()
@@ -1227,7 +1372,8 @@ char *s;
  *	The function outgsd() performs the following:
  *	(1)	outputs the .REL file radix
  *	(2)	outputs the header specifying the number
- *		of areas and global symbols
+ *		of areas and global symbols and the merge
+ *		mode of the relaxable jumps
  *	(3)	outputs the module name
  *	(4)	outputs the merge mode specifications
  *	(5)	outputs the bank specifications
@@ -1254,6 +1400,7 @@ char *s;
  *		area *	areap		pointer to an area structure
  *		bank *	bankp		pointer to a  bank structure
  *		int	hilo		byte order
+ *		int	rxdef		merge mode of the relaxable jumps
  *		mode *	modep[]		array of pointers to the merge mode
  *structures char	module[]	module name string sym *
  *symhash[]	array of pointers to NHASH linked symbol lists int	xflag
@@ -1317,17 +1464,24 @@ VOID outgsd() {
    */
   if (xflag == 0) {
     fprintf(ofp, "X%c%d\n", (int)hilo ? 'H' : 'L', a_bytes);
-    fprintf(ofp, "H %X areas %X global symbols %X banks %X modes\n", narea,
+    fprintf(ofp, "H %X areas %X global symbols %X banks %X modes", narea,
             nglob, nbank, nmode);
+    if (rxdef)
+      fprintf(ofp, " %X relax", rxdef);
   } else if (xflag == 1) {
     fprintf(ofp, "Q%c%d\n", (int)hilo ? 'H' : 'L', a_bytes);
-    fprintf(ofp, "H %o areas %o global symbols %o banks %o modes\n", narea,
+    fprintf(ofp, "H %o areas %o global symbols %o banks %o modes", narea,
             nglob, nbank, nmode);
+    if (rxdef)
+      fprintf(ofp, " %o relax", rxdef);
   } else if (xflag == 2) {
     fprintf(ofp, "D%c%d\n", (int)hilo ? 'H' : 'L', a_bytes);
-    fprintf(ofp, "H %u areas %u global symbols %u banks %u modes\n", narea,
+    fprintf(ofp, "H %u areas %u global symbols %u banks %u modes", narea,
             nglob, nbank, nmode);
+    if (rxdef)
+      fprintf(ofp, " %u relax", rxdef);
   }
+  fprintf(ofp, "\n");
 
   /*
    * Module name
@@ -2065,3 +2219,92 @@ a_uint v;
 {
   return ((int)((v >> 24) & 0377));
 }
+
+/*)Function	VOID	rxadd()
+ *
+ *	The function rxadd() is called by the machine dependent
+ *	code for each relaxable jump.  On pass 1 the area and
+ *	address of the jump are saved for rxspan().
+ *
+ *	local variables:
+ *		rxj *	rp		pointer to a rxj structure
+ *
+ *	global variables:
+ *		sym	dot		defined as sym[0]
+ *		int	pass		assembler pass number
+ *		rxj *	rxjp		pointer to the first
+ *					relaxable jump structure
+ *
+ *	functions called:
+ *		VOID *	new()		assym.c
+ *
+ *	side effects:
+ *		A new rxj structure may be created.
+ */
+
+VOID rxadd() {
+  struct rxj *rp;
+
+  if (pass != 1) {
+    return;
+  }
+  rp = (struct rxj *)new (sizeof(struct rxj));
+  rp->r_ap = dot.s_area;
+  rp->r_addr = dot.s_addr;
+  rp->r_rp = rxjp;
+  rxjp = rp;
+}
+
+/*)Function	int	rxspan(ap, a1, a2)
+ *
+ *		area *	ap		pointer to an area structure
+ *		a_uint	a1		first address
+ *		a_uint	a2		second address
+ *
+ *	The function rxspan() is called on pass 2 for a
+ *	difference of two addresses of the area ap and for
+ *	a boundary of the area.  The linker may shorten the
+ *	relaxable jumps, so such a value is not known when
+ *	a jump of the area lies between the two addresses.
+ *
+ *	rxspan() returns a (1) if a relaxable jump lies at
+ *	or above the lower address and below the higher one
+ *	else a (0).
+ *
+ *	local variables:
+ *		a_uint	hi		higher address
+ *		a_uint	lo		lower address
+ *		rxj *	rp		pointer to a rxj structure
+ *
+ *	global variables:
+ *		int	pass		assembler pass number
+ *		rxj *	rxjp		pointer to the first
+ *					relaxable jump structure
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+int rxspan(ap, a1, a2)
+struct area *ap;
+a_uint a1;
+a_uint a2;
+{
+  struct rxj *rp;
+  a_uint lo, hi;
+
+  if ((pass != 2) || (rxjp == NULL)) {
+    return (0);
+  }
+  lo = (a1 < a2) ? a1 : a2;
+  hi = (a1 < a2) ? a2 : a1;
+  for (rp = rxjp; rp != NULL; rp = rp->r_rp) {
+    if ((rp->r_ap == ap) && (rp->r_addr >= lo) && (rp->r_addr < hi)) {
+      return (1);
+    }
+  }
+  return (0);
+}
@@ -0,0 +1,378 @@
+/* asstat.c */
+
+/*
+ *  Copyright (C) 1989-2019  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include "asxxxx.h"
+
+/*)Module	asstat.c
+ *
+ *	The module asstat.c contains the functions which
+ *	collect and report the assembler timing and counter
+ *	statistics selected by the -tt (and -ttt for JSON)
+ *	option.
+ *
+ *	The elapsed time of each pass is charged to the
+ *	current phase.  stphase() switches the current phase
+ *	and returns the previous phase so that the caller can
+ *	restore it, nested phases are charged exclusively.
+ *	The counters in the astat structure of the current
+ *	pass are updated directly by the assembler functions
+ *	through the pointer stp.
+ *
+ *	asstat.c contains the following functions:
+ *		VOID	stinit()
+ *		VOID	stlist(fp)
+ *		VOID	stpass(n)
+ *		int	stphase(ph)
+ *		VOID	stsym(n)
+ *		double	sttime()
+ *
+ *	asstat.c contains the following local variables:
+ *		int	stph		current phase
+ *		double	sttlast		time of the last phase change
+ *		char *	stname[]	phase names
+ *		char *	stjson[]	phase JSON keys
+ *		char *	stcnt[][]	counter names and JSON keys
+ */
+
+static int stph = PH_OTHER;
+static double sttlast;
+
+static char *stname[NPHASE] = {"Other",        "Line Input",
+                               ".define Scan", "Macro Expansion",
+                               "Directives",   "Symbol Lookup",
+                               "Expressions",  "Machine Code",
+                               "Output"};
+
+static char *stcnt[NSTCNT][2] = {{"Source Lines", "lines"},
+                                 {"Macro Lines", "macro_lines"},
+                                 {"Include Files", "includes"},
+                                 {"Identifiers", "tokens"},
+                                 {"Symbol Lookups", "symbol_lookups"},
+                                 {"Symbol Chain", "symbol_chain"},
+                                 {"Longest Chain", "symbol_chain_max"},
+                                 {"Mnemonic Lookups", "mnemonic_lookups"},
+                                 {"Mnemonic Chain", "mnemonic_chain"},
+                                 {".define Searches", "define_searches"},
+                                 {"Expressions", "expressions"},
+                                 {"Instructions", "instructions"},
+                                 {"Object Records", "records"},
+                                 {"Listing Lines", "listing_lines"}};
+
+static char *stjson[NPHASE] = {"other",  "input", "define", "macro", "parse",
+                               "symbol", "expr",  "machine", "output"};
+
+/*)Function	double	sttime()
+ *
+ *	The function sttime() returns the current time in
+ *	seconds.  A monotonic wall clock is used when it is
+ *	available else the processor time from clock().
+ *
+ *	local variables:
+ *		struct timespec	ts	time value
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		int	clock_gettime()	c_library
+ *		clock_t	clock()		c_library
+ *
+ *	side effects:
+ *		none
+ */
+
+double sttime() {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec);
+#else
+  return ((double)clock() / (double)CLOCKS_PER_SEC);
+#endif
+}
+
+/*)Function	VOID	stinit()
+ *
+ *	The function stinit() starts the statistics
+ *	timer in pass 0 phase PH_OTHER.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct astat *	stp	current pass statistics
+ *		int	stph		current phase
+ *		double	sttlast		time of the last phase change
+ *
+ *	functions called:
+ *		double	sttime()	asstat.c
+ *
+ *	side effects:
+ *		The statistics timer is started.
+ */
+
+VOID stinit() {
+  stp = &astat[0];
+  stph = PH_OTHER;
+  sttlast = sttime();
+}
+
+/*)Function	int	stphase(ph)
+ *
+ *		int	ph		new phase
+ *
+ *	The function stphase() charges the time since the
+ *	last phase change to the current phase and then makes
+ *	ph the current phase.  Without -tt only the phase
+ *	number is changed.
+ *
+ *	stphase() returns the previous phase.
+ *
+ *	local variables:
+ *		int	i		previous phase
+ *		double	t		current time
+ *
+ *	global variables:
+ *		struct astat *	stp	current pass statistics
+ *		int	stph		current phase
+ *		double	sttlast		time of the last phase change
+ *		int	tflag		-t, diagnostic / statistics flag
+ *
+ *	functions called:
+ *		double	sttime()	asstat.c
+ *
+ *	side effects:
+ *		The current phase is changed.
+ */
+
+int stphase(ph)
+int ph;
+{
+  int i;
+  double t;
+
+  i = stph;
+  if (tflag > 1) {
+    t = sttime();
+    stp->st_time[i] += t - sttlast;
+    sttlast = t;
+  }
+  stph = ph;
+  return (i);
+}
+
+/*)Function	VOID	stpass(n)
+ *
+ *		int	n		pass number, NSTPASS - 1 for
+ *					the final output
+ *
+ *	The function stpass() charges the elapsed time to
+ *	the current pass and selects the statistics of pass n.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct astat	astat[]	statistics for each pass
+ *		struct astat *	stp	current pass statistics
+ *
+ *	functions called:
+ *		int	stphase()	asstat.c
+ *
+ *	side effects:
+ *		The current pass statistics are changed
+ *		and the phase is set to PH_OTHER.
+ */
+
+VOID stpass(n)
+int n;
+{
+  stphase(PH_OTHER);
+  stp = &astat[(n < NSTPASS) ? n : NSTPASS - 1];
+}
+
+/*)Function	VOID	stsym(n)
+ *
+ *		int	n		number of hash chain entries searched
+ *
+ *	The function stsym() counts a symbol lookup
+ *	and the length of the hash chain searched.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct astat *	stp	current pass statistics
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		Symbol lookup counters updated.
+ */
+
+VOID stsym(n)
+int n;
+{
+  stp->st_cnt[ST_SLKUP] += 1;
+  stp->st_cnt[ST_SCHAIN] += n;
+  if (n > stp->st_cnt[ST_SMAX]) {
+    stp->st_cnt[ST_SMAX] = n;
+  }
+}
+
+/*)Function	VOID	stlist(fp)
+ *
+ *		FILE *	fp		output file handle
+ *
+ *	The function stlist() outputs the timing and counter
+ *	statistics for each pass and the totals.  With -ttt
+ *	the statistics are output as a JSON object.
+ *
+ *	local variables:
+ *		struct astat	tot	statistics totals
+ *		struct astat *	sp	pointer to pass statistics
+ *		double	t		pass time
+ *		int	i		loop counter
+ *		int	j		loop counter
+ *
+ *	global variables:
+ *		struct astat	astat[]	statistics for each pass
+ *		char	cpu[]		assembler type string
+ *		int	tflag		-t, diagnostic / statistics flag
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		int	stphase()	asstat.c
+ *
+ *	side effects:
+ *		The statistics are written to fp.
+ */
+
+VOID stlist(fp)
+FILE *fp;
+{
+  struct astat tot;
+  struct astat *sp;
+  double t;
+  int i, j;
+
+  stphase(stph);
+
+  /*
+   * Totals
+   */
+  memset(&tot, 0, sizeof(tot));
+  for (i = 0; i < NSTPASS; i++) {
+    sp = &astat[i];
+    for (j = 0; j < NPHASE; j++) {
+      tot.st_time[j] += sp->st_time[j];
+    }
+    for (j = 0; j < NSTCNT; j++) {
+      if (j == ST_SMAX) {
+        if (sp->st_cnt[j] > tot.st_cnt[j])
+          tot.st_cnt[j] = sp->st_cnt[j];
+      } else {
+        tot.st_cnt[j] += sp->st_cnt[j];
+      }
+    }
+  }
+
+  if (tflag > 2) {
+    /*
+     * JSON Output
+     */
+    fprintf(fp, "{\"assembler\": \"ASxxxx %s (%s)\",\n", VERSION, cpu);
+    fprintf(fp, " \"passes\": [\n");
+    for (i = 0; i <= NSTPASS; i++) {
+      sp = (i < NSTPASS) ? &astat[i] : &tot;
+      if (i == NSTPASS) {
+        fprintf(fp, " ],\n \"total\":\n");
+      }
+      for (t = 0.0, j = 0; j < NPHASE; j++) {
+        t += sp->st_time[j];
+      }
+      fprintf(fp, "  {");
+      if (i < NSTPASS) {
+        if (i < NSTPASS - 1) {
+          fprintf(fp, "\"pass\": %d, ", i);
+        } else {
+          fprintf(fp, "\"pass\": \"final\", ");
+        }
+      }
+      fprintf(fp, "\"time_ms\": %.3f,\n   \"phases_ms\": {", 1000.0 * t);
+      for (j = 0; j < NPHASE; j++) {
+        fprintf(fp, "%s\"%s\": %.3f", j ? ", " : "", stjson[j],
+                1000.0 * sp->st_time[j]);
+      }
+      fprintf(fp, "},\n   \"counters\": {");
+      for (j = 0; j < NSTCNT; j++) {
+        fprintf(fp, "%s\"%s\": %ld", j ? ", " : "", stcnt[j][1],
+                sp->st_cnt[j]);
+      }
+      fprintf(fp, "}}%s\n", (i < NSTPASS - 1) ? "," : "");
+    }
+    fprintf(fp, "}\n");
+    return;
+  }
+
+  /*
+   * Formatted Output
+   */
+  fprintf(fp, "Assembler Statistics (milliseconds)\n");
+  fprintf(fp, "%-18s %10s %10s %10s %10s %10s\n", "", "Pass 0", "Pass 1",
+          "Pass 2", "Final", "Total");
+  for (j = 0; j < NPHASE; j++) {
+    fprintf(fp, "%-18s", stname[j]);
+    for (i = 0; i < NSTPASS; i++) {
+      fprintf(fp, " %10.3f", 1000.0 * astat[i].st_time[j]);
+    }
+    fprintf(fp, " %10.3f\n", 1000.0 * tot.st_time[j]);
+  }
+  fprintf(fp, "%-18s", "Total");
+  for (i = 0; i <= NSTPASS; i++) {
+    sp = (i < NSTPASS) ? &astat[i] : &tot;
+    for (t = 0.0, j = 0; j < NPHASE; j++) {
+      t += sp->st_time[j];
+    }
+    fprintf(fp, " %10.3f", 1000.0 * t);
+  }
+  fprintf(fp, "\n\n");
+
+  fprintf(fp, "Assembler Counters\n");
+  for (j = 0; j < NSTCNT; j++) {
+    fprintf(fp, "%-18s", stcnt[j][0]);
+    for (i = 0; i <= NSTPASS; i++) {
+      sp = (i < NSTPASS) ? &astat[i] : &tot;
+      fprintf(fp, " %10ld", sp->st_cnt[j]);
+    }
+    fprintf(fp, "\n");
+  }
+  if (tot.st_cnt[ST_SLKUP] != 0) {
+    fprintf(fp, "%-18s %10.2f\n", "Average Chain",
+            (double)tot.st_cnt[ST_SCHAIN] / (double)tot.st_cnt[ST_SLKUP]);
+  }
+  fprintf(fp, "\n");
+}
@@ -173,7 +173,7 @@ char *errors[] = {
     "<b> address / direct page boundary error",
     "<c> .bndry offset error",
     "<d> direct page addressing error",
-    "<i> .include file error or an .if/.endif mismatch",
+    "<i> .include/.incbin file error or an .if/.endif mismatch",
     "<k> numerical conversion error",
     "<m> multiple definitions error or macro recursion error",
     "<n> .endm, .mexit, or .narg outside of a macro",
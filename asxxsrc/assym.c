@@ -249,10 +249,12 @@ char *id;
  *	local variables:
  *		mne *	mp		pointer to mne structure
  *		int	h		calculated hash value
+ *		int	n		hash chain entries searched
  *
  *	global variables:
  *		mne * mnehash[]		array of pointers to NHASH
  *					linked mnemonic/directive lists
+ *		struct astat *	stp	current pass statistics
  *
  *	functions called:
  *		none
@@ -265,19 +267,23 @@ struct mne *mlookup(id)
 char *id;
 {
   struct mne *mp;
-  int h;
+  int h, n;
 
   /*
    * JLH: case insensitive lookup always
    */
   h = hash(id, 1);
   mp = mnehash[h];
+  n = 0;
   while (mp) {
+    n++;
     if (symeq(id, mp->m_id, 1))
-      return (mp);
+      break;
     mp = mp->m_mp;
   }
-  return (NULL);
+  stp->st_cnt[ST_MLKUP] += 1;
+  stp->st_cnt[ST_MCHAIN] += n;
+  return (mp);
 }
 
 /*)Function	sym *	slookup(id)
@@ -291,6 +297,8 @@ char *id;
  *	local variables:
  *		int	h		computed hash value
  *		sym *	sp		pointer to a sym structure
+ *		int	n		hash chain entries searched
+ *		int	ph		previous statistics phase
  *
  *	global varaibles:
  *		sym *	symhash[]	array of pointers to NHASH
@@ -299,6 +307,8 @@ char *id;
  *
  *	functions called:
  *		int	hash()		assym.c
+ *		int	stphase()	asstat.c
+ *		VOID	stsym()		asstat.c
  *		int	symeq()		assym.c
  *
  *	side effects:
@@ -309,16 +319,21 @@ struct sym *slookup(id)
 char *id;
 {
   struct sym *sp;
-  int h;
+  int h, n, ph;
 
+  ph = stphase(PH_SYMBOL);
   h = hash(id, zflag);
   sp = symhash[h];
+  n = 0;
   while (sp) {
+    n++;
     if (symeq(id, sp->s_id, zflag))
-      return (sp);
+      break;
     sp = sp->s_sp;
   }
-  return (NULL);
+  stsym(n);
+  stphase(ph);
+  return (sp);
 }
 
 /*)Function	sym *	lookup(id)
@@ -334,6 +349,8 @@ char *id;
  *	local variables:
  *		int	h		computed hash value
  *		sym *	sp		pointer to a sym structure
+ *		int	n		hash chain entries searched
+ *		int	ph		previous statistics phase
  *
  *	global varaibles:
  *		sym *	symhash[]	array of pointers to NHASH
@@ -344,6 +361,8 @@ char *id;
  *		int	hash()		assym.c
  *		VOID *	new()		assym.c
  *		char *	strsto()	assym.c
+ *		int	stphase()	asstat.c
+ *		VOID	stsym()		asstat.c
  *		int	symeq()		assym.c
  *
  *	side effects:
@@ -355,15 +374,23 @@ struct sym *lookup(id)
 char *id;
 {
   struct sym *sp;
-  int h;
+  int h, n, ph;
 
+  ph = stphase(PH_SYMBOL);
   h = hash(id, zflag);
   sp = symhash[h];
+  n = 0;
   while (sp) {
+    n++;
     if (symeq(id, sp->s_id, zflag))
-      return (sp);
+      break;
     sp = sp->s_sp;
   }
+  stsym(n);
+  if (sp != NULL) {
+    stphase(ph);
+    return (sp);
+  }
   sp = (struct sym *)new (sizeof(struct sym));
   sp->s_sp = symhash[h];
   symhash[h] = sp;
@@ -374,6 +401,7 @@ char *id;
   sp->s_area = NULL;
   sp->s_ref = 0;
   sp->s_addr = 0;
+  stphase(ph);
   return (sp);
 }
 
@@ -63,6 +63,26 @@
  */
 #define SDCDB 1
 
+/*
+ * To map the .incbin files into memory
+ * set ASMMAP non-zero, requires mmap()
+ */
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#define ASMMAP 1
+#else
+#define ASMMAP 0
+#endif
+
+/*
+ * To create the -k cache directory when it
+ * does not exist set ASMCACHE non-zero, requires mkdir()
+ */
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#define ASMCACHE 1
+#else
+#define ASMCACHE 0
+#endif
+
 /*
  * The assembler requires certain variables to have
  * at least 32 bits to allow correct address processing.
@@ -174,6 +194,7 @@
 #define ELIST 5 /* Equate or IF conditional evaluation */
 
 #define HLR_NLST 0x0080 /* For HLR file only */
+#define HLR_NBMAX 0xFF  /* Maximum byte count of one hint */
 
 #define LIST_ERR 0x0001 /* Error Code(s) */
 #define LIST_LOC 0x0002 /* Location */
@@ -233,6 +254,12 @@
 #define NTXT 16 /* Maximum T Line Values */
 #define NREL 16 /* Maximum R Line Values */
 
+/*
+ * Constant .db/.dw/.3byte/.4byte values
+ * collected for outablk()
+ */
+#define NDATA 64 /* Maximum Bulk Data Values */
+
 /*
  * Internal Definitions
  */
@@ -500,7 +527,9 @@ struct sym {
 #define O_TITLE 0        /* .title */
 #define O_SBTTL 1        /* .sbttl */
 #define S_MODUL 5        /* .module */
-#define S_INCL 6         /* .include */
+#define S_INCL 6         /* .include, .incbin */
+#define O_INCL 0         /* .include */
+#define O_INCBIN 1       /* .incbin */
 #define S_AREA 7         /* .area */
 #define S_ATYP 8         /* .area type */
 #define S_BANK 9         /* .bank */
@@ -675,6 +704,66 @@ struct def {
   int d_dflag;      /* (1) .defined / (0) .undefined */
 };
 
+/*
+ *	The skip structure records the extent of a run of source
+ *	file lines in a false conditional block which can not
+ *	change the state of the assembler.  The runs are found
+ *	by skpline() when first scanned and later passes seek
+ *	from the beginning of the run to its end.
+ */
+struct skip {
+  struct skip *k_kp; /* link to next skip */
+  char *k_fn;        /* source file name */
+  long k_bgn;        /* file offset of the first line */
+  long k_end;        /* file offset following the run */
+  int k_lines;       /* number of lines in the run */
+};
+
+/*
+ *	The incg structure records the include guard of an
+ *	.include file.  A file is guarded when the only lines
+ *	outside of comments are enclosed in a .ifndef / .endif
+ *	block.  g_id is NULL for a file without a guard.
+ */
+struct incg {
+  struct incg *g_gp; /* link to next include guard */
+  char *g_fn;        /* include file name */
+  char *g_id;        /* guard symbol or NULL */
+  int g_lvl;         /* maximum .if nesting in the file */
+};
+
+/*
+ *	The depf structure records a file read by the
+ *	assembler for the -m dependency file.
+ */
+struct depf {
+  struct depf *f_fp; /* link to next dependency */
+  char *f_fn;        /* file name */
+  int f_pass;        /* passes reading the file */
+};
+
+/*
+ *	The rxj structure records the address of a
+ *	relaxable jump assembled on pass 1.
+ */
+struct rxj {
+  struct rxj *r_rp;  /* link to next jump */
+  struct area *r_ap; /* area of the jump */
+  a_uint r_addr;     /* address of the jump */
+};
+
+/*
+ *	The chash structure contains the two 32-bit halves
+ *	of a -k cache hash value.  NCHEXT is the number of
+ *	output file types saved in the cache.
+ */
+#define NCHEXT 5
+
+struct chash {
+  unsigned INT32 h_a; /* FNV-1a hash */
+  unsigned INT32 h_b; /* shift-add-xor hash */
+};
+
 /*
  *	The mode structure contains the specification of one of the
  *	assemblers' merge modes.  Each assembler must specify
@@ -902,6 +991,59 @@ struct memlnk {
   VOID *ptr;           /* pointer to allocated memory */
 };
 
+/*
+ *	Assembler Statistics (-tt / -ttt) Phases
+ *
+ *	The elapsed time of each assembler pass is divided
+ *	between these phases.  Time spent in a nested phase
+ *	(a symbol lookup within an expression) is charged
+ *	only to the nested phase.
+ */
+#define PH_OTHER 0  /* Pass Sequencing */
+#define PH_INPUT 1  /* Line Input		nxtline() */
+#define PH_SCAN 2   /* .define Scanning	scanline() */
+#define PH_MACRO 3  /* Macro Expansion		fgetm() */
+#define PH_PARSE 4  /* Labels / Directives	asmbl() */
+#define PH_SYMBOL 5 /* Symbol Lookup */
+#define PH_EXPR 6   /* Expression Evaluation	expr() */
+#define PH_MACH 7   /* Machine Code		machine() */
+#define PH_OUTPUT 8 /* Object / Listing Output */
+#define NPHASE 9
+
+#define NSTPASS 4 /* Passes 0, 1, 2 and Final Output */
+
+/*
+ *	Assembler Statistics Counters
+ */
+#define ST_LINES 0   /* Source lines read */
+#define ST_MLINES 1  /* Macro lines expanded */
+#define ST_INCL 2    /* Include files opened */
+#define ST_TOKENS 3  /* Identifiers scanned */
+#define ST_SLKUP 4   /* Symbol lookups */
+#define ST_SCHAIN 5  /* Symbol hash chain entries searched */
+#define ST_SMAX 6    /* Longest symbol hash chain searched */
+#define ST_MLKUP 7   /* Mnemonic / directive lookups */
+#define ST_MCHAIN 8  /* Mnemonic hash chain entries searched */
+#define ST_DLKUP 9   /* .define substitution searches */
+#define ST_EXPR 10   /* Expressions evaluated */
+#define ST_MACH 11   /* Machine instructions processed */
+#define ST_REC 12    /* Object T / R record pairs written */
+#define ST_LST 13    /* Listing lines written */
+#define NSTCNT 14
+
+/*
+ *	The astat structure contains the timing and
+ *	counter statistics for one assembler pass.
+ *
+ * The Parameters:
+ *	st_time[]	is the time (seconds) spent in each phase
+ *	st_cnt[]	are the ST_xxxx counters
+ */
+struct astat {
+  double st_time[NPHASE]; /* Time in each phase */
+  long st_cnt[NSTCNT];    /* Counters */
+};
+
 /*
  *	External Definitions for all Global Variables
  */
@@ -932,6 +1074,10 @@ extern struct mcrdef *mcrp;    /*	link to list of defined macros
                                 */
 extern struct memlnk *asxmem;  /*	Assembler Memory Allocation Structure
                                 */
+extern struct astat astat[NSTPASS]; /*	-tt statistics for each pass
+                                     */
+extern struct astat *stp;      /*	pointer to the current pass statistics
+                                */
 extern struct memlnk *pmcrmem; /*	First Macro Memory Allocation Structure
                                 */
 extern struct memlnk *mcrmem;  /*	Macro Memory Allocation Structure
@@ -1012,8 +1158,13 @@ extern int jflag; /*	-j, enable NoICE Debug Symbols
                    */
 #endif
 
+extern int kflag; /*	-k, use the assembly result cache
+                   */
 extern int lflag; /*	-l, generate listing flag
                    */
+extern int mflag; /*	-m, generate dependency file flag
+                   *	-mm, dependency file only
+                   */
 extern int oflag; /*	-o, generate relocatable output flag
                    */
 extern int pflag; /*	-p, disable listing pagination
@@ -1023,6 +1174,8 @@ extern int rflag; /*	-r, put line numbers in hint file for .lst to .rst
 extern int sflag; /*	-s, generate symbol table flag
                    */
 extern int tflag; /*	-t, output diagnostic parameters from assembler
+                   *	-tt, and timing statistics
+                   *	-ttt, as JSON
                    */
 extern int uflag; /*	-u, disable .list/.nlist processing flag
                    */
@@ -1056,6 +1209,13 @@ extern int as_msb;                 /*	current MSB byte select
                                     *	2 == third byte
                                     *	3 == fourth byte
                                     */
+extern int rxmode;                 /*	merge mode of the relaxable jumps
+                                    *	0 == jumps are not relaxable
+                                    */
+extern int rxdef;                  /*	merge mode of the relaxable jumps
+                                    *	of the module
+                                    *	0 == no branch relaxation
+                                    */
 extern a_uint laddr;               /*	address of current assembler line,
                                     *	equate, or value of .if argument
                                     */
@@ -1092,6 +1252,18 @@ extern struct sym *symhash[NHASH]; /*	array of pointers to NHASH
 extern struct mne *mnehash[NHASH]; /*	array of pointers to NHASH
                                     *	linked mnemonic/directive lists
                                     */
+extern struct skip *skphash[NHASH]; /*	array of pointers to NHASH
+                                     *	linked false conditional runs
+                                     */
+extern struct incg *incgp;          /*	pointer to the first include
+                                     *	guard structure
+                                     */
+extern struct depf *depp;          /*	pointer to the first
+                                    *	dependency file structure
+                                    */
+extern struct rxj *rxjp;           /*	pointer to the first
+                                    *	relaxable jump structure
+                                    */
 extern char *ep;                   /*	pointer into error list
                                     *	array eb[NERR]
                                     */
@@ -1118,6 +1290,9 @@ extern int *cpt;                   /*	pointer to assembler relocation type
 extern int cbt[NCODE];             /*	array of assembler relocation types
                                     *	describing the data in cb[]
                                     */
+extern a_uint ibnb;                /*	.incbin bytes output by this line
+                                    *	which are not saved in cb[]
+                                    */
 extern int opcycles;               /*	opcode execution cycles
                                     */
 extern char tb[NTITL];             /*	Title string buffer
@@ -1179,7 +1354,13 @@ extern VOID afilex(char *fn, char *ft);
 extern VOID asexit(int i);
 extern VOID asmbl(void);
 extern VOID boundary(a_uint n);
+extern VOID depadd(char *fn);
+extern VOID deplst(FILE *fp, char *tgt);
+extern VOID depput(FILE *fp, char *str);
 extern VOID equate(char *id, struct expr *e1, a_uint equtype);
+extern VOID incbin(char *fn, a_uint offset, a_uint length);
+extern VOID incgrd(char *fn, FILE *fp);
+extern int incskp(char *fn);
 extern int fndidx(char *str);
 extern int intsiz(void);
 extern VOID insline(char *str, int i);
@@ -1223,6 +1404,8 @@ extern int more(void);
 extern int nxtline(void);
 extern int replace(char *id);
 extern VOID scanline(void);
+extern int skpchk(char *str);
+extern int skpline(struct asmf *ap);
 extern VOID unget(int c);
 
 /* assym.c */
@@ -1257,11 +1440,31 @@ extern VOID clrexpr(struct expr *esp);
 extern int digit(int c, int r);
 extern VOID exprmasks(int n);
 extern VOID expr(struct expr *esp, int n);
+extern int exprlit(a_uint *vp);
 extern int is_abs(struct expr *esp);
 extern int oprio(int c);
 extern a_uint rngchk(a_uint n);
 extern VOID term(struct expr *esp);
 
+/* ascache.c */
+extern VOID chbgn(struct chash *hp);
+extern int chcopy(char *from, char *to);
+extern char *chext(int i);
+extern int chfile(char *fn, struct chash *hp);
+extern VOID chkey(int argc, char *argv[]);
+extern int chload(char *q);
+extern char *chname(struct chash *hp, char *ext);
+extern VOID chsave(char *q);
+extern VOID chstr(struct chash *hp, char *bp, int n);
+
+/* asstat.c */
+extern VOID stinit(void);
+extern VOID stlist(FILE *fp);
+extern VOID stpass(int n);
+extern int stphase(int ph);
+extern VOID stsym(int n);
+extern double sttime(void);
+
 /* asdbg */
 extern char *BaseFileName(struct asmf *currFile);
 extern VOID DefineNoICE_Line(void);
@@ -1272,6 +1475,12 @@ extern VOID list(void);
 extern VOID list1(char *wp, int *wpt, int nb);
 extern VOID list2(int t);
 extern VOID listhlr(int hlr_lst, int hlr_mode, int hlr_nb);
+extern VOID listhbin(int hlr_lst, int hlr_mode, a_uint hlr_nb);
+extern VOID lstinit(void);
+extern char *lstnum(char *p, a_uint v, int r, int w, int c);
+extern VOID lstout(void);
+extern VOID lstpad(int n);
+extern char *lstsrc(char *p, char *str);
 extern VOID lstsym(FILE *fp);
 extern VOID slew(FILE *fp, int flag);
 
@@ -1298,6 +1507,8 @@ extern VOID outa3b(a_uint v);
 extern VOID outa4b(a_uint v);
 extern VOID outaxb(int i, a_uint v);
 extern VOID outatxb(int i, a_uint v);
+extern VOID outablk(int i, a_uint *vp, int nv);
+extern VOID outabin(char *bp, a_uint nb);
 extern VOID outrb(struct expr *esp, int r);
 extern VOID outrw(struct expr *esp, int r);
 extern VOID outr3b(struct expr *esp, int r);
@@ -1316,6 +1527,8 @@ extern VOID out_l4b(a_uint v, int t);
 extern VOID out_lxb(int i, a_uint v, int t);
 extern VOID out_rw(a_uint v);
 extern VOID out_txb(int i, a_uint v);
+extern VOID rxadd(void);
+extern int rxspan(struct area *ap, a_uint a1, a_uint a2);
 
 /* Machine dependent variables */
 
@@ -1362,7 +1575,13 @@ extern VOID afilex();
 extern VOID asexit();
 extern VOID asmbl();
 extern	VOID		boundary);
+extern VOID depadd();
+extern VOID deplst();
+extern VOID depput();
 extern VOID equate();
+extern VOID incbin();
+extern VOID incgrd();
+extern int incskp();
 extern int fndidx();
 extern int intsiz();
 extern VOID insline();
@@ -1404,6 +1623,8 @@ extern int more();
 extern int nxtline();
 extern int replace();
 extern VOID scanline();
+extern int skpchk();
+extern int skpline();
 extern VOID unget();
 
 /* assym.c */
@@ -1438,11 +1659,31 @@ extern VOID clrexpr();
 extern int digit();
 extern VOID exprmasks();
 extern VOID expr();
+extern int exprlit();
 extern int is_abs();
 extern int oprio();
 extern a_uint rngchk();
 extern VOID term();
 
+/* ascache.c */
+extern VOID chbgn();
+extern int chcopy();
+extern char *chext();
+extern int chfile();
+extern VOID chkey();
+extern int chload();
+extern char *chname();
+extern VOID chsave();
+extern VOID chstr();
+
+/* asstat.c */
+extern VOID stinit();
+extern VOID stlist();
+extern VOID stpass();
+extern int stphase();
+extern VOID stsym();
+extern double sttime();
+
 /* asdbg */
 extern char *BaseFileName();
 extern VOID DefineNoICE_Line();
@@ -1453,6 +1694,12 @@ extern VOID list();
 extern VOID list1();
 extern VOID list2();
 extern VOID listhlr();
+extern VOID listhbin();
+extern VOID lstinit();
+extern char *lstnum();
+extern VOID lstout();
+extern VOID lstpad();
+extern char *lstsrc();
 extern VOID lstsym();
 extern VOID slew();
 
@@ -1479,6 +1726,8 @@ extern VOID outa3b();
 extern VOID outa4b();
 extern VOID outaxb();
 extern VOID outatxb();
+extern VOID outablk();
+extern VOID outabin();
 extern VOID outrb();
 extern VOID outrw();
 extern VOID outr3b();
@@ -1497,6 +1746,8 @@ extern VOID out_l4b();
 extern VOID out_lxb();
 extern VOID out_rw();
 extern VOID out_txb();
+extern VOID rxadd();
+extern int rxspan();
 
 /* Machine dependent variables */
 
@@ -11,4 +11,14 @@
         cp (iy+offset)
         cp #offset
 
+        ; reports an 'i' error and outputs no data,
+        ; the length is beyond the end of the file
+        .incbin "tz80.bat",0,0x1000
 
+        ; reports an 'r' and a 'c' error, the linker
+        ; may shorten the relaxable jump before them
+        .area   RLX
+        .relax
+rlx1:   jp      rlx2
+rlx2:   .dw     rlx2-rlx1
+        .bndry  4
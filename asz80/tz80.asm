@@ -1155,4 +1155,9 @@ jr5:
 	tstio	#n			;ED 74 20
 	tstio	 n			;ED 74 20
 	;***********************************************************
+	; include binary data from a file
+	; (tz80.bat begins with 'asz80 -gloaxf')
+	.incbin	"tz80.bat",0,4		;61 73 7A 38
+	.incbin	"tz80.bat",6,7		;2D 67 6C 6F 61 78 66
+	;***********************************************************
 
@@ -0,0 +1,30 @@
+	.title	NoICE Debug File Test
+
+	.module	tz80j
+
+	; This file should be assembled and linked with
+	; the NoICE debug option.
+	;
+	; ASZ80 -JLO TZ80J
+	; ASLINK -J -I TZ80J TZ80J
+	;
+	; The ';!FILE tz80j.asm' line of the .rel file names
+	; the source file, the line symbols tz80j.n are then
+	; written as LINE records of the file tz80j:
+	;
+	;	DEF .__.ABS. 0x0
+	;	FILE tz80j
+	;	LINE 27 0x0
+	;	DEF tz80j1 0x0
+	;	LINE 28 0x1
+	;	LINE 29 0x3
+	;	LOAD tz80j.ihx
+	;	FILE tz80j.asm
+
+	.area	CODE
+
+tz80j1::
+	nop			; 00
+	ld	a,#1		; 3E 01
+	ret			; C9
+
@@ -44,4 +44,22 @@
 	.blkb	0x80
 	.blkb	0x00		;bra8:
 
+	; branch relaxation, after .relax the linker
+	; shortens a jp or jp cc (cc = NZ, Z, NC, C)
+	; to a jr when the target is in range and
+	; .relax 0 pins the jumps which follow
+
+	.area	RELAX	(REL,CON)
+
+	.relax
+rlx1:	jp	rlx2		;   C3 14 00  [18 0E]
+	jp	nz,rlx2		;   C2 14 00  [20 0C]
+	jp	z,rlx1		;   CA 00 00  [28 FA]
+	jp	pe,rlx1		;   EA 00 00  [EA 00 00]
+	.relax	0
+	jp	rlx1		;   C3 00 00  [C3 00 00]
+	.relax
+	jp	nc,rlx2		;   D2 14 00  [30 02]
+	jr	rlx1		;   18 00     [18 F0]
+rlx2:	jp	c,rlx1		;   DA 00 00  [38 EE]
 
@@ -142,6 +142,16 @@
  */
 #define S_CPU 83
 
+/*
+ * Branch Relaxation
+ */
+#define S_RELAX 84
+
+/*
+ * Relocation mode of the relaxable jumps
+ */
+#define R_JPX 0x0100 /* Extended mode 1 */
+
 /*
  * Processor Types (S_CPU)
  */
@@ -163,11 +173,26 @@ struct adsym {
   int a_val;     /* addressing mode value */
 };
 
+/*
+ * Register and condition name index, the key
+ * is the name folded and packed into an int
+ */
+#define NADHASH 64
+#define ADHASH(k) (((k) ^ ((k) >> 5) ^ ((k) >> 11)) & (NADHASH - 1))
+
+struct adhash {
+  int h_key;           /* packed name */
+  struct adsym *h_tbl; /* table of the name */
+  int h_val;           /* addressing mode value */
+};
+
 extern struct adsym R8[];
 extern struct adsym R8X[];
 extern struct adsym R16[];
 extern struct adsym R16X[];
 extern struct adsym CND[];
+extern struct adhash adhtab[];
+extern struct mode mode[];
 
 /* machine dependent functions */
 
@@ -176,12 +201,15 @@ extern struct adsym CND[];
 /* z80adr.c */
 extern int addr(struct expr *esp);
 extern int admode(struct adsym *sp);
-extern int srch(char *str);
+extern int adtok(struct adsym **spp);
+extern struct adhash *adfind(int key);
+extern VOID adinit(void);
 
 /* z80mch.c */
 extern int genop(int pop, int op, struct expr *esp, int f);
 extern int gixiy(int v);
 extern VOID machine(struct mne *mp);
+extern VOID mchjp(int op, struct expr *esp);
 extern int mchpcr(struct expr *esp);
 extern VOID minit(void);
 
@@ -190,12 +218,15 @@ extern VOID minit(void);
 /* z80adr.c */
 extern int addr();
 extern int admode();
-extern int srch();
+extern int adtok();
+extern struct adhash *adfind();
+extern VOID adinit();
 
 /* z80mch.c */
 extern int genop();
 extern int gixiy();
 extern VOID machine();
+extern VOID mchjp();
 extern int mchpcr();
 extern VOID minit();
 
@@ -29,7 +29,8 @@
  * Read an address specifier. Pack the
  * address information into the supplied
  * `expr' structure. Return the mode of
- * the address.
+ * the address.  Register names are classified
+ * with a single lookup by adtok().
  *
  * This addr(esp) routine performs the following addressing decoding:
  *
@@ -44,22 +45,28 @@ int addr(esp)
 struct expr *esp;
 {
   int c, mode, indx;
+  struct adsym *sp;
+  char *ips;
 
   if ((c = getnb()) == '#') {
     expr(esp, 0);
     esp->e_mode = S_IMMED;
   } else if (c == LFIND) {
-    if ((indx = admode(R8)) != 0) {
+    ips = ip;
+    indx = adtok(&sp);
+    if (sp == R8) {
       mode = S_INDB;
-    } else if ((indx = admode(R16)) != 0) {
+    } else if (sp == R16) {
       mode = S_INDR;
-    } else if ((indx = admode(R8X)) != 0) {
+    } else if (sp == R8X) {
       mode = S_R8X;
       aerr();
-    } else if ((indx = admode(R16X)) != 0) {
+    } else if (sp == R16X) {
       mode = S_R16X;
       aerr();
     } else {
+      ip = ips;
+      indx = 0;
       mode = S_INDM;
       expr(esp, 0);
       esp->e_mode = mode;
@@ -79,15 +86,19 @@ struct expr *esp;
     }
   } else {
     unget(c);
-    if ((indx = admode(R8)) != 0) {
+    ips = ip;
+    indx = adtok(&sp);
+    if (sp == R8) {
       mode = S_R8;
-    } else if ((indx = admode(R16)) != 0) {
+    } else if (sp == R16) {
       mode = S_R16;
-    } else if ((indx = admode(R8X)) != 0) {
+    } else if (sp == R8X) {
       mode = S_R8X;
-    } else if ((indx = admode(R16X)) != 0) {
+    } else if (sp == R16X) {
       mode = S_R16X;
     } else {
+      ip = ips;
+      indx = 0;
       mode = S_USER;
       expr(esp, 0);
       esp->e_mode = mode;
@@ -114,61 +125,135 @@ struct expr *esp;
 }
 
 /*
- * Enter admode() to search a specific addressing mode table
- * for a match. Return the addressing value on a match or
- * zero for no match.
+ * Enter admode() to match the operand against a specific
+ * addressing mode table.  Return the addressing value on
+ * a match or zero for no match.
  */
 int admode(sp)
 struct adsym *sp;
 {
-  char *ptr;
-  int i;
+  struct adsym *tp;
+  int v;
   char *ips;
 
   ips = ip;
-  unget(getnb());
-
-  i = 0;
-  while (*(ptr = &sp[i].a_str[0])) {
-    if (srch(ptr)) {
-      return (sp[i].a_val);
+  if ((v = adtok(&tp)) != 0) {
+    if (tp == sp) {
+      return (v);
+    }
+    if ((sp == CND) && (tp == R8) && (v == (C | 0400))) {
+      return (CS | 0400);
     }
-    i++;
   }
   ip = ips;
   return (0);
 }
 
 /*
- *      srch --- does string match ?
+ * adtok --- classify a register or condition name
+ *
+ * The name at ip is scanned once, folded with ccase[] and
+ * packed into a key, which is looked up in the hash index
+ * built by adinit().  A name may end with a quote, af'.
+ * Return the addressing value and the table of the name
+ * (R8, R8X, R16, R16X or CND) in *spp and skip the name.
+ * 'c' is returned as the register, admode() maps it to
+ * the condition.  Return zero and NULL in *spp, with ip
+ * unchanged, when the operand is not a reserved name.
  */
-int srch(str)
-char *str;
+int adtok(spp)
+struct adsym **spp;
 {
-  char *ptr;
-  ptr = ip;
-
-  while (*ptr && *str) {
-    if (ccase[*ptr & 0x007F] != ccase[*str & 0x007F])
-      break;
-    ptr++;
-    str++;
+  struct adhash *hp;
+  int key, n;
+  char *ips, *p;
+
+  ips = ip;
+  unget(getnb());
+
+  p = ip;
+  key = 0;
+  for (n = 0; ctype[*p & 0x007F] & LTR16; n++, p++) {
+    if (n < 3)
+      key |= (ccase[*p & 0x007F] & 0xFF) << (8 * n);
   }
-  if (ccase[*ptr & 0x007F] == ccase[*str & 0x007F]) {
-    ip = ptr;
-    return (1);
+
+  hp = NULL;
+  if ((n > 0) && (n < 3)) {
+    if ((*p == '\'') && !(ctype[p[1] & 0x007F] & LTR16)) {
+      if ((hp = adfind(key | ('\'' << (8 * n)))) != NULL)
+        p++;
+    }
+    if (hp == NULL)
+      hp = adfind(key);
+  }
+
+  if (hp == NULL) {
+    *spp = NULL;
+    ip = ips;
+    return (0);
+  }
+  *spp = hp->h_tbl;
+  ip = p;
+  return (hp->h_val);
+}
+
+/*
+ * adfind --- find a packed name in the hash index
+ */
+struct adhash *adfind(key)
+int key;
+{
+  struct adhash *hp;
+  int h;
+
+  h = ADHASH(key);
+  while ((hp = &adhtab[h])->h_key != 0) {
+    if (hp->h_key == key)
+      return (hp);
+    h = (h + 1) & (NADHASH - 1);
   }
+  return (NULL);
+}
 
-  if (!*str)
-    if (!(ctype[*ptr & 0x007F] & LTR16)) {
-      ip = ptr;
-      return (1);
+/*
+ * adinit --- build the hash index of the names in the
+ * R8, R8X, R16, R16X and CND tables.  The first table
+ * holding a name is its class, 'c' is an R8 register.
+ * Names already in the index are skipped, so adinit()
+ * may be called for each pass.
+ */
+VOID adinit() {
+  static struct adsym *tbl[] = {R8, R8X, R16, R16X, CND, NULL};
+  struct adsym **tp, *sp;
+  struct adhash *hp;
+  int h, key, n;
+  char *p;
+
+  for (tp = tbl; *tp != NULL; tp++) {
+    for (sp = *tp; sp->a_str[0] != 0; sp++) {
+      key = 0;
+      for (n = 0, p = sp->a_str; *p; n++, p++) {
+        key |= (ccase[*p & 0x007F] & 0xFF) << (8 * n);
+      }
+      h = ADHASH(key);
+      while ((hp = &adhtab[h])->h_key != 0 && hp->h_key != key) {
+        h = (h + 1) & (NADHASH - 1);
+      }
+      if (hp->h_key == 0) {
+        hp->h_key = key;
+        hp->h_tbl = *tp;
+        hp->h_val = sp->a_val;
+      }
     }
-  return (0);
+  }
 }
 
 /*
  * Registers
+ *
+ * The tables list the names of each class, adtok()
+ * returns the table of a name as its class.
  */
 
 struct adsym R8[] = {{"b", B | 0400}, {"c", C | 0400}, {"d", D | 0400},
@@ -185,6 +270,12 @@ struct adsym R16X[] = {{"af'", AF | 0400}, /* af' must be first !!! */
                        {"af", AF | 0400},
                        {"", 0000}};
 
+/*
+ * Hash index of the names
+ */
+
+struct adhash adhtab[NADHASH];
+
 /*
  * Conditional definitions
  */
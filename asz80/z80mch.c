@@ -546,7 +546,7 @@ struct mne *mp;
   clrexpr(&e2);
   op = (int)mp->m_valu;
   rf = mp->m_type;
-  if (!mchtyp && rf > S_CPU)
+  if (!mchtyp && rf > S_RELAX)
     rf = 0;
   switch (rf) {
 
@@ -911,7 +911,7 @@ struct mne *mp;
     }
     expr(&e2, 0);
     outab(op);
-    if (mchpcr(&e2)) {
+    if (mchpcr(&e2) && !rxdef) {
       v2 = (int)(e2.e_addr - dot.s_addr - 1);
       if ((v2 < -128) || (v2 > 127))
         aerr();
@@ -940,14 +940,17 @@ struct mne *mp;
       op |= (v1 & 0xFF) << 3;
       comma(1);
       expr(&e1, 0);
-      outab(op);
-      outrw(&e1, 0);
+      if ((v1 & 0xFF) <= 0x03) {
+        mchjp(op, &e1);
+      } else {
+        outab(op);
+        outrw(&e1, 0);
+      }
       break;
     }
     t1 = addr(&e1);
     if (t1 == S_USER) {
-      outab(0xC3);
-      outrw(&e1, 0);
+      mchjp(0xC3, &e1);
       break;
     }
     if ((e1.e_addr == 0) && (gixiy(t1) == S_IDHL)) {
@@ -964,6 +967,18 @@ struct mne *mp;
     lmode = SLIST;
     break;
 
+  case S_RELAX:
+    opcycles = OPCY_CPU;
+    if (more() && (absexpr() == 0)) {
+      rxmode = 0;
+    } else {
+      modep[1] = &mode[1];
+      rxmode = 1;
+      rxdef = 1;
+    }
+    lmode = SLIST;
+    break;
+
   case X_INH2:
     outab(0xED);
     outab(op);
@@ -1129,6 +1144,31 @@ int f;
   return (t1);
 }
 
+/*
+ * Jump output.  After a .relax directive, until a
+ * .relax 0 or the end of the source file, a jp or
+ * jp cc (cc = NZ, Z, NC or C) to a relocatable
+ * address in a relocatable area is marked with the
+ * R_JPX mode and output in a T line of its own, the
+ * linker may replace it with a jr.
+ */
+VOID mchjp(op, esp)
+int op;
+struct expr *esp;
+{
+  if (rxmode && (esp->e_flag || esp->e_base.e_ap != NULL) &&
+      ((dot.s_area->a_flag & A_ABS) != A_ABS)) {
+    outall();
+    rxadd();
+    outab(op);
+    outrwm(esp, R_JPX, 0);
+    outall();
+  } else {
+    outab(op);
+    outrw(esp, 0);
+  }
+}
+
 /*
  * IX and IY prebyte check
  */
@@ -1184,6 +1224,16 @@ VOID minit() {
    */
   hilo = 0;
 
+  /*
+   * Register Name Index
+   */
+  adinit();
+
+  /*
+   * Relaxable Jump Mode (.relax)
+   */
+  modep[1] = NULL;
+
   if (pass == 0) {
     mchtyp = X_Z80;
     sym[2].s_addr = X_Z80;
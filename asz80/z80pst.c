@@ -54,10 +54,15 @@ char mode0[32] = {/* R_NORM */
 
 /*
  * Additional Relocation Mode Definitions
+ *
+ *	#define		R_JPX	0100		Relaxable jp / jp cc
+ *
+ * The mode has no bit positioning, the linker
+ * shrinks the jumps assembled after a .relax
+ * directive.  A .relax 0 directive or the end
+ * of the source file ends the marking.
  */
 
-/* None Required */
-
 /*
  *     *m_def is a pointer to the bit relocation definition.
  *	m_flag indicates that bit position swapping is required.
@@ -72,7 +77,8 @@ char mode0[32] = {/* R_NORM */
  *		a_uint	m_sbits;	Source Bit Mask
  *	};
  */
-struct mode mode[1] = {{&mode0[0], 0, 0x0000FFFF, 0x0000FFFF}};
+struct mode mode[2] = {{&mode0[0], 0, 0x0000FFFF, 0x0000FFFF},
+                       {&mode0[0], 0, 0x0000FFFF, 0x0000FFFF}};
 
 /*
  * Array of Pointers to mode Structures
@@ -109,7 +115,8 @@ struct mne mne[] = {
     {NULL, ".title", S_HEADER, 0, O_TITLE},
     {NULL, ".sbttl", S_HEADER, 0, O_SBTTL},
     {NULL, ".module", S_MODUL, 0, 0},
-    {NULL, ".include", S_INCL, 0, 0},
+    {NULL, ".include", S_INCL, 0, O_INCL},
+    {NULL, ".incbin", S_INCL, 0, O_INCBIN},
     {NULL, ".area", S_AREA, 0, 0},
     {NULL, ".bank", S_BANK, 0, 0},
     {NULL, ".org", S_ORG, 0, 0},
@@ -233,6 +240,10 @@ struct mne mne[] = {
     {NULL, ".hd64", S_CPU, 0, X_HD64},
     {NULL, ".z180", S_CPU, 0, X_HD64},
 
+    /* Branch Relaxation */
+
+    {NULL, ".relax", S_RELAX, 0, 0},
+
     /* z80 */
 
     {NULL, "ld", S_LD, 0, 0x40},
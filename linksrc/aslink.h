@@ -52,6 +52,26 @@
  */
 #define SDCDB 1
 
+/*
+ * To include the parallel listing update (-uu)
+ * and the parallel pass 1 relocation set LKPAR
+ * non-zero, requires fork() and mmap()
+ *
+ * The parallel pass 1 relocation is enabled by
+ * the environment variable ASLINKPAR
+ *
+ * To read the .lst files of the listing update
+ * (-u) from a memory mapping set LKMMAP non-zero,
+ * requires mmap()
+ */
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#define LKPAR 1
+#define LKMMAP 1
+#else
+#define LKPAR 0
+#define LKMMAP 0
+#endif
+
 /*
  * The assembler requires certain variables to have
  * at least 32 bits to allow correct address processing.
@@ -111,6 +131,8 @@
                 LKRLOC4.C
                 LKLIBR.C
                 LKOUT.C
+                LKPAR.C
+                LKSTAT.C
         }
         $(STACK) = 2000
 */
@@ -200,10 +222,10 @@
 #define NHASH (1 << 6)    /* Buckets in hash table */
 #define HMASK (NHASH - 1) /* Hash mask */
 #define NLPP 60           /* Lines per page */
-#define NMAX 78           /* IXX/SXX/DBX Buffer Length */
-#define IXXMAXBYTES 32    /* NMAX > (2 * IXXMAXBYTES) */
-#define SXXMAXBYTES 32    /* NMAX > (2 * SXXMAXBYTES) */
-#define DBXMAXBYTES 64    /* NMAX > (  DBXMAXBYTES  ) */
+#define NMAX 256          /* IXX/SXX/DBX Buffer Length */
+#define IXXMAXBYTES 32    /* Default Data Bytes (-in, n <= 255) */
+#define SXXMAXBYTES 32    /* Default Data Bytes (-sn, n <= 252) */
+#define DBXMAXBYTES 64    /* Default Record Size (-tn, n <= NMAX) */
 #define FILSPC 80         /* File spec length */
 
 /*
@@ -450,6 +472,16 @@ extern int ASxxxx_VERSION;
 
 #define R4_NORM 0x0000 /* No Bit Positioning */
 
+/*
+ * Relocation Classes of relr4()
+ */
+
+#define R4C_GEN 0   /* PAGX and other modes */
+#define R4C_PLAIN 1 /* Byte / Word / 3-Byte / 4-Byte */
+#define R4C_PCR 2   /* PC relative */
+#define R4C_MSB 3   /* MSB of value */
+#define R4C_PAG 4   /* Page '0' / Page 'nnn' */
+
 /*
  *	The defined type 'a_uint' is used for all address and
  *	unsigned variable value calculations.  Its size is
@@ -498,6 +530,7 @@ struct head {
   struct bank **b_list;  /* Bank list */
   int h_nmode;           /* # of modes */
   struct mode **m_list;  /* Mode list */
+  int h_rmode;           /* Relaxable jump mode */
   char *m_id;            /* Module name */
 };
 
@@ -631,8 +664,19 @@ struct areax {
   a_uint a_addr;       /* Beginning address of section */
   a_uint a_size;       /* Size of the area in section */
   a_uint a_bndry;      /* Boundary for this A directive */
+  a_uint a_slot;       /* Incremental relink slot size */
+  int a_gc;            /* Area GC state */
+  struct lkgr *a_gref; /* Area GC references */
+  struct lkrx *a_rxp;  /* Relaxable jumps */
+  int a_nrx;           /* # of relaxable jumps */
 };
 
+/*
+ *	Area garbage collection states of an areax.
+ */
+#define GC_LIVE 1 /* referenced, kept */
+#define GC_DEAD 2 /* unreferenced, removed */
+
 /*
  *	A sym structure is created for every unique symbol
  *	referenced/defined while reading the REL files.  The
@@ -721,6 +765,39 @@ struct rerr {
   a_uint rval;   /* Area/Symbol offset value */
 };
 
+/*
+ *	The structure relent contains one R line entry
+ *	as decoded by relr().  The relocation function of
+ *	the REL file format relocates the T line data and
+ *	updates the entry for the error processing in relr().
+ */
+struct relent {
+  int e_mode;       /* Relocation mode */
+  int e_rtp;        /* Index into T data */
+  int e_rindex;     /* Area/Symbol relocation index */
+  a_uint e_reli;    /* Relocation initial value */
+  a_uint e_relv;    /* Relocation final value */
+  a_uint e_rtofst;  /* rtval[] index offset */
+  a_uint e_rtpofst; /* rtval[] index offset (initial) */
+};
+
+/*
+ *	The structure relfmt describes the parts of the
+ *	relocation which depend on the REL file version.
+ *	The T, R, P, and E lines of all versions are
+ *	processed by the same functions in lkrloc.c using
+ *	the relfmt structure selected by reloc().
+ */
+struct relfmt {
+  int f_vers;                       /* REL file version */
+  int f_area;                       /* Area mode of R and P lines */
+  int f_sym;                        /* Symbol reference mode bit */
+  int f_wlmsk;                      /* Area bytes per PC word mask */
+  int (*f_rent)(struct relent *rp); /* R line entry relocation */
+  char **f_errmsg;                  /* Relocation error messages */
+  char *f_pghdr;                    /* Paging error offset heading */
+};
+
 /*
  *	The structure lbpath is created for each library
  *	path specification input by the -k option.  The
@@ -787,6 +864,9 @@ struct lbname {
  *		and this file specification becomes filspc.
  *		(i.e. \...)
  *
+ *	The element f_nhead is the number of modules
+ *	loaded from the file.
+ *
  *	The lbpath structures are linked into a list
  *	using the next link element.
  */
@@ -796,6 +876,370 @@ struct lbfile {
   char *relfil;
   char *filspc;
   int f_obj;
+  int f_nhead;
+};
+
+/*
+ *	The lkpev structure saves the relocated data of
+ *	one lkulist() call for the parallel listing update.
+ *	The data is replayed into the pc, pcb, rtcnt, rtval[],
+ *	rtflg[], and rterr[] globals when the .rst file
+ *	is created.
+ */
+struct lkpev {
+  struct lkpev *e_next; /* next event */
+  struct head *e_hp;    /* module head structure */
+  a_uint e_pc;          /* relocated pc */
+  a_uint e_mask;        /* address mask */
+  char e_pcb;           /* bytes per pc word */
+  char e_abytes;        /* T line address bytes */
+  char e_radix;         /* listing radix */
+  char e_vers;          /* ASxxxx version */
+  char e_cnt;           /* rtcnt */
+  char e_val[NTXT];     /* relocated data bytes */
+  char e_flg[NTXT];     /* rtflg[] */
+  char e_err[NTXT];     /* rterr[] */
+};
+
+/*
+ *	Parallel pass 1 relocation modes of rlpar
+ */
+#define PR_NONE 0 /* Serial relocation */
+#define PR_WORK 1 /* Worker, save the relocation events */
+
+/*
+ *	Minimum number of .rel lines read in pass 0
+ *	for a parallel pass 1 relocation
+ */
+#define PRMIN 16384
+
+/*
+ *	Pass 1 worker event types
+ */
+#define PE_FILE 1 /* Next .rel file */
+#define PE_REL 2  /* Relocated R line */
+#define PE_PAGE 3 /* Paging error */
+#define PE_END 4  /* End of pass 1 */
+
+/*
+ *	The lkprr structure is an event saved by a pass 1
+ *	worker.  The event contains the linker state of the
+ *	current line and the relocated data of an R line or
+ *	the paging error of a P line.  A PE_REL event is
+ *	followed by r_nerr lkpre structures.
+ */
+struct lkprr {
+  int r_type;          /* event type */
+  struct head *r_hp;   /* current module */
+  int r_obj;           /* obj_flag */
+  int r_vers;          /* ASxxxx_VERSION */
+  int r_radix;         /* radix */
+  int r_hilo;          /* hilo */
+  int r_abytes;        /* a_bytes */
+  a_uint r_amask;      /* a_mask */
+  a_uint r_smask;      /* s_mask */
+  a_uint r_vmask;      /* v_mask */
+  a_uint r_pmask;      /* p_mask */
+  struct sdp r_sdp;    /* base page structure */
+  char *r_str;         /* paging error string */
+  int r_aindex;        /* R line area index */
+  a_uint r_pc;         /* relocated pc */
+  int r_pcb;           /* bytes per pc word */
+  int r_cnt;           /* rtcnt */
+  int r_nent;          /* relocation entries */
+  int r_nerr;          /* relocation errors */
+  a_uint r_val[NTXT];  /* rtval[] */
+  int r_flg[NTXT];     /* rtflg[] */
+  int r_err[NTXT];     /* rterr[] */
+};
+
+/*
+ *	The lkpre structure saves a relocation error
+ *	found by a pass 1 worker.
+ */
+struct lkpre {
+  struct rerr e_rerr; /* error information */
+  int e_err;          /* error code */
+};
+
+/*
+ *	Incremental relink (-mm).  The state of the link is
+ *	saved in the file (out)file[.ilk] and reused by the
+ *	next link with the same command.  LKIVER is changed
+ *	when the format of the file changes.
+ */
+#define LKIVER 2
+
+/*
+ *	The lkih structure contains the two 32-bit
+ *	halves of an incremental relink hash value.
+ */
+struct lkih {
+  unsigned INT32 h_a; /* FNV-1a hash */
+  unsigned INT32 h_b; /* shift-add-xor hash */
+};
+
+/*
+ *	The lkihdr structure is the start of the .ilk file.
+ *	It is followed by h_narea area layouts and h_nfile
+ *	.rel file states, the body of the file hashed in
+ *	h_body.
+ */
+struct lkihdr {
+  char h_id[8];       /* "ASlink" */
+  int h_ver;          /* LKIVER */
+  int h_size;         /* size of a_uint */
+  struct lkih h_cmd;  /* hash of the link command */
+  int h_narea;        /* number of areas */
+  int h_nfile;        /* number of .rel files */
+  struct lkih h_body; /* hash of the file body */
+};
+
+/*
+ *	The lkiev structure saves a relocated R line of a
+ *	.rel file for the incremental relink.  The event is
+ *	followed by i_cnt rtval[] values and i_cnt rtflg[]
+ *	bytes.
+ */
+struct lkiev {
+  int i_hn;        /* module number in the file */
+  int i_obj;       /* obj_flag */
+  int i_vers;      /* ASxxxx_VERSION */
+  int i_radix;     /* radix */
+  int i_hilo;      /* hilo */
+  int i_abytes;    /* a_bytes */
+  a_uint i_amask;  /* a_mask */
+  a_uint i_smask;  /* s_mask */
+  a_uint i_vmask;  /* v_mask */
+  int i_aindex;    /* R line area index */
+  a_uint i_pc;     /* relocated pc */
+  int i_pcb;       /* bytes per pc word */
+  int i_cnt;       /* rtcnt */
+  int i_nent;      /* relocation entries */
+};
+
+/*
+ *	The lkif structure contains the state of an input
+ *	.rel file: the hash of the file, the hash of the
+ *	addresses of the areas and the values of the symbols
+ *	of its modules, the page mask before and after its
+ *	pass 1, and its relocated R lines.  A file with the
+ *	same hashes as in the previous link is not relocated
+ *	again, the saved R lines are replayed.
+ */
+struct lkif {
+  struct lkif *f_ifp;  /* link to next file */
+  struct lfile *f_lfp; /* input file */
+  char *f_fid;         /* file specification */
+  struct lkih f_rel;   /* .rel file hash */
+  struct lkih f_env;   /* area address and symbol value hash */
+  int f_nhead;         /* number of modules */
+  struct head *f_hp;   /* first module */
+  struct head *f_hpl;  /* last module */
+  int f_rply;          /* replay the saved R lines */
+  a_uint f_pmin;       /* p_mask before pass 1 */
+  a_uint f_pmout;      /* p_mask after pass 1 */
+  char *f_buf;         /* saved lkiev events */
+  long f_len;          /* bytes used in f_buf */
+  long f_max;          /* size of f_buf */
+};
+
+/*
+ *	The lkia structure contains the layout of an area
+ *	in the previous link: the size of the slot of each
+ *	areax and the boundary offset of the areax within
+ *	its slot.
+ */
+struct lkia {
+  struct lkia *a_iap; /* link to next area */
+  char a_id[NCPS];    /* area name */
+  int a_flag;         /* area flags */
+  int a_nax;          /* number of areax */
+  a_uint *a_slot;     /* areax slot sizes */
+  a_uint *a_bofst;    /* areax boundary offsets */
+};
+
+/*
+ *	The lkgr structure is a reference of an areax, found
+ *	in its R and P lines, to a symbol or to an areax.
+ *	The references are followed by the area garbage
+ *	collection to find the areax sections to be kept.
+ */
+struct lkgr {
+  struct lkgr *r_rp;    /* link to next reference */
+  struct areax *r_axp;  /* referenced areax or NULL */
+  struct sym *r_sp;     /* referenced symbol or NULL */
+};
+
+/*
+ *	The lkgk structure contains an area or a symbol
+ *	kept by the area garbage collection (-b area or
+ *	-g symbol without an expression).
+ */
+struct lkgk {
+  struct lkgk *k_kp; /* link to next keep */
+  int k_area;        /* 1 = area, 0 = symbol */
+  char *k_id;        /* area or symbol name */
+};
+
+/*
+ *	The lkrx structure is a jp or jp cc instruction of
+ *	a module assembled for the branch relaxation.  The
+ *	jumps of an areax are linked in pass 0 and sorted
+ *	into an array by lkrelax().
+ */
+struct lkrx {
+  struct lkrx *x_xp;   /* link to next jump (pass 0) */
+  a_uint x_ofs;        /* offset of the opcode in the areax */
+  int x_op;            /* jp opcode */
+  struct sym *x_sp;    /* target symbol or NULL */
+  struct areax *x_axp; /* target areax or NULL */
+  a_uint x_val;        /* target offset or addend */
+  int x_state;         /* RX_LONG, RX_SHORT or RX_PIN */
+  int x_nsh;           /* jumps shrunk up to this one */
+};
+
+/*
+ *	Branch relaxation states of a jump.
+ */
+#define RX_LONG 0  /* jp */
+#define RX_SHORT 1 /* shrunk to jr */
+#define RX_PIN 2   /* jp, jr out of range */
+
+/*
+ *	SDCDB .cdb files are copied in blocks of NCDBBUF
+ *	bytes.  With -yy the type records already copied
+ *	are kept in NCDBHASH hash chains of cdbtyp structures
+ *	and a repeated type record is not copied again.
+ */
+#define NCDBBUF 32768           /* Copy buffer size */
+#define NCDBHASH (1 << 10)      /* Buckets in type hash table */
+#define CDBHMASK (NCDBHASH - 1) /* Type hash mask */
+
+struct cdbtyp {
+  struct cdbtyp *t_tp; /* next type in the hash chain */
+  int t_len;           /* record length */
+  char *t_rec;         /* record text */
+};
+
+/*
+ *	The lkplst structure links the saved lkulist()
+ *	events for each .rel file with a listing.
+ */
+struct lkplst {
+  struct lkplst *p_next; /* next listing */
+  char *p_fid;           /* .rel file specification */
+  int p_hlr;             /* .hlr file exists */
+  struct lkpev *p_ev;    /* first event */
+  struct lkpev *p_evl;   /* last event */
+};
+
+/*
+ *	The rseg structure contains one contiguous
+ *	segment of the relocated data for the binary
+ *	output formats (-r and -rr).  The segments of
+ *	an output file are linked in address order and
+ *	adjacent segments are merged.
+ */
+struct rseg {
+  struct rseg *r_rp; /* next segment */
+  a_uint r_addr;     /* segment byte address */
+  a_uint r_len;      /* segment length */
+  a_uint r_size;     /* allocated size of r_buf */
+  char *r_buf;       /* segment data */
+};
+
+/*
+ *	The rimg structure links the segments of the
+ *	binary image written to one output file.
+ */
+struct rimg {
+  struct rimg *i_ip;  /* next image */
+  FILE *i_fp;         /* output file handle */
+  struct rseg *i_rp;  /* first segment */
+  struct rseg *i_lrp; /* last segment written */
+};
+
+/*
+ *	Linker statistics phases, the elapsed time
+ *	is charged to the current phase.
+ */
+#define PH_OTHER 0  /* Not in a phase */
+#define PH_PARSE 1  /* Command parsing */
+#define PH_LOAD 2   /* Pass 0 loading */
+#define PH_SEARCH 3 /* Library search() */
+#define PH_AREA 4   /* Area/bank layout lnkarea() */
+#define PH_SYMDEF 5 /* Global definitions symdef() */
+#define PH_MAP 6    /* Map file */
+#define PH_RELOC 7  /* Pass 1 relocation */
+#define PH_OUTPUT 8 /* Output formatting */
+#define PH_LIST 9   /* -u listing updates */
+#define NPHASE 10
+
+/*
+ *	Linker statistics counters
+ */
+#define ST_LINES 0   /* .rel lines processed */
+#define ST_MODS 1    /* Modules loaded */
+#define ST_LBROUND 2 /* search() rounds */
+#define ST_LBOPEN 3  /* Library files opened */
+#define ST_LBLINE 4  /* Library lines scanned */
+#define ST_LBSYM 5   /* Symbols resolved */
+#define ST_TREC 6    /* T records */
+#define ST_RREC 7    /* R records */
+#define ST_BYTES 8   /* T record data bytes */
+#define ST_RELOC 9   /* Relocations */
+#define ST_RSYM 10   /* Symbol relocations */
+#define ST_RPLAIN 11 /* Plain relocations */
+#define ST_RMSB 12   /* MSB relocations */
+#define ST_RPCR 13   /* PC relative relocations */
+#define ST_RPAG 14   /* Paged relocations */
+#define ST_RPAGX 15  /* PAGX relocations */
+#define ST_RMERGE 16 /* Merge mode relocations */
+#define ST_RERR 17   /* Relocation errors */
+#define ST_OREC 18   /* Output data records */
+#define ST_OBYTES 19 /* Output data bytes */
+#define ST_LST 20    /* Listing lines updated */
+#define ST_IRPLY 21  /* Incremental relink files replayed */
+#define ST_GCAX 22   /* Areax sections removed */
+#define ST_GCBYTE 23 /* Bytes removed */
+#define ST_GCLIB 24  /* Library files not relocated */
+#define ST_RXJP 25   /* Relaxable jumps */
+#define ST_RXJR 26   /* Jumps relaxed to jr */
+#define ST_RXPASS 27 /* Relaxation layout passes */
+#define NSTCNT 28
+
+#define NSTRND 16 /* search() rounds reported */
+
+/*
+ *	The lkstat structure contains the time
+ *	spent in each phase, the counters, and
+ *	the symbols resolved in each search()
+ *	round (the last entry includes any
+ *	later rounds).
+ */
+struct lkstat {
+  double st_time[NPHASE];
+  long st_cnt[NSTCNT];
+  long st_rnd[NSTRND];
+};
+
+/*
+ *	The r4cls structure describes the relocation of
+ *	a version 4 R line entry with the mode byte used
+ *	as the table index.  The class selects the relr4()
+ *	handler and the masks, range check, error code,
+ *	and statistics counter are precomputed.
+ */
+struct r4cls {
+  char c_kind; /* Relocation class R4C_xxx */
+  char c_argb; /* Bytes in argument */
+  char c_chk;  /* R4_SGND / R4_USGN range check or 0 */
+  char c_off;  /* PCR offset from the argument */
+  char c_err;  /* PCR / PAG error code or 0 */
+  char c_stat; /* Statistics counter */
+  a_uint c_m;  /* Signed value mask */
+  a_uint c_n;  /* Unsigned value mask */
 };
 
 /*
@@ -948,6 +1392,12 @@ extern FILE *yfp; /*	SDCDB output file handle
 
 extern int oflag;  /*	Output file type flag
                     */
+extern int rfill;  /*	Binary output fill byte
+                    */
+extern int pkflag; /*	Packed output flag (-ii, -ss, -tt)
+                    */
+extern int rtlen;  /*	Data bytes per record (-in, -sn, -tn)
+                    */
 extern int o1flag; /*	Output legacy Intel Hex flag
                     *	Start address record type set to 1
                     */
@@ -956,6 +1406,7 @@ extern int objflg; /*	Linked file/library object output flag
 
 #if NOICE
 extern int jflag; /*	-j, enable NoICE Debug output
+                   *	-jj, sorted NoICE output
                    */
 #endif
 
@@ -964,11 +1415,14 @@ extern int mflag;  /*	Map output flag
 extern int m1flag; /*	Include linker generated
                     *	symbols in map file
                     */
+extern int mmflag; /*	-mm, incremental relink flag
+                    */
 extern int xflag;  /*	Map file radix type flag
                     */
 
 #if SDCDB
 extern int yflag; /*	-y, enable SDCC Debug output
+                   *	-yy, remove repeated type records
                    */
 #endif
 
@@ -978,8 +1432,15 @@ extern int uflag;              /*	Listing relocation flag
                                 */
 extern int wflag;              /*	Enable wide format listing
                                 */
+extern int aflag;              /*	-a, link statistics
+                                *	-aa, as JSON
+                                */
 extern int zflag;              /*	Enable symbol case sensitivity
                                 */
+extern int gcflag;             /*	Area garbage collection flag
+                                */
+extern int rxpass;             /*	Relaxation layout pass flag
+                                */
 extern int radix;              /*	current number conversion radix:
                                 *	2 (binary), 8 (octal), 10 (decimal),
                                 *	16 (hexadecimal)
@@ -994,6 +1455,8 @@ extern time_t curtim;          /*	pointer to the current time string
                                 */
 extern int pass;               /*	linker pass number
                                 */
+extern int rlpar;              /*	parallel pass 1 relocation mode
+                                */
 extern a_uint pc;              /*	current relocation address
                                 */
 extern int pcb;                /*	current bytes per pc word
@@ -1001,10 +1464,14 @@ extern int pcb;                /*	current bytes per pc word
 extern int rtcnt;              /*	count of elements in the
                                 *	rtval[] and rtflg[] arrays
                                 */
+extern int rtend;              /*	end of the rtval[] data read
+                                *	by the relocation
+                                */
 extern a_uint rtval[];         /*	data associated with relocation
                                 */
 extern int rtflg[];            /*	indicates if rtval[] value is
                                 *	to be sent to the output file.
+                                *	(2 == removed, listed blank)
                                 */
 extern int rterr[];            /*	indicates if rtval[] value should
                                 *	be flagged as a relocation error.
@@ -1060,6 +1527,8 @@ extern struct lbname *lbnhead; /*	pointer to the first
 extern struct lbfile *lbfhead; /*	pointer to the first
                                 *	library file structure
                                 */
+extern struct lkstat lkst;     /*	link statistics
+                                */
 
 /* C Library function definitions */
 /* for reference only
@@ -1099,6 +1568,7 @@ extern int main(int argc, char *argv[]);
 extern VOID map(void);
 extern int parse(void);
 extern VOID doparse(void);
+extern int rtopt(int c, int max);
 extern VOID setgbl(void);
 extern VOID usage(void);
 
@@ -1110,6 +1580,7 @@ extern VOID getfid(char *str, int c);
 extern VOID getid(char *id, int c);
 extern int getmap(int d);
 extern int getnb(void);
+extern VOID lkuopen(char *fid);
 extern int more(void);
 extern int nxtline(void);
 extern VOID skip(int c);
@@ -1171,10 +1642,17 @@ extern VOID hlrelist(void);
 extern VOID hlrclist(a_uint cpc, int v);
 extern VOID setgh(void);
 extern VOID lsterr(int err);
+extern VOID lstmap(void);
+extern VOID lstput(void);
+extern VOID lstrest(void);
 
 /* lknoice.c */
 extern VOID NoICEfopen(void);
 extern VOID NoICEmagic(void);
+extern VOID NoICEsave(int type, char *name, unsigned int line, a_uint value,
+                      struct bank *yp);
+extern int NoICEcmp(const VOID *p1, const VOID *p2);
+extern VOID NoICEflush(void);
 extern VOID DefineNoICE(char *name, a_uint value, struct bank *yp);
 extern VOID DefineGlobal(char *name, a_uint value, struct bank *yp);
 extern VOID DefineScoped(char *name, a_uint value, struct bank *yp);
@@ -1188,6 +1666,7 @@ extern VOID PagedAddress(a_uint value, struct bank *yp);
 /* lksccdb.c */
 extern VOID SDCDBfopen(void);
 extern VOID SDCDBcopy(char *str);
+extern int SDCDBtype(char *rec, int len);
 extern VOID DefineSDCDB(char *name, a_uint value);
 
 /* lkrloc.c */
@@ -1195,49 +1674,47 @@ extern a_uint adb_1b(a_uint v, int i);
 extern a_uint adb_2b(a_uint v, int i);
 extern a_uint adb_3b(a_uint v, int i);
 extern a_uint adb_4b(a_uint v, int i);
+extern a_uint adb_byte(int p, a_uint v, int i);
+extern a_uint adb_sel(int p, a_uint v, int i);
 extern a_uint adb_xb(a_uint v, int i);
 extern a_uint adw_xb(int x, a_uint v, int i);
+extern VOID errdmp(FILE *fptr, char *str);
+extern VOID erpdmp(FILE *fptr, char *str);
 extern a_uint evword(void);
-extern VOID prntval(FILE *fptr, a_uint v);
-extern VOID reloc(int c);
-
-/* lkrloc3.c */
-extern a_uint adb_hi(a_uint v, int i);
-extern a_uint adb_lo(a_uint v, int i);
-extern char *errmsg3[];
-extern VOID errdmp3(FILE *fptr, char *str);
-extern VOID erpdmp3(FILE *fptr, char *str);
-extern VOID rele3(void);
-extern VOID reloc3(int c);
-extern VOID relt3(void);
-extern VOID relr3(void);
-extern VOID relp3(void);
-extern VOID relerr3(char *str);
-extern VOID relerp3(char *str);
-
-/* lkrloc4.c */
-extern a_uint adb_byte(int p, a_uint v, int i);
-extern char *errmsg4[];
-extern VOID errdmp4(FILE *fptr, char *str);
-extern VOID erpdmp4(FILE *fptr, char *str);
 extern a_uint gtb_1b(int i);
 extern a_uint gtb_2b(int i);
 extern a_uint gtb_3b(int i);
 extern a_uint gtb_4b(int i);
 extern a_uint gtb_xb(int i);
-extern a_uint lkmerge(a_uint val, int r, a_uint v);
+extern VOID prntval(FILE *fptr, a_uint v);
 extern a_uint ptb_1b(a_uint v, int i);
 extern a_uint ptb_2b(a_uint v, int i);
 extern a_uint ptb_3b(a_uint v, int i);
 extern a_uint ptb_4b(a_uint v, int i);
 extern a_uint ptb_xb(a_uint v, int i);
-extern VOID rele4(void);
-extern VOID reloc4(int c);
-extern VOID relt4(void);
-extern VOID relr4(void);
-extern VOID relp4(void);
-extern VOID relerr4(char *str);
-extern VOID relerp4(char *str);
+extern VOID rele(void);
+extern VOID relerr(char *str);
+extern VOID relerp(char *str);
+extern VOID relfsel(void);
+extern VOID reloc(int c);
+extern VOID relofp(struct areax *axp);
+extern VOID relout(int n);
+extern VOID relp(void);
+extern VOID relpply(char *str);
+extern VOID relr(void);
+extern VOID relref(int c);
+extern VOID relrply(int aindex, int n);
+extern VOID relt(void);
+
+/* lkrloc3.c */
+extern char *errmsg3[];
+extern int relr3(struct relent *rp);
+
+/* lkrloc4.c */
+extern char *errmsg4[];
+extern a_uint lkmerge(a_uint val, int r, a_uint v);
+extern int relr4(struct relent *rp);
+extern VOID r4class(void);
 
 /* lklibr.c */
 extern VOID addfile(char *path, char *libfil);
@@ -1248,6 +1725,63 @@ extern VOID library(void);
 extern VOID loadfile(char *filspc);
 extern VOID search(void);
 
+/* lkpar.c */
+extern int lkpncpu(void);
+extern VOID lkpopen(char *fid);
+extern VOID lkprec(int i);
+extern int lkprel(void);
+extern VOID lkprerp(char *str);
+extern VOID lkprerr(int error);
+extern VOID lkprev(struct lkprr *rp, int type);
+extern VOID lkprfil(void);
+extern int lkprnxt(void);
+extern int lkprown(void);
+extern VOID lkprply(void);
+extern VOID lkprput(int aindex, int n);
+extern VOID lkprun(struct lkplst *lp);
+extern VOID lkprwk(int w, long *cp);
+extern VOID lkpupd(void);
+
+/* lkgc.c */
+extern VOID lkgadd(struct areax *axp, struct areax *rap, struct sym *rsp);
+extern VOID lkgc(void);
+extern VOID lkgkeep(int area);
+extern VOID lkgpush(struct areax *axp);
+extern int lkgskip(struct lbfile *lbfh);
+
+/* lkrelax.c */
+extern VOID lkradd(struct areax *axp, a_uint ofs, int op, struct sym *rsp,
+                   struct areax *rap, a_uint val);
+extern a_uint lkrbef(struct areax *axp, a_uint ofs);
+extern int lkrcmp(const VOID *p1, const VOID *p2);
+extern VOID lkrelax(void);
+extern VOID lkrjr(struct areax *axp, a_uint rtbase);
+extern a_uint lkrval(struct lkrx *xp);
+
+/* lkincr.c */
+extern int lkichk(struct lkif *ifp, struct head *thp);
+extern VOID lkiclose(void);
+extern VOID lkicmd(char *str);
+extern VOID lkienv(void);
+extern VOID lkihbgn(struct lkih *hp);
+extern VOID lkihstr(struct lkih *hp, char *bp, int n);
+extern VOID lkiline(char *str);
+extern VOID lkiload(void);
+extern int lkiopen(struct lfile *lfp);
+extern VOID lkipin(void);
+extern VOID lkiput(struct lkif *ifp, char *bp, int n);
+extern int lkird(FILE *fp, VOID *bp, int n);
+extern VOID lkirec(int aindex, int n);
+extern int lkirply(struct lkif *ifp);
+extern VOID lkisave(void);
+extern VOID lkiwr(FILE *fp, VOID *bp, int n);
+
+/* lkstat.c */
+extern VOID stinit(void);
+extern VOID stlist(FILE *fp);
+extern int stphase(int ph);
+extern double sttime(void);
+
 /* lkout.c */
 extern VOID lkout(int i);
 extern VOID lkflush(void);
@@ -1257,6 +1791,17 @@ extern VOID sxx(int i);
 extern VOID sflush(void);
 extern VOID dbx(int i);
 extern VOID dflush(void);
+extern VOID rxx(int i);
+extern VOID rstore(a_uint addr, char *p, int n);
+extern VOID rwrite(void);
+extern VOID rpack(void);
+extern struct rimg *rfind(void);
+extern int rtlim(void);
+extern int rtmax(void);
+extern VOID recbgn(char *mark);
+extern VOID recput(a_uint v, int n);
+extern VOID recdat(char *p, int n);
+extern VOID recend(int ck);
 
 #else
 
@@ -1277,6 +1822,7 @@ extern int main();
 extern VOID map();
 extern int parse();
 extern VOID doparse();
+extern int rtopt();
 extern VOID setgbl();
 extern VOID usage();
 
@@ -1288,6 +1834,7 @@ extern VOID getfid();
 extern VOID getid();
 extern int getmap();
 extern int getnb();
+extern VOID lkuopen();
 extern int more();
 extern int nxtline();
 extern VOID skip();
@@ -1349,10 +1896,16 @@ extern VOID hlrelist();
 extern VOID hlrclist();
 extern VOID setgh();
 extern VOID lsterr();
+extern VOID lstmap();
+extern VOID lstput();
+extern VOID lstrest();
 
 /* lknoice.c */
 extern VOID NoICEfopen();
 extern VOID NoICEmagic();
+extern VOID NoICEsave();
+extern int NoICEcmp();
+extern VOID NoICEflush();
 extern VOID DefineNoICE();
 extern VOID DefineGlobal();
 extern VOID DefineScoped();
@@ -1366,6 +1919,7 @@ extern VOID PagedAddress();
 /* lksdcdb.c */
 extern VOID SDCDBfopen();
 extern VOID SDCDBcopy();
+extern int SDCDBtype();
 extern VOID DefineSDCDB();
 
 /* lkrloc.c */
@@ -1373,49 +1927,47 @@ extern a_uint adb_1b();
 extern a_uint adb_2b();
 extern a_uint adb_3b();
 extern a_uint adb_4b();
+extern a_uint adb_byte();
+extern a_uint adb_sel();
 extern a_uint adb_xb();
 extern a_uint adw_xb();
+extern VOID errdmp();
+extern VOID erpdmp();
 extern a_uint evword();
-extern VOID prntval();
-extern VOID reloc();
-
-/* lkrloc3.c */
-extern a_uint adb_hi();
-extern a_uint adb_lo();
-extern char *errmsg3[];
-extern VOID errdmp3();
-extern VOID erpdmp3();
-extern VOID rele3();
-extern VOID reloc3();
-extern VOID relt3();
-extern VOID relr3();
-extern VOID relp3();
-extern VOID relerr3();
-extern VOID relerp3(c);
-
-/* lkrloc4.c */
-extern a_uint adb_byte();
-extern char *errmsg4[];
-extern VOID errdmp4();
-extern VOID erpdmp4();
 extern a_uint gtb_1b();
 extern a_uint gtb_2b();
 extern a_uint gtb_3b();
 extern a_uint gtb_4b();
 extern a_uint gtb_xb();
-extern int lkmerge();
+extern VOID prntval();
 extern a_uint ptb_1b();
 extern a_uint ptb_2b();
 extern a_uint ptb_3b();
 extern a_uint ptb_4b();
 extern a_uint ptb_xb();
-extern VOID rele4();
-extern VOID reloc4();
-extern VOID relt4(v);
-extern VOID relr4();
-extern VOID relp4();
-extern VOID relerr4();
-extern VOID relerp4();
+extern VOID rele();
+extern VOID relerr();
+extern VOID relerp();
+extern VOID relfsel();
+extern VOID reloc();
+extern VOID relofp();
+extern VOID relout();
+extern VOID relp();
+extern VOID relpply();
+extern VOID relr();
+extern VOID relref();
+extern VOID relrply();
+extern VOID relt();
+
+/* lkrloc3.c */
+extern char *errmsg3[];
+extern int relr3();
+
+/* lkrloc4.c */
+extern char *errmsg4[];
+extern a_uint lkmerge();
+extern int relr4();
+extern VOID r4class();
 
 /* lklibr.c */
 extern VOID addfile();
@@ -1426,6 +1978,62 @@ extern VOID library();
 extern VOID loadfile();
 extern VOID search();
 
+/* lkpar.c */
+extern int lkpncpu();
+extern VOID lkpopen();
+extern VOID lkprec();
+extern int lkprel();
+extern VOID lkprerp();
+extern VOID lkprerr();
+extern VOID lkprev();
+extern VOID lkprfil();
+extern int lkprnxt();
+extern int lkprown();
+extern VOID lkprply();
+extern VOID lkprput();
+extern VOID lkprun();
+extern VOID lkprwk();
+extern VOID lkpupd();
+
+/* lkgc.c */
+extern VOID lkgadd();
+extern VOID lkgc();
+extern VOID lkgkeep();
+extern VOID lkgpush();
+extern int lkgskip();
+
+/* lkrelax.c */
+extern VOID lkradd();
+extern a_uint lkrbef();
+extern int lkrcmp();
+extern VOID lkrelax();
+extern VOID lkrjr();
+extern a_uint lkrval();
+
+/* lkincr.c */
+extern int lkichk();
+extern VOID lkiclose();
+extern VOID lkicmd();
+extern VOID lkienv();
+extern VOID lkihbgn();
+extern VOID lkihstr();
+extern VOID lkiline();
+extern VOID lkiload();
+extern int lkiopen();
+extern VOID lkipin();
+extern VOID lkiput();
+extern int lkird();
+extern VOID lkirec();
+extern int lkirply();
+extern VOID lkisave();
+extern VOID lkiwr();
+
+/* lkstat.c */
+extern VOID stinit();
+extern VOID stlist();
+extern int stphase();
+extern double sttime();
+
 /* lkout.c */
 extern VOID lkout();
 extern VOID lkflush();
@@ -1435,5 +2043,16 @@ extern VOID sxx();
 extern VOID sflush();
 extern VOID dbx();
 extern VOID dflush();
+extern VOID rxx();
+extern VOID rstore();
+extern VOID rwrite();
+extern VOID rpack();
+extern struct rimg *rfind();
+extern int rtlim();
+extern int rtmax();
+extern VOID recbgn();
+extern VOID recput();
+extern VOID recdat();
+extern VOID recend();
 
 #endif
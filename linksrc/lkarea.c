@@ -483,19 +483,24 @@ VOID lnkarea() {
  *	function.  A symbol is created for each areax with the
  *	form 'b_<areaname>_n' where n is a counter of the areax
  *	structures.  The symbol is the boundry modulus associated
- *	with this areax entry.
+ *	with this areax entry.  An areax with a slot size kept
+ *	by the -mm incremental relink allocates the slot.  The
+ *	paging errors are not reported in the layout passes of
+ *	the branch relaxation.
  *
  *	local variables:
  *		a_uint	size		size of area
  *		a_uint	addr		address of area
  *		areax *	taxp		pointer to an areax structure
  *		a_uint	bofst		boundary offset
+ *		a_uint	slot		allocated areax size
  *		a_uint	i		segment number
  *		char	temp[]		symbol string
  *		struct sym *sp		pointer to a symbol structure
  *
  *	global variables:
  *		int	lkerr		error flag
+ *		int	rxpass		relaxation layout pass flag
  *
  *	functions called:
  *		int	fprintf()	c_library
@@ -510,7 +515,7 @@ VOID lnkarea() {
 VOID lnksect(tap)
 struct area *tap;
 {
-  a_uint size, addr;
+  a_uint size, addr, slot;
   struct areax *taxp;
   a_uint bofst, i;
   char temp[NCPS + 2];
@@ -518,7 +523,7 @@ struct area *tap;
 
   size = 0;
   addr = tap->a_addr;
-  if (((tap->a_flag & A4_PAG) == A4_PAG) && (addr & 0xFF)) {
+  if (((tap->a_flag & A4_PAG) == A4_PAG) && (addr & 0xFF) && !rxpass) {
     fprintf(stderr, "\n?ASlink-Warning-Paged Area %s Boundary Error\n",
             tap->a_id);
     lkerr++;
@@ -534,19 +539,20 @@ struct area *tap;
     }
     taxp->a_size += bofst;
     taxp->a_addr = addr + bofst;
+    slot = (taxp->a_slot > taxp->a_size) ? taxp->a_slot : taxp->a_size;
     if ((tap->a_flag & A4_OVR) == A4_OVR) {
       /*
        * Overlayed sections
        */
-      if (taxp->a_size > size) {
-        size = taxp->a_size;
+      if (slot > size) {
+        size = slot;
       }
     } else {
       /*
        * Concatenated sections
        */
-      addr += taxp->a_size;
-      size += taxp->a_size;
+      addr += slot;
+      size += slot;
     }
     /*
      * Create symbols called:
@@ -570,7 +576,7 @@ struct area *tap;
     }
   }
   tap->a_size = size;
-  if (((tap->a_flag & A4_PAG) == A4_PAG) && (size > 256)) {
+  if (((tap->a_flag & A4_PAG) == A4_PAG) && (size > 256) && !rxpass) {
     fprintf(stderr, "\n?ASlink-Warning-Paged Area %s Length Error\n",
             tap->a_id);
     lkerr++;
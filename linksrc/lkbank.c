@@ -562,6 +562,10 @@ VOID lkfopen() {
             break;
           }
           fp = afile(bp->b_fspec, frmt, 3);
+        } else if (oflag == 4) {
+          fp = afile(bp->b_fspec, "img", 3);
+        } else if (oflag == 5) {
+          fp = afile(bp->b_fspec, "seg", 3);
         }
         if (fp != stderr) {
           if (fp == NULL) {
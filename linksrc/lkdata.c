@@ -62,6 +62,12 @@ char rb[NINPUT];     /*	LST file text line being
                       */
 int oflag;           /*	Output file type flag
                       */
+int rfill = 0xFF;    /*	Binary output fill byte
+                      */
+int pkflag;          /*	Packed output flag (-ii, -ss, -tt)
+                      */
+int rtlen;           /*	Data bytes per record (-in, -sn, -tn)
+                      */
 int o1flag;          /*	Legacy Intel Hex flag
                       *	Start address record type set to 1
                       */
@@ -83,6 +89,8 @@ int mflag;           /*	Map output flag
 int m1flag;          /*	Include linker generated
                       *	symbols in map file
                       */
+int mmflag;          /*	-mm, incremental relink flag
+                      */
 int xflag;           /*	Map file radix type flag
                       */
 int pflag;           /*	print linker command file flag
@@ -91,8 +99,15 @@ int uflag;           /*	Listing relocation flag
                       */
 int wflag;           /*	Enable wide format listing
                       */
+int aflag;           /*	-a, link statistics
+                      *	-aa, as JSON
+                      */
 int zflag;           /*	Enable symbol case sensitivity
                       */
+int gcflag;          /*	Area garbage collection flag
+                      */
+int rxpass;          /*	Relaxation layout pass flag
+                      */
 int radix;           /*	current number conversion radix:
                       *	2 (binary), 8 (octal), 10 (decimal),
                       *	16 (hexadecimal)
@@ -107,6 +122,8 @@ time_t curtim;       /*	pointer to the current time string
                       */
 int pass;            /*	linker pass number
                       */
+int rlpar;           /*	parallel pass 1 relocation mode
+                      */
 a_uint pc;           /*	current relocation address
                       */
 int pcb;             /*	current bytes per pc word
@@ -114,10 +131,14 @@ int pcb;             /*	current bytes per pc word
 int rtcnt;           /*	count of elements in the
                       *	rtval[] and rtflg[] arrays
                       */
+int rtend;           /*	end of the rtval[] data read
+                      *	by the relocation
+                      */
 a_uint rtval[NTXT];  /*	data associated with relocation
                       */
 int rtflg[NTXT];     /*	indicates if rtval[] value is
                       *	to be sent to the output file.
+                      *	(2 == removed, listed blank)
                       */
 int rterr[NTXT];     /*	indicates if rtval[] value should
                       *	be flagged as a relocation error.
@@ -574,6 +595,9 @@ struct lbfile *lbfhead; /*	pointer to the first
                          *	library file structure
                          */
 
+struct lkstat lkst; /*	link statistics
+                     */
+
 /*
  *	array of character types, one per
  *	ASCII character
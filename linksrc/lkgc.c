@@ -0,0 +1,388 @@
+/* lkgc.c */
+
+/*
+ *  Copyright (C) 1989-2017  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include "aslink.h"
+
+/*)Module	lkgc.c
+ *
+ *	The module lkgc.c contains the functions of the area
+ *	garbage collection.  The collection is enabled by a
+ *	-bb area or -gg symbol option, which keeps the area
+ *	or the areax defining the symbol.
+ *
+ *	In pass 0 the R and P lines of each areax are scanned
+ *	for the symbols and areas they reference.  Before the
+ *	area addresses are linked the areax sections reached
+ *	from the absolute areas, the areas placed by a -b
+ *	option, the kept areas and symbols and the start
+ *	address symbol .__.END. are marked.  Every other
+ *	areax is removed: its size is set to zero, its
+ *	symbols are not listed in the map and its R lines
+ *	are not relocated in pass 1.  A library file whose
+ *	areax sections were all removed is not read in
+ *	pass 1.
+ *
+ *	lkgc.c contains the following functions:
+ *		VOID	lkgadd(axp, rap, rsp)
+ *		VOID	lkgc()
+ *		VOID	lkgkeep(area)
+ *		VOID	lkgpush(axp)
+ *		int	lkgskip(lbfh)
+ *
+ *	lkgc.c contains the following local variables:
+ *		struct lkgk *	lkgkp	first kept area or symbol
+ *		struct lkgk *	lkgkl	last kept area or symbol
+ *		struct areax **	lkgstk	areax sections to be scanned
+ *		int	lkgsp		number of areax to be scanned
+ */
+
+static struct lkgk *lkgkp;
+static struct lkgk *lkgkl;
+static struct areax **lkgstk;
+static int lkgsp;
+
+/*)Function	VOID	lkgkeep(area)
+ *
+ *		int	area		1 = area, 0 = symbol
+ *
+ *	The function lkgkeep() is called by parse() for a
+ *	-bb or -gg option.  The area or symbol name is saved
+ *	and the area garbage collection is enabled.
+ *
+ *	local variables:
+ *		char	id[]		area or symbol name
+ *		struct lkgk *	kp	pointer to a keep structure
+ *
+ *	global variables:
+ *		int	gcflag		Area garbage collection flag
+ *		struct lkgk *	lkgkp	first kept area or symbol
+ *		struct lkgk *	lkgkl	last kept area or symbol
+ *
+ *	functions called:
+ *		VOID	getid()		lklex.c
+ *		VOID *	new()		lksym.c
+ *		char *	strsto()	lksym.c
+ *
+ *	side effects:
+ *		The keep structure is linked and gcflag is set.
+ */
+
+VOID lkgkeep(area)
+int area;
+{
+  char id[NCPS];
+  struct lkgk *kp;
+
+  getid(id, -1);
+  kp = (struct lkgk *)new (sizeof(struct lkgk));
+  kp->k_area = area;
+  kp->k_id = strsto(id);
+  if (lkgkl == NULL) {
+    lkgkp = kp;
+  } else {
+    lkgkl->k_kp = kp;
+  }
+  lkgkl = kp;
+  gcflag = 1;
+}
+
+/*)Function	VOID	lkgadd(axp, rap, rsp)
+ *
+ *		areax *	axp		areax of the R or P line
+ *		areax *	rap		referenced areax or NULL
+ *		sym *	rsp		referenced symbol or NULL
+ *
+ *	The function lkgadd() is called by relref() for each
+ *	symbol or area referenced by a R or P line read in
+ *	pass 0 and links the reference to the areax of the
+ *	line.  A reference of the areax to itself or one
+ *	repeating the last reference is not linked.
+ *
+ *	local variables:
+ *		struct lkgr *	rp	pointer to a reference
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID *	new()		lksym.c
+ *
+ *	side effects:
+ *		The references of the areax are updated.
+ */
+
+VOID lkgadd(axp, rap, rsp)
+struct areax *axp;
+struct areax *rap;
+struct sym *rsp;
+{
+  struct lkgr *rp;
+
+  if ((axp == NULL) || (rap == axp))
+    return;
+  rp = axp->a_gref;
+  if ((rp != NULL) && (rp->r_axp == rap) && (rp->r_sp == rsp))
+    return;
+  rp = (struct lkgr *)new (sizeof(struct lkgr));
+  rp->r_axp = rap;
+  rp->r_sp = rsp;
+  rp->r_rp = axp->a_gref;
+  axp->a_gref = rp;
+}
+
+/*)Function	VOID	lkgpush(axp)
+ *
+ *		areax *	axp		pointer to an areax structure
+ *
+ *	The function lkgpush() marks an areax to be kept and
+ *	saves it for the scan of its references.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct areax **	lkgstk	areax sections to be scanned
+ *		int	lkgsp		number of areax to be scanned
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The areax is marked GC_LIVE.
+ */
+
+VOID lkgpush(axp)
+struct areax *axp;
+{
+  if ((axp != NULL) && (axp->a_gc != GC_LIVE)) {
+    axp->a_gc = GC_LIVE;
+    lkgstk[lkgsp++] = axp;
+  }
+}
+
+/*)Function	VOID	lkgc()
+ *
+ *	The function lkgc() is called before lnkarea() and
+ *	removes the areax sections which are not referenced.
+ *	The absolute areas, the areas with a -b base address,
+ *	the kept areas, and the areax sections defining the
+ *	kept symbols and the start address symbol .__.END.
+ *	are marked first.  The references of each marked
+ *	areax then mark the areax sections they reach.  Each
+ *	areax which is not marked is removed, its size and
+ *	boundary are cleared.  The symbols of a removed
+ *	areax are flagged to be left out of the map.
+ *
+ *	local variables:
+ *		area *	tap		pointer to an area structure
+ *		areax *	taxp		pointer to an areax structure
+ *		struct lkgk *	kp	pointer to a keep structure
+ *		struct lkgr *	rp	pointer to a reference
+ *		sym *	sp		pointer to a symbol structure
+ *		int	i		loop counter
+ *		int	n		number of areax
+ *
+ *	global variables:
+ *		char	*_abs_		absolute area name
+ *		area	*areap		The pointer to the first
+ *				 	area structure of a linked list
+ *		int	gcflag		Area garbage collection flag
+ *		struct lkgk *	lkgkp	first kept area or symbol
+ *		struct lkstat	lkst	link statistics
+ *		sym *symhash[NHASH] 	array of pointers to NHASH
+ *				      	linked symbol lists
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		VOID	lkgpush()	lkgc.c
+ *		sym *	lkpsym()	lksym.c
+ *		VOID *	new()		lksym.c
+ *		int	symeq()		lksym.c
+ *
+ *	side effects:
+ *		The unreferenced areax sections are removed.
+ */
+
+VOID lkgc() {
+  struct area *tap;
+  struct areax *taxp;
+  struct lkgk *kp;
+  struct lkgr *rp;
+  struct sym *sp;
+  int i, n;
+
+  if (gcflag == 0)
+    return;
+
+  for (n = 0, tap = areap; tap != NULL; tap = tap->a_ap) {
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      n += 1;
+    }
+  }
+  lkgstk = (struct areax **)new ((n + 1) * sizeof(struct areax *));
+  lkgsp = 0;
+
+  /*
+   * Absolute areas and areas placed by -b
+   */
+  for (tap = areap; tap != NULL; tap = tap->a_ap) {
+    if (((tap->a_flag & A4_ABS) == A4_ABS) || symeq(tap->a_id, _abs_, 1) ||
+        tap->a_bset) {
+      for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+        lkgpush(taxp);
+      }
+    }
+  }
+
+  /*
+   * Kept areas and symbols
+   */
+  for (kp = lkgkp; kp != NULL; kp = kp->k_kp) {
+    if (kp->k_area) {
+      for (tap = areap; tap != NULL; tap = tap->a_ap) {
+        if (symeq(kp->k_id, tap->a_id, 1))
+          break;
+      }
+      if (tap == NULL) {
+        fprintf(stderr, "\n?ASlink-Warning-Kept area %s not found\n",
+                kp->k_id);
+        continue;
+      }
+      for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+        lkgpush(taxp);
+      }
+    } else {
+      if ((sp = lkpsym(kp->k_id, 0)) == NULL) {
+        fprintf(stderr, "\n?ASlink-Warning-Kept symbol %s not found\n",
+                kp->k_id);
+        continue;
+      }
+      lkgpush(sp->s_axp);
+    }
+  }
+
+  /*
+   * Start address
+   */
+  if ((sp = lkpsym(".__.END.", 0)) != NULL) {
+    lkgpush(sp->s_axp);
+  }
+
+  /*
+   * Follow the references
+   */
+  while (lkgsp > 0) {
+    taxp = lkgstk[--lkgsp];
+    for (rp = taxp->a_gref; rp != NULL; rp = rp->r_rp) {
+      if (rp->r_sp != NULL) {
+        lkgpush(rp->r_sp->s_axp);
+      } else {
+        lkgpush(rp->r_axp);
+      }
+    }
+  }
+
+  /*
+   * Remove the unreferenced sections
+   */
+  for (tap = areap; tap != NULL; tap = tap->a_ap) {
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      if (taxp->a_gc != GC_LIVE) {
+        taxp->a_gc = GC_DEAD;
+        if (taxp->a_size != 0) {
+          lkst.st_cnt[ST_GCAX] += 1;
+          lkst.st_cnt[ST_GCBYTE] += taxp->a_size;
+        }
+        taxp->a_size = 0;
+        taxp->a_bndry = 0;
+      }
+    }
+  }
+  for (i = 0; i < NHASH; i++) {
+    for (sp = symhash[i]; sp != NULL; sp = sp->s_sp) {
+      if ((sp->s_axp != NULL) && (sp->s_axp->a_gc == GC_DEAD)) {
+        sp->s_flag = 1;
+      }
+    }
+  }
+}
+
+/*)Function	int	lkgskip(lbfh)
+ *
+ *		lbfile *	lbfh	pointer to a library file
+ *
+ *	The function lkgskip() is called by library() in
+ *	pass 1.  A library file is not read when the area
+ *	garbage collection removed all its areax sections
+ *	with data, the current module is moved past the
+ *	modules of the file.
+ *
+ *	lkgskip() returns a (1) if the file must not be
+ *	read else a (0).
+ *
+ *	local variables:
+ *		head *	thp		pointer to a head structure
+ *		areax *	taxp		pointer to an areax structure
+ *		int	i		loop counter
+ *		int	j		loop counter
+ *
+ *	global variables:
+ *		int	gcflag		Area garbage collection flag
+ *		head	*headp		The pointer to the first
+ *				 	head structure of a linked list
+ *		head	*hp		pointer to the current head structure
+ *		struct lkstat	lkst	link statistics
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The current module may be changed.
+ */
+
+int lkgskip(lbfh)
+struct lbfile *lbfh;
+{
+  struct head *thp;
+  struct areax *taxp;
+  int i, j;
+
+  if ((gcflag == 0) || (lbfh->f_nhead == 0))
+    return (0);
+
+  thp = hp;
+  for (i = 0; i < lbfh->f_nhead; i++) {
+    thp = (thp == NULL) ? headp : thp->h_hp;
+    if (thp == NULL)
+      return (0);
+    for (j = 0; j < thp->h_narea; j++) {
+      taxp = thp->a_list[j];
+      if ((taxp != NULL) && (taxp->a_gc != GC_DEAD) && (taxp->a_size != 0))
+        return (0);
+    }
+  }
+  hp = thp;
+  lkst.st_cnt[ST_GCLIB] += 1;
+  return (1);
+}
@@ -77,6 +77,8 @@
  *		of global symbols, number of banks and number of
  *		merge modes are loaded into the structure.  The
  *		area, bank, symbol, and mode structure lists are created.
+ *		The merge mode of the jumps to be relaxed is loaded
+ *		for a module assembled for the branch relaxation.
  *		The default area "_abs_" is created when the first
  *		head structure is created and an areax structure is
  *		created for every head structure called.
@@ -150,7 +152,13 @@ VOID newhead() {
             hp->h_nmode = i;
             if (i)
               hp->m_list = (struct mode **)new (i * sizeof(struct mode *));
-          }
+          } else
+            /*
+             * Relaxable jump mode
+             */
+            if (symeq("relax", id, 1)) {
+              hp->h_rmode = i;
+            }
   }
   /*
    * Setup Absolute DEF linkage.
@@ -0,0 +1,1145 @@
+/* lkincr.c */
+
+/*
+ *  Copyright (C) 1989-2017  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include "aslink.h"
+
+/*)Module	lkincr.c
+ *
+ *	The module lkincr.c contains the functions of the
+ *	-mm incremental relink.
+ *
+ *	At the end of a link without errors the state of the
+ *	link is saved in the file (out)file[.ilk]:
+ *
+ *	(1)	a hash of the link command,
+ *	(2)	the layout of each area, the size of the
+ *		slot of each areax section,
+ *	(3)	for each input .rel file a hash of the file,
+ *		a hash of the addresses of the areas and the
+ *		values of the symbols referenced by its modules,
+ *		and the relocated data of its R lines.
+ *
+ *	The next link with the same command reads the state.
+ *	When every areax section still fits in its slot the
+ *	previous layout is kept so that the unchanged modules
+ *	do not move.  A .rel file is not read and relocated
+ *	again in pass 1 when the file and the addresses and
+ *	values it references are unchanged, its saved R lines
+ *	are replayed into the output and listing files.  A
+ *	module referencing a changed symbol is relocated.
+ *	The library modules are always relocated.
+ *
+ *	The header of the file holds a hash of the rest of
+ *	the file and the saved R lines are checked before
+ *	they are used.  A damaged or stale file is ignored
+ *	and the link is made as without the file.
+ *
+ *	lkincr.c contains the following functions:
+ *		int	lkichk(ifp, thp)
+ *		VOID	lkiclose()
+ *		VOID	lkicmd(str)
+ *		VOID	lkienv()
+ *		VOID	lkihbgn(hp)
+ *		VOID	lkihstr(hp, bp, n)
+ *		VOID	lkiline(str)
+ *		VOID	lkiload()
+ *		int	lkiopen(lfp)
+ *		VOID	lkipin()
+ *		VOID	lkiput(ifp, bp, n)
+ *		int	lkird(fp, bp, n)
+ *		VOID	lkirec(aindex, n)
+ *		int	lkirply(ifp)
+ *		VOID	lkisave()
+ *		VOID	lkiwr(fp, bp, n)
+ *
+ *	lkincr.c contains the following local variables:
+ *		struct lkih	lkich	hash of the link command
+ *		int	lkichs		lkich has been started
+ *		struct lkih	lkibh	hash of the .ilk file body
+ *		struct lkif *	lkifp	first .rel file of this link
+ *		struct lkif *	lkilp	last .rel file of this link
+ *		struct lkif *	lkicur	.rel file being hashed or
+ *					relocated or NULL
+ *		struct lkif *	lkiold	first .rel file of the
+ *					previous link
+ *		struct lkia *	lkiap	first area of the
+ *					previous link
+ */
+
+static struct lkih lkich;
+static int lkichs;
+static struct lkih lkibh;
+static struct lkif *lkifp;
+static struct lkif *lkilp;
+static struct lkif *lkicur;
+static struct lkif *lkiold;
+static struct lkia *lkiap;
+
+/*)Function	VOID	lkihbgn(hp)
+ *)Function	VOID	lkihstr(hp, bp, n)
+ *
+ *		lkih *	hp		pointer to a hash value
+ *		char *	bp		pointer to the bytes
+ *		int	n		number of bytes
+ *
+ *	The function lkihbgn() starts a hash value and the
+ *	function lkihstr() adds n bytes to a hash value.
+ *	The two 32-bit halves are the FNV-1a hash and a
+ *	shift-add-xor hash of the bytes.
+ *
+ *	local variables:
+ *		unsigned INT32	a	FNV-1a hash
+ *		unsigned INT32	b	shift-add-xor hash
+ *		int	c		current byte
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The hash value is updated.
+ */
+
+VOID lkihbgn(hp)
+struct lkih *hp;
+{
+  hp->h_a = 2166136261U;
+  hp->h_b = 5381;
+}
+
+VOID lkihstr(hp, bp, n)
+struct lkih *hp;
+char *bp;
+int n;
+{
+  unsigned INT32 a, b;
+  int c;
+
+  a = hp->h_a;
+  b = hp->h_b;
+  while (n-- > 0) {
+    c = *bp++ & 0xFF;
+    a = (a ^ c) * 16777619U;
+    b = ((b << 5) + (b >> 2) + c) ^ b;
+  }
+  hp->h_a = a & 0xFFFFFFFF;
+  hp->h_b = b & 0xFFFFFFFF;
+}
+
+/*)Function	VOID	lkicmd(str)
+ *
+ *		char *	str		linker command line
+ *
+ *	The function lkicmd() is called by parse() and adds
+ *	each line of the link command to the hash of the
+ *	command.  The hash starts with the linker version.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct lkih	lkich	hash of the link command
+ *		int	lkichs		lkich has been started
+ *
+ *	functions called:
+ *		VOID	lkihbgn()	lkincr.c
+ *		VOID	lkihstr()	lkincr.c
+ *		int	strlen()	c_library
+ *
+ *	side effects:
+ *		The hash of the link command is updated.
+ */
+
+VOID lkicmd(str)
+char *str;
+{
+  if (lkichs == 0) {
+    lkihbgn(&lkich);
+    lkihstr(&lkich, VERSION, (int)strlen(VERSION) + 1);
+    lkichs = 1;
+  }
+  lkihstr(&lkich, str, (int)strlen(str) + 1);
+}
+
+/*)Function	int	lkird(fp, bp, n)
+ *)Function	VOID	lkiwr(fp, bp, n)
+ *
+ *		FILE *	fp		.ilk file handle
+ *		VOID *	bp		pointer to the buffer
+ *		int	n		number of bytes
+ *
+ *	The function lkird() reads n bytes of the .ilk file
+ *	and the function lkiwr() writes n bytes to the .ilk
+ *	file.  The bytes are added to the hash of the body
+ *	of the file.
+ *
+ *	lkird() returns a (1) if the bytes were read
+ *	else a (0).
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct lkih	lkibh	hash of the .ilk file body
+ *
+ *	functions called:
+ *		size_t	fread()		c_library
+ *		size_t	fwrite()	c_library
+ *		VOID	lkihstr()	lkincr.c
+ *
+ *	side effects:
+ *		The buffer is loaded or written and
+ *		the hash of the body is updated.
+ */
+
+int lkird(fp, bp, n)
+FILE *fp;
+VOID *bp;
+int n;
+{
+  if ((n != 0) && (fread(bp, (size_t)n, 1, fp) != 1))
+    return (0);
+  lkihstr(&lkibh, (char *)bp, n);
+  return (1);
+}
+
+VOID lkiwr(fp, bp, n)
+FILE *fp;
+VOID *bp;
+int n;
+{
+  if (n != 0) {
+    fwrite(bp, (size_t)n, 1, fp);
+    lkihstr(&lkibh, (char *)bp, n);
+  }
+}
+
+/*)Function	int	lkichk(ifp, thp)
+ *
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *		head *	thp		first module of the file
+ *					or NULL
+ *
+ *	The function lkichk() checks the saved R lines of a
+ *	.rel file of the previous link before they are used.
+ *	Each event must be complete, name a module of the
+ *	file and hold valid counts, parameters and rtflg[]
+ *	values.  When the modules of the file in this link
+ *	are given the area index of each R line must be an
+ *	area of its module.
+ *
+ *	lkichk() returns a (1) if the saved R lines
+ *	are valid else a (0).
+ *
+ *	local variables:
+ *		struct lkiev	ev	R line event
+ *		char *	p		pointer into the saved R lines
+ *		char *	end		end of the saved R lines
+ *		head *	mhp		pointer to a head structure
+ *		int	i		loop counter
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID *	memcpy()	c_library
+ *
+ *	side effects:
+ *		none
+ */
+
+int lkichk(ifp, thp)
+struct lkif *ifp;
+struct head *thp;
+{
+  struct lkiev ev;
+  struct head *mhp;
+  char *p, *end;
+  int i;
+
+  p = ifp->f_buf;
+  end = p + ifp->f_len;
+  while (p != end) {
+    if ((end - p) < (long)sizeof(ev))
+      return (0);
+    memcpy(&ev, p, sizeof(ev));
+    p += sizeof(ev);
+    if ((ev.i_hn < 0) || (ev.i_hn >= ifp->f_nhead) || (ev.i_cnt < 0) ||
+        (ev.i_cnt > NTXT) || (ev.i_nent < 0) || (ev.i_aindex < 0) ||
+        ((ev.i_vers != 3) && (ev.i_vers != 4)) ||
+        ((ev.i_radix != 8) && (ev.i_radix != 10) && (ev.i_radix != 16)) ||
+        ((ev.i_hilo != 0) && (ev.i_hilo != 1)) || (ev.i_abytes < 1) ||
+        (ev.i_abytes > 4) || (ev.i_pcb < 1) || (ev.i_pcb > 4) ||
+        ((end - p) < (long)(ev.i_cnt * (sizeof(a_uint) + 1))))
+      return (0);
+    if (thp != NULL) {
+      for (i = ev.i_hn, mhp = thp; (i > 0) && (mhp != NULL); i--) {
+        mhp = mhp->h_hp;
+      }
+      if ((mhp == NULL) || (ev.i_aindex >= mhp->h_narea))
+        return (0);
+    }
+    p += ev.i_cnt * sizeof(a_uint);
+    for (i = 0; i < ev.i_cnt; i++, p++) {
+      if ((*p & 0xFF) > 2)
+        return (0);
+    }
+  }
+  return (1);
+}
+
+/*)Function	VOID	lkiload()
+ *
+ *	The function lkiload() reads the state of the previous
+ *	link from the file (out)file[.ilk].  The state is used
+ *	only when the file was created by this version of the
+ *	linker with the same link command, the hash of the
+ *	body of the file is unchanged and the saved R lines
+ *	of each .rel file are valid.
+ *
+ *	local variables:
+ *		FILE *	fp		.ilk file handle
+ *		struct lkihdr	h	.ilk file header
+ *		struct lkia *	iap	pointer to an area layout
+ *		struct lkia *	lap	last area layout
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *		struct lkif *	lfp	last .rel file state
+ *		char	fn[]		.ilk file specification
+ *		char *	p		file extension
+ *		int	i		loop counter
+ *		int	n		string length
+ *		int	ok		read status
+ *
+ *	global variables:
+ *		struct lkih	lkibh	hash of the .ilk file body
+ *		struct lkih	lkich	hash of the link command
+ *		struct lkia *	lkiap	first area of the
+ *					previous link
+ *		struct lkif *	lkiold	first .rel file of the
+ *					previous link
+ *		lfile	*linkp		pointer to first lfile structure
+ *				 	containing an input .rel file
+ *				 	specification
+ *		int	mmflag		-mm, incremental relink flag
+ *
+ *	functions called:
+ *		int	fclose()	c_library
+ *		int	fndidx()	lkmain.c
+ *		FILE *	fopen()		c_library
+ *		int	getc()		c_library
+ *		int	lkichk()	lkincr.c
+ *		VOID	lkihbgn()	lkincr.c
+ *		int	lkird()		lkincr.c
+ *		VOID *	malloc()	c_library
+ *		VOID *	new()		lksym.c
+ *		int	sprintf()	c_library
+ *		char *	strcpy()	c_library
+ *		int	strlen()	c_library
+ *		int	strncmp()	c_library
+ *		char *	strrchr()	c_library
+ *
+ *	side effects:
+ *		The state of the previous link is loaded.
+ */
+
+VOID lkiload() {
+  FILE *fp;
+  struct lkihdr h;
+  struct lkia *iap, *lap;
+  struct lkif *ifp, *lfp;
+  char fn[FILSPC + 8];
+  char *p;
+  int i, n, ok;
+
+  if ((mmflag == 0) || (strlen(linkp->f_idp) > (FILSPC - 7)))
+    return;
+  strcpy(fn, linkp->f_idp);
+  if ((p = strrchr(&fn[fndidx(fn)], FSEPX)) == NULL) {
+    p = &fn[strlen(fn)];
+  }
+  sprintf(p, "%cilk", FSEPX);
+  if ((fp = fopen(fn, "rb")) == NULL)
+    return;
+
+  ok = lkird(fp, &h, sizeof(h)) && (strncmp(h.h_id, "ASlink", 8) == 0) &&
+       (h.h_ver == LKIVER) && (h.h_size == (int)sizeof(a_uint)) &&
+       (h.h_cmd.h_a == lkich.h_a) && (h.h_cmd.h_b == lkich.h_b);
+  lkihbgn(&lkibh);
+
+  /*
+   * Area Layouts
+   */
+  lap = NULL;
+  for (i = 0; ok && (i < h.h_narea); i++) {
+    iap = (struct lkia *)new (sizeof(struct lkia));
+    ok = lkird(fp, iap->a_id, NCPS) &&
+         lkird(fp, &iap->a_flag, sizeof(iap->a_flag)) &&
+         lkird(fp, &iap->a_nax, sizeof(iap->a_nax)) && (iap->a_nax > 0) &&
+         (iap->a_nax < 0x10000);
+    if (ok) {
+      iap->a_id[NCPS - 1] = 0;
+      n = iap->a_nax * sizeof(a_uint);
+      iap->a_slot = (a_uint *)new (n);
+      iap->a_bofst = (a_uint *)new (n);
+      ok = lkird(fp, iap->a_slot, n) && lkird(fp, iap->a_bofst, n);
+    }
+    if (lap == NULL) {
+      lkiap = iap;
+    } else {
+      lap->a_iap = iap;
+    }
+    lap = iap;
+  }
+
+  /*
+   * .rel File States
+   */
+  lfp = NULL;
+  for (i = 0; ok && (i < h.h_nfile); i++) {
+    ifp = (struct lkif *)new (sizeof(struct lkif));
+    ok = lkird(fp, &n, sizeof(n)) && (n > 0) && (n < FILSPC + FILSPC);
+    if (ok) {
+      ifp->f_fid = (char *)new (n + 1);
+      ok = lkird(fp, ifp->f_fid, n) &&
+           lkird(fp, &ifp->f_rel, sizeof(ifp->f_rel)) &&
+           lkird(fp, &ifp->f_env, sizeof(ifp->f_env)) &&
+           lkird(fp, &ifp->f_nhead, sizeof(ifp->f_nhead)) &&
+           lkird(fp, &ifp->f_pmin, sizeof(ifp->f_pmin)) &&
+           lkird(fp, &ifp->f_pmout, sizeof(ifp->f_pmout)) &&
+           lkird(fp, &ifp->f_len, sizeof(ifp->f_len)) && (ifp->f_len >= 0);
+    }
+    if (ok && (ifp->f_len != 0)) {
+      ifp->f_buf = (char *)malloc((size_t)ifp->f_len);
+      ok = (ifp->f_buf != NULL) && lkird(fp, ifp->f_buf, (int)ifp->f_len);
+      ifp->f_max = ifp->f_len;
+    }
+    if (lfp == NULL) {
+      lkiold = ifp;
+    } else {
+      lfp->f_ifp = ifp;
+    }
+    lfp = ifp;
+  }
+
+  /*
+   * The whole file is read and unchanged
+   */
+  ok = ok && (getc(fp) == EOF) && (h.h_body.h_a == lkibh.h_a) &&
+       (h.h_body.h_b == lkibh.h_b);
+  fclose(fp);
+  for (ifp = lkiold; ok && (ifp != NULL); ifp = ifp->f_ifp) {
+    ok = lkichk(ifp, NULL);
+  }
+
+  if (!ok) {
+    lkiap = NULL;
+    lkiold = NULL;
+  }
+}
+
+/*)Function	VOID	lkipin()
+ *
+ *	The function lkipin() is called before lnkarea() and
+ *	keeps the layout of the previous link.  The areas and
+ *	the number of areax sections of each area must be
+ *	unchanged and each areax section, with its boundary
+ *	offset, must fit in its slot of the previous link.
+ *	The slot size is then loaded into each areax and
+ *	lnksect() allocates the slot instead of the size.
+ *
+ *	local variables:
+ *		struct lkia *	iap	pointer to an area layout
+ *		area *	tap		pointer to an area structure
+ *		areax *	taxp		pointer to an areax structure
+ *		int	i		areax number
+ *
+ *	global variables:
+ *		area	*areap		The pointer to the first
+ *				 	area structure of a linked list
+ *		struct lkia *	lkiap	first area of the
+ *					previous link
+ *
+ *	functions called:
+ *		VOID	lkiload()	lkincr.c
+ *		int	symeq()		lksym.c
+ *
+ *	side effects:
+ *		The areax slot sizes may be set.
+ */
+
+VOID lkipin() {
+  struct lkia *iap;
+  struct area *tap;
+  struct areax *taxp;
+  int i;
+
+  lkiload();
+
+  /*
+   * Every section must fit
+   */
+  iap = lkiap;
+  for (tap = areap; tap != NULL; tap = tap->a_ap) {
+    if ((iap == NULL) || !symeq(tap->a_id, iap->a_id, 1) ||
+        (tap->a_flag != iap->a_flag))
+      return;
+    for (i = 0, taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp, i++) {
+      if ((i >= iap->a_nax) ||
+          ((taxp->a_size + iap->a_bofst[i]) > iap->a_slot[i]))
+        return;
+    }
+    if (i != iap->a_nax)
+      return;
+    iap = iap->a_iap;
+  }
+  if (iap != NULL)
+    return;
+
+  /*
+   * Keep the previous layout
+   */
+  iap = lkiap;
+  for (tap = areap; tap != NULL; tap = tap->a_ap) {
+    for (i = 0, taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp, i++) {
+      taxp->a_slot = iap->a_slot[i];
+    }
+    iap = iap->a_iap;
+  }
+}
+
+/*)Function	VOID	lkienv()
+ *
+ *	The function lkienv() is called after symdef() when
+ *	all the addresses and symbol values are known.  For
+ *	each .rel file the modules of the file are found and
+ *	the addresses of their areas, the states of their
+ *	relaxable jumps and the values of their symbols are
+ *	hashed.  A file with the same .rel file hash, the
+ *	same hash of the addresses and values, and the
+ *	same number of modules as in the previous link
+ *	takes the saved R lines of the previous link and will
+ *	be replayed in pass 1 when lkichk() finds them valid
+ *	for the modules of this link.
+ *
+ *	local variables:
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *		struct lkif *	pfp	pointer to a previous
+ *					.rel file state
+ *		head *	thp		pointer to a head structure
+ *		areax *	taxp		pointer to an areax structure
+ *		a_uint	v		hashed value
+ *		int	i		loop counter
+ *		int	j		loop counter
+ *
+ *	global variables:
+ *		head	*headp		The pointer to the first
+ *				 	head structure of a linked list
+ *		struct lkif *	lkifp	first .rel file of this link
+ *		struct lkif *	lkiold	first .rel file of the
+ *					previous link
+ *		int	mmflag		-mm, incremental relink flag
+ *
+ *	functions called:
+ *		int	lkichk()	lkincr.c
+ *		VOID	lkihbgn()	lkincr.c
+ *		VOID	lkihstr()	lkincr.c
+ *		int	strcmp()	c_library
+ *		a_uint	symval()	lksym.c
+ *
+ *	side effects:
+ *		The .rel files to be replayed are selected.
+ */
+
+VOID lkienv() {
+  struct lkif *ifp, *pfp;
+  struct head *thp;
+  struct areax *taxp;
+  a_uint v;
+  int i, j;
+
+  if (mmflag == 0)
+    return;
+
+  thp = headp;
+  for (ifp = lkifp; ifp != NULL; ifp = ifp->f_ifp) {
+    lkihbgn(&ifp->f_env);
+    while ((thp != NULL) && (thp->h_lfile == ifp->f_lfp)) {
+      if (ifp->f_hp == NULL) {
+        ifp->f_hp = thp;
+      }
+      ifp->f_hpl = thp;
+      ifp->f_nhead += 1;
+      for (i = 0; i < thp->h_narea; i++) {
+        if ((taxp = thp->a_list[i]) != NULL) {
+          v = taxp->a_addr;
+          lkihstr(&ifp->f_env, (char *)&v, sizeof(v));
+          v = (a_uint)taxp->a_bap->a_flag;
+          lkihstr(&ifp->f_env, (char *)&v, sizeof(v));
+          for (j = 0; j < taxp->a_nrx; j++) {
+            v = (a_uint)taxp->a_rxp[j].x_state;
+            lkihstr(&ifp->f_env, (char *)&v, sizeof(v));
+          }
+        }
+      }
+      for (i = 0; i < thp->h_nsym; i++) {
+        if (thp->s_list[i] != NULL) {
+          v = symval(thp->s_list[i]);
+          lkihstr(&ifp->f_env, (char *)&v, sizeof(v));
+        }
+      }
+      thp = thp->h_hp;
+    }
+
+    for (pfp = lkiold; pfp != NULL; pfp = pfp->f_ifp) {
+      if (strcmp(pfp->f_fid, ifp->f_fid) == 0)
+        break;
+    }
+    if ((pfp != NULL) && (pfp->f_nhead == ifp->f_nhead) &&
+        (pfp->f_rel.h_a == ifp->f_rel.h_a) &&
+        (pfp->f_rel.h_b == ifp->f_rel.h_b) &&
+        (pfp->f_env.h_a == ifp->f_env.h_a) &&
+        (pfp->f_env.h_b == ifp->f_env.h_b) && lkichk(pfp, ifp->f_hp)) {
+      ifp->f_rply = 1;
+      ifp->f_pmin = pfp->f_pmin;
+      ifp->f_pmout = pfp->f_pmout;
+      ifp->f_buf = pfp->f_buf;
+      ifp->f_len = pfp->f_len;
+      ifp->f_max = pfp->f_max;
+    }
+  }
+}
+
+/*)Function	int	lkiopen(lfp)
+ *
+ *		lfile *	lfp		.rel file to be opened
+ *
+ *	The function lkiopen() is called by nxtline() before
+ *	a .rel file is opened.  In pass 0 a state structure
+ *	is linked for the file and the lines of the file will
+ *	be hashed.  In pass 1 a file selected by lkienv() is
+ *	replayed when the page mask is the same as in the
+ *	previous link, else the relocated R lines of the file
+ *	will be saved.
+ *
+ *	lkiopen() returns a (1) if the file was replayed
+ *	and must not be read, else a (0).
+ *
+ *	local variables:
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *
+ *	global variables:
+ *		FILE *	jfp		NoICE output file handle
+ *		struct lkif *	lkicur	.rel file being hashed or
+ *					relocated or NULL
+ *		struct lkif *	lkifp	first .rel file of this link
+ *		struct lkif *	lkilp	last .rel file of this link
+ *		int	mmflag		-mm, incremental relink flag
+ *		a_uint	p_mask		Page Mask
+ *		int	pass		linker pass number
+ *
+ *	functions called:
+ *		VOID	lkihbgn()	lkincr.c
+ *		int	lkirply()	lkincr.c
+ *		VOID *	new()		lksym.c
+ *
+ *	side effects:
+ *		The .rel file may be replayed.
+ */
+
+int lkiopen(lfp)
+struct lfile *lfp;
+{
+  struct lkif *ifp;
+
+  lkicur = NULL;
+  if (mmflag == 0)
+    return (0);
+
+  if (pass == 0) {
+    ifp = (struct lkif *)new (sizeof(struct lkif));
+    ifp->f_lfp = lfp;
+    ifp->f_fid = lfp->f_idp;
+    lkihbgn(&ifp->f_rel);
+    if (lkilp == NULL) {
+      lkifp = ifp;
+    } else {
+      lkilp->f_ifp = ifp;
+    }
+    lkilp = ifp;
+    lkicur = ifp;
+    return (0);
+  }
+
+  for (ifp = lkifp; ifp != NULL; ifp = ifp->f_ifp) {
+    if (ifp->f_lfp == lfp)
+      break;
+  }
+  if (ifp == NULL)
+    return (0);
+#if NOICE
+  /*
+   * The NoICE comments are read in pass 1
+   */
+  if (jfp != NULL) {
+    ifp->f_rply = 0;
+  }
+#endif
+  if (ifp->f_rply && (ifp->f_pmin == p_mask)) {
+    return (lkirply(ifp));
+  }
+  ifp->f_rply = 0;
+  ifp->f_len = 0;
+  ifp->f_pmin = p_mask;
+  lkicur = ifp;
+  return (0);
+}
+
+/*)Function	VOID	lkiline(str)
+ *
+ *		char *	str		.rel file line
+ *
+ *	The function lkiline() is called by nxtline() for
+ *	each line read and adds the pass 0 lines of a .rel
+ *	file to the hash of the file.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct lkif *	lkicur	.rel file being hashed or
+ *					relocated or NULL
+ *		int	pass		linker pass number
+ *
+ *	functions called:
+ *		VOID	lkihstr()	lkincr.c
+ *		int	strlen()	c_library
+ *
+ *	side effects:
+ *		The hash of the .rel file is updated.
+ */
+
+VOID lkiline(str)
+char *str;
+{
+  if ((lkicur != NULL) && (pass == 0)) {
+    lkihstr(&lkicur->f_rel, str, (int)strlen(str) + 1);
+  }
+}
+
+/*)Function	VOID	lkiclose()
+ *
+ *	The function lkiclose() is called by nxtline() at the
+ *	end of a file.  The page mask at the end of the pass 1
+ *	of a .rel file is saved.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		struct lkif *	lkicur	.rel file being hashed or
+ *					relocated or NULL
+ *		a_uint	p_mask		Page Mask
+ *		int	pass		linker pass number
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The current .rel file state is closed.
+ */
+
+VOID lkiclose() {
+  if ((lkicur != NULL) && (pass != 0)) {
+    lkicur->f_pmout = p_mask;
+  }
+  lkicur = NULL;
+}
+
+/*)Function	VOID	lkiput(ifp, bp, n)
+ *
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *		char *	bp		pointer to the bytes
+ *		int	n		number of bytes
+ *
+ *	The function lkiput() appends n bytes to the saved
+ *	R lines of a .rel file.
+ *
+ *	local variables:
+ *		char *	p		new buffer
+ *		long	m		new buffer size
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		VOID	lkexit()	lkmain.c
+ *		VOID *	memcpy()	c_library
+ *		VOID *	realloc()	c_library
+ *
+ *	side effects:
+ *		The buffer may be enlarged.
+ */
+
+VOID lkiput(ifp, bp, n)
+struct lkif *ifp;
+char *bp;
+int n;
+{
+  char *p;
+  long m;
+
+  if ((ifp->f_len + n) > ifp->f_max) {
+    m = 2 * ifp->f_max + n + 4096;
+    if ((p = (char *)realloc(ifp->f_buf, (size_t)m)) == NULL) {
+      fprintf(stderr, "Out of space!\n");
+      lkexit(ER_FATAL);
+    }
+    ifp->f_buf = p;
+    ifp->f_max = m;
+  }
+  memcpy(ifp->f_buf + ifp->f_len, bp, (size_t)n);
+  ifp->f_len += n;
+}
+
+/*)Function	VOID	lkirec(aindex, n)
+ *
+ *		int	aindex		R line area index
+ *		int	n		number of relocation entries
+ *
+ *	The function lkirec() is called by relr() and saves
+ *	the relocated data of the R line and the linker state
+ *	needed to output it.
+ *
+ *	local variables:
+ *		struct lkiev	ev	R line event
+ *		char	flg[]		rtflg[] bytes
+ *		head *	thp		pointer to a head structure
+ *		int	i		loop counter
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		a_uint	a_mask		Address Mask
+ *		int	ASxxxx_VERSION	ASxxxx REL file version
+ *		int	hilo		byte ordering parameter
+ *		head	*hp		pointer to the current head structure
+ *		struct lkif *	lkicur	.rel file being hashed or
+ *					relocated or NULL
+ *		int	obj_flag	Linked file/library object flag
+ *		a_uint	pc		relocated base address
+ *		int	pcb		bytes per instruction word
+ *		int	pass		linker pass number
+ *		int	radix		current number conversion radix
+ *		int	rtcnt		count of data words
+ *		int	rtflg[]		output the data flag
+ *		a_uint	rtval[]		relocated data
+ *		a_uint	s_mask		Sign Mask
+ *		a_uint	v_mask		Value Mask
+ *
+ *	functions called:
+ *		VOID	lkiput()	lkincr.c
+ *		VOID *	memset()	c_library
+ *
+ *	side effects:
+ *		The R line is saved.
+ */
+
+VOID lkirec(aindex, n)
+int aindex;
+int n;
+{
+  struct lkiev ev;
+  char flg[NTXT];
+  struct head *thp;
+  int i;
+
+  if ((lkicur == NULL) || (pass == 0))
+    return;
+
+  for (i = 0, thp = lkicur->f_hp; (thp != NULL) && (thp != hp);
+       thp = thp->h_hp) {
+    i++;
+  }
+  memset(&ev, 0, sizeof(ev));
+  ev.i_hn = i;
+  ev.i_obj = obj_flag;
+  ev.i_vers = ASxxxx_VERSION;
+  ev.i_radix = radix;
+  ev.i_hilo = hilo;
+  ev.i_abytes = a_bytes;
+  ev.i_amask = a_mask;
+  ev.i_smask = s_mask;
+  ev.i_vmask = v_mask;
+  ev.i_aindex = aindex;
+  ev.i_pc = pc;
+  ev.i_pcb = pcb;
+  ev.i_cnt = rtcnt;
+  ev.i_nent = n;
+  for (i = 0; i < rtcnt; i++) {
+    flg[i] = (char)rtflg[i];
+  }
+  lkiput(lkicur, (char *)&ev, sizeof(ev));
+  lkiput(lkicur, (char *)rtval, rtcnt * sizeof(a_uint));
+  lkiput(lkicur, flg, rtcnt);
+}
+
+/*)Function	int	lkirply(ifp)
+ *
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *
+ *	The function lkirply() replays the saved R lines of a
+ *	.rel file in pass 1 in place of reading the file.  The
+ *	listing files are opened and closed as by nxtline()
+ *	and each R line is output by relrply().  The current
+ *	module and the page mask are left as at the end of
+ *	the file.  The saved R lines were checked by lkichk().
+ *
+ *	lkirply() returns a (1).
+ *
+ *	local variables:
+ *		struct lkiev	ev	R line event
+ *		char *	p		pointer into the saved R lines
+ *		char *	end		end of the saved R lines
+ *		head *	thp		pointer to a head structure
+ *		int	i		loop counter
+ *		int	ph		previous statistics phase
+ *
+ *	global variables:
+ *		int	gline		get a line from the LST file
+ *		int	hline		get a line from the HLR file
+ *		head	*hp		pointer to the current head structure
+ *		struct lkstat	lkst	link statistics
+ *		int	obj_flag	Linked file/library object flag
+ *		a_uint	p_mask		Page Mask
+ *		(and the globals saved by lkirec())
+ *
+ *	functions called:
+ *		VOID	lkulist()	lklist.c
+ *		VOID	lkuopen()	lklex.c
+ *		VOID *	memcpy()	c_library
+ *		VOID	relrply()	lkrloc.c
+ *		int	stphase()	lkstat.c
+ *
+ *	side effects:
+ *		The R lines of the file are output.
+ */
+
+int lkirply(ifp)
+struct lkif *ifp;
+{
+  struct lkiev ev;
+  struct head *thp;
+  char *p, *end;
+  int i, ph;
+
+  obj_flag = ifp->f_lfp->f_obj;
+  if (obj_flag == 0) {
+    lkuopen(ifp->f_fid);
+  }
+  gline = 1;
+  hline = 1;
+
+  p = ifp->f_buf;
+  end = p + ifp->f_len;
+  while (p < end) {
+    memcpy(&ev, p, sizeof(ev));
+    p += sizeof(ev);
+    for (i = ev.i_hn, thp = ifp->f_hp; i > 0; i--) {
+      thp = thp->h_hp;
+    }
+    hp = thp;
+    obj_flag = ev.i_obj;
+    ASxxxx_VERSION = ev.i_vers;
+    radix = ev.i_radix;
+    hilo = ev.i_hilo;
+    a_bytes = ev.i_abytes;
+    a_mask = ev.i_amask;
+    s_mask = ev.i_smask;
+    v_mask = ev.i_vmask;
+    pc = ev.i_pc;
+    pcb = ev.i_pcb;
+    rtcnt = ev.i_cnt;
+    memcpy(rtval, p, rtcnt * sizeof(a_uint));
+    p += rtcnt * sizeof(a_uint);
+    for (i = 0; i < rtcnt; i++) {
+      rtflg[i] = *p++;
+      rterr[i] = 0;
+    }
+    relrply(ev.i_aindex, ev.i_nent);
+  }
+
+  ph = stphase(PH_LIST);
+  lkulist(0);
+  stphase(ph);
+  if (ifp->f_hpl != NULL) {
+    hp = ifp->f_hpl;
+  }
+  p_mask = ifp->f_pmout;
+  lkst.st_cnt[ST_IRPLY] += 1;
+  return (1);
+}
+
+/*)Function	VOID	lkisave()
+ *
+ *	The function lkisave() writes the state of a link
+ *	without errors to the file (out)file[.ilk].  The slot
+ *	of an areax is the larger of its size and its slot in
+ *	the previous link.  The header is written again with
+ *	the hash of the body when the body has been written.
+ *
+ *	local variables:
+ *		FILE *	fp		.ilk file handle
+ *		struct lkihdr	h	.ilk file header
+ *		struct lkif *	ifp	pointer to a .rel file state
+ *		area *	tap		pointer to an area structure
+ *		areax *	taxp		pointer to an areax structure
+ *		char	fn[]		.ilk file specification
+ *		char	id[]		area name
+ *		a_uint	addr		areax slot address
+ *		a_uint	v		slot size or boundary offset
+ *		int	n		count or string length
+ *
+ *	global variables:
+ *		char	afspec[]	constructed file specification string
+ *		area	*areap		The pointer to the first
+ *				 	area structure of a linked list
+ *		lfile	*linkp		pointer to first lfile structure
+ *				 	containing an input .rel file
+ *				 	specification
+ *		int	lkerr		error flag
+ *		struct lkih	lkibh	hash of the .ilk file body
+ *		struct lkih	lkich	hash of the link command
+ *		struct lkif *	lkifp	first .rel file of this link
+ *		int	mmflag		-mm, incremental relink flag
+ *
+ *	functions called:
+ *		FILE *	afile()		lkmain.c
+ *		int	fclose()	c_library
+ *		int	ferror()	c_library
+ *		int	fseek()		c_library
+ *		size_t	fwrite()	c_library
+ *		VOID	lkihbgn()	lkincr.c
+ *		VOID	lkiwr()		lkincr.c
+ *		VOID *	memset()	c_library
+ *		int	remove()	c_library
+ *		char *	strcpy()	c_library
+ *		int	strlen()	c_library
+ *		char *	strncpy()	c_library
+ *
+ *	side effects:
+ *		The .ilk file is created.
+ */
+
+VOID lkisave() {
+  FILE *fp;
+  struct lkihdr h;
+  struct lkif *ifp;
+  struct area *tap;
+  struct areax *taxp;
+  char fn[FILSPC];
+  char id[NCPS];
+  a_uint addr, v;
+  int n;
+
+  if ((mmflag == 0) || lkerr)
+    return;
+  if ((fp = afile(linkp->f_idp, "ilk", 3)) == NULL)
+    return;
+  strcpy(fn, afspec);
+
+  memset(&h, 0, sizeof(h));
+  strcpy(h.h_id, "ASlink");
+  h.h_ver = LKIVER;
+  h.h_size = sizeof(a_uint);
+  h.h_cmd = lkich;
+  for (tap = areap; tap != NULL; tap = tap->a_ap) {
+    h.h_narea += 1;
+  }
+  for (ifp = lkifp; ifp != NULL; ifp = ifp->f_ifp) {
+    h.h_nfile += 1;
+  }
+  fwrite(&h, sizeof(h), 1, fp);
+  lkihbgn(&lkibh);
+
+  /*
+   * Area Layouts
+   */
+  for (tap = areap; tap != NULL; tap = tap->a_ap) {
+    memset(id, 0, sizeof(id));
+    strncpy(id, tap->a_id, NCPS - 1);
+    lkiwr(fp, id, sizeof(id));
+    lkiwr(fp, &tap->a_flag, sizeof(tap->a_flag));
+    for (n = 0, taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      n += 1;
+    }
+    lkiwr(fp, &n, sizeof(n));
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      v = (taxp->a_slot > taxp->a_size) ? taxp->a_slot : taxp->a_size;
+      lkiwr(fp, &v, sizeof(v));
+    }
+    addr = tap->a_addr;
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      v = taxp->a_addr - addr;
+      lkiwr(fp, &v, sizeof(v));
+      if ((tap->a_flag & A4_OVR) != A4_OVR) {
+        addr += (taxp->a_slot > taxp->a_size) ? taxp->a_slot : taxp->a_size;
+      }
+    }
+  }
+
+  /*
+   * .rel File States
+   */
+  for (ifp = lkifp; ifp != NULL; ifp = ifp->f_ifp) {
+    n = (int)strlen(ifp->f_fid);
+    lkiwr(fp, &n, sizeof(n));
+    lkiwr(fp, ifp->f_fid, n);
+    lkiwr(fp, &ifp->f_rel, sizeof(ifp->f_rel));
+    lkiwr(fp, &ifp->f_env, sizeof(ifp->f_env));
+    lkiwr(fp, &ifp->f_nhead, sizeof(ifp->f_nhead));
+    lkiwr(fp, &ifp->f_pmin, sizeof(ifp->f_pmin));
+    lkiwr(fp, &ifp->f_pmout, sizeof(ifp->f_pmout));
+    lkiwr(fp, &ifp->f_len, sizeof(ifp->f_len));
+    if (ifp->f_len != 0) {
+      lkiwr(fp, ifp->f_buf, (int)ifp->f_len);
+    }
+  }
+
+  /*
+   * Header with the hash of the body
+   */
+  h.h_body = lkibh;
+  fseek(fp, 0L, SEEK_SET);
+  fwrite(&h, sizeof(h), 1, fp);
+
+  /*
+   * A damaged file is removed
+   */
+  n = ferror(fp);
+  if ((fclose(fp) != 0) || n) {
+    remove(fn);
+  }
+}
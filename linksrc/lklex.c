@@ -37,6 +37,7 @@
  *		VOID	getid()
  *		int	getmap()
  *		int	getnb()
+ *		VOID	lkuopen()
  *		int	more()
  *		int	nxtline()
  *		VOID	skip()
@@ -353,6 +354,59 @@ int d;
   return (c);
 }
 
+/*)Function	VOID	lkuopen(fid)
+ *
+ *		char *	fid		.rel file name
+ *
+ *	The function lkuopen() opens the input .lst file,
+ *	the output .rst file and the .hlr hint file of the
+ *	.rel file fid when the relocated listing is selected
+ *	in pass 1.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		FILE	*hfp		The file handle to the current
+ *					.lst to .rst hint file associated
+ *					with the LST file being scanned.
+ *		int	pass		linker pass number
+ *		FILE	*rfp		The file handle to the current
+ *					output RST file
+ *		FILE	*tfp		The file handle to the current
+ *					LST file being scanned
+ *		int	uflag		update listing flag
+ *
+ *	called functions:
+ *		FILE *	afile()		lkmain.c
+ *		int	fclose()	c_library
+ *		VOID	lkpopen()	lkpar.c
+ *		VOID	lstmap()	lklist.c
+ *
+ *	side effects:
+ *		The listing files of the .rel file are opened.
+ */
+
+VOID lkuopen(fid)
+char *fid;
+{
+  if (uflag && (pass != 0)) {
+    if ((tfp = afile(fid, "lst", 0)) != NULL) {
+      if ((rfp = afile(fid, "rst", 1)) == NULL) {
+        fclose(tfp);
+        tfp = NULL;
+      } else {
+        hfp = afile(fid, "hlr", 4);
+        if (uflag > 1) {
+          lkpopen(fid);
+        } else {
+          lstmap();
+        }
+      }
+    }
+  }
+}
+
 /*)Function	int	nxtline()
  *
  *	The function nxtline() reads a line of input text from a
@@ -365,6 +419,10 @@ int d;
  *	or a (0) if all files have been read.
  *	This function also opens each input .lst file and output
  *	.rst file as each .rel file is processed.
+ *	A parallel relocation worker saves each change of
+ *	the input file for the replay by the main process.
+ *	With -mm an unchanged .rel file is replayed by
+ *	lkiopen() in pass 1 and is not read.
  *
  *	local variables:
  *		int	ftype		file type
@@ -386,15 +444,11 @@ int d;
  *		char	ib[NINPUT]	REL file text line
  *		int	obj_flag	Linked file/library object flag
  *		int	pass		linker pass number
- *		FILE	*rfp		The file handle to the current
- *					output RST file
+ *		int	rlpar		parallel relocation mode
  *		FILE	*sfp		The file handle to the current
  *				 	input file
  *		FILE *	stdin		c_library
  *		FILE *	stdout		c_library
- *		FILE	*tfp		The file handle to the current
- *					LST file being scanned
- *		int	uflag		update listing flag
  *
  *	called functions:
  *		VOID	chopcrlf()	lklex.c
@@ -402,10 +456,15 @@ int d;
  *		int	fclose()	c_library
  *		char *	fgets()		c_library
  *		int	fprintf()	c_library
- *		VOID	gethlr()	lklist.c
  *		VOID	lkulist()	lklist.c
  *		VOID	lkexit()	lkmain.c
+ *		VOID	lkiclose()	lkincr.c
+ *		VOID	lkiline()	lkincr.c
+ *		int	lkiopen()	lkincr.c
+ *		VOID	lkprfil()	lkpar.c
+ *		VOID	lkuopen()	lklex.c
  *		VOID	SDCDBcopy()	lksdcdb.c
+ *		int	stphase()	lkstat.c
  *
  *	side effects:
  *		The input stream is scanned.  The .rel files will be
@@ -413,7 +472,7 @@ int d;
  */
 
 int nxtline() {
-  int ftype;
+  int ftype, ph;
   char *fid;
 
 loop:
@@ -421,13 +480,19 @@ loop:
     fprintf(stdout, "ASlink >> ");
 
   if (sfp == NULL || fgets(ib, sizeof(ib), sfp) == NULL) {
+    if (rlpar == PR_WORK) {
+      lkprfil();
+    }
     obj_flag = 0;
     if (sfp) {
       if (sfp != stdin) {
         fclose(sfp);
       }
       sfp = NULL;
+      lkiclose();
+      ph = stphase(PH_LIST);
       lkulist(0);
+      stphase(ph);
     }
     if (cfp == NULL) {
       cfp = filep;
@@ -442,19 +507,13 @@ loop:
       } else if (ftype == F_LNK) {
         sfp = afile(fid, "lnk", 0);
       } else if (ftype == F_REL) {
+        if (lkiopen(cfp)) {
+          goto loop;
+        }
         obj_flag = cfp->f_obj;
         sfp = afile(fid, "", 0);
         if (sfp && (obj_flag == 0)) {
-          if (uflag && (pass != 0)) {
-            if ((tfp = afile(fid, "lst", 0)) != NULL) {
-              if ((rfp = afile(fid, "rst", 1)) == NULL) {
-                fclose(tfp);
-                tfp = NULL;
-              } else {
-                hfp = afile(fid, "hlr", 4);
-              }
-            }
-          }
+          lkuopen(fid);
         }
 
 #if SDCDB
@@ -479,6 +538,7 @@ loop:
     }
   }
   chopcrlf(ib);
+  lkiline(ib);
   return (1);
 }
 
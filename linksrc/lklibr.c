@@ -241,6 +241,7 @@ char *libfil;
  *		int	symfnd		found a symbol flag
  *
  *	global variables:
+ *		struct lkstat	lkst	link statistics
  *		sym	*symhash[]	array of pointers to symbol tables
  *
  *	 functions called:
@@ -262,6 +263,7 @@ VOID search() {
   symfnd = 1;
   while (symfnd) {
     symfnd = 0;
+    lkst.st_cnt[ST_LBROUND] += 1;
     /*
      * Look through all the symbols
      */
@@ -284,6 +286,9 @@ VOID search() {
         sp = sp->s_sp;
       }
     }
+    lkst.st_cnt[ST_LBSYM] += symfnd;
+    i = (int)lkst.st_cnt[ST_LBROUND] - 1;
+    lkst.st_rnd[(i < NSTRND) ? i : NSTRND - 1] += symfnd;
   }
 }
 
@@ -320,6 +325,7 @@ VOID search() {
  *		FILE	*fp		file handle for object file
  *		lbfile	*lbf		temporary pointer
  *		lbfile	*lbfh		pointer to lbfile structure
+ *		head	*thp		pointer to a head structure
  *		int	lbscan		scan library file flag
  *		FILE	*libfp		file handle for library file
  *		lbname	*lbnh		pointer to lbname structure
@@ -336,6 +342,10 @@ VOID search() {
  *				 	name structure
  *		lbfile	*lbfhead	The pointer to the first
  *				 	file structure
+ *		head	*headp		The pointer to the first
+ *				 	head structure of a linked list
+ *		head	*hp		Pointer to the current
+ *				 	head structure
  *		int	obj_flag	linked file/library object output flag
  *
  *	 functions called:
@@ -369,6 +379,7 @@ char *name;
   FILE *libfp, *fp;
   struct lbname *lbnh;
   struct lbfile *lbfh, *lbf;
+  struct head *thp;
   char relfil[NINPUT + 2];
   char buf[NINPUT + 2];
   char symname[NINPUT];
@@ -386,6 +397,7 @@ char *name;
       fprintf(stderr, "Cannot open library file %s\n", lbnh->libspc);
       lkexit(ER_FATAL);
     }
+    lkst.st_cnt[ST_LBOPEN] += 1;
     path = lbnh->path;
 
     /*
@@ -395,6 +407,7 @@ char *name;
      */
 
     /*2*/ while (fgets(relfil, NINPUT, libfp) != NULL) {
+      lkst.st_cnt[ST_LBLINE] += 1;
       relfil[NINPUT + 1] = '\0';
       chopcrlf(relfil);
       if (path != NULL) {
@@ -426,6 +439,7 @@ char *name;
         }
       }
       /*3*/ if (lbscan && (fp = fopen(str, "r")) != NULL) {
+        lkst.st_cnt[ST_LBOPEN] += 1;
 
         /*
          * Read in the object file.  Look for lines that
@@ -437,6 +451,7 @@ char *name;
 
         /*4*/ while (fgets(buf, NINPUT, fp) != NULL) {
 
+          lkst.st_cnt[ST_LBLINE] += 1;
           buf[NINPUT + 1] = '\0';
           chopcrlf(buf);
 
@@ -485,7 +500,11 @@ char *name;
             SDCDBcopy(str);
 #endif
 
+            thp = hp;
             loadfile(str);
+            for (thp = thp ? thp->h_hp : headp; thp; thp = thp->h_hp) {
+              lbfh->f_nhead += 1;
+            }
             return (1);
 
 /*5*/			}
@@ -513,10 +532,13 @@ return (0);
  *		int	obj_flag	linked file/library object output flag
  *
  *	 functions called:
+ *		int	lkgskip()	lkgc.c
  *		VOID	loadfile	lklibr.c
  *
  *	side effects:
  *		Links all files contained in the lbfile structures.
+ *		A file whose sections were all removed by the
+ *		area garbage collection is skipped.
  */
 
 VOID library() {
@@ -524,6 +546,8 @@ VOID library() {
 
   for (lbfh = lbfhead; lbfh; lbfh = lbfh->next) {
     obj_flag = lbfh->f_obj;
+    if (lkgskip(lbfh))
+      continue;
     loadfile(lbfh->filspc);
   }
 }
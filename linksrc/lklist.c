@@ -31,6 +31,11 @@
 
 #include "aslink.h"
 
+#if LKMMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 /*)Module	lklist.c
  *
  *	The module lklist.c contains the functions which
@@ -47,14 +52,43 @@
  *		VOID	lklist()
  *		VOID	lkalist()
  *		VOID	getlst()
+ *		VOID	lstmap()
+ *		VOID	lstput()
+ *		VOID	lstrest()
+ *		VOID	lstunmap()
  *
  *		VOID	hlrlist()
  *		VOID	hlralist()
  *		VOID	hlrclist()
  *		VOID	hlrelist()
  *		VOID	gethlr()
+ *
+ *	When LKMMAP is non-zero the .lst file is read from a
+ *	memory mapping.  Each line is still copied into rb[]
+ *	where the relocated values are patched but lines which
+ *	are not patched, and the remainder of the .lst file,
+ *	are written to the .rst file directly from the mapping.
+ *
+ *	lklist.c contains the following local variables:
+ *		char *	lsb		.lst file mapping or NULL
+ *		char *	lse		end of the .lst file mapping
+ *		char *	lsp		next .lst line in the mapping
+ *		char *	rbs		mapped text of the line in rb[]
+ *		int	rbn		length of the line at rbs
+ *		int	rbz		rb[] characters to be cleared
+ *		int	rbmod		rb[] has been patched
  */
 
+static char *lsb = NULL;
+static char *lse;
+static char *lsp;
+static char *rbs = NULL;
+static int rbn;
+static int rbz = NINPUT;
+static int rbmod;
+
+static VOID lstunmap();
+
 /*)Function	VOID	newpag(fp)
  *
  *		FILE *	fp		file handle for listing
@@ -847,7 +881,8 @@ ee DDDDDDDDDD ddd ddd ddd ddd [nn]LLLLL *********	DECIMAL(32)
  *	files.  The .lst file's program address and code bytes
  *	are changed to reflect the changes made by ASlink as
  *	the .rel files are combined into a single relocated
- *	output file.
+ *	output file.  With -uu the data is saved by lkprec()
+ *	and the .rst files are created by lkpupd().
  *
  *	local variables:
  *		a_uint	cpc		current program counter address in PC
@@ -867,6 +902,7 @@ ee DDDDDDDDDD ddd ddd ddd ddd [nn]LLLLL *********	DECIMAL(32)
  *		a_uint	rtval[]		relocated data
  *		FILE	*tfp		The file handle to the current
  *					LST file being scanned
+ *		int	uflag		Relocated listing flag
  *
  *	functions called:
  *		a_uint	adb_xb()	lkrloc.c
@@ -877,6 +913,9 @@ ee DDDDDDDDDD ddd ddd ddd ddd [nn]LLLLL *********	DECIMAL(32)
  *		VOID	lklist()	lklist.c
  *		VOID	hlralist()	lklist.c
  *		VOID	hlrglist()	lklist.c
+ *		VOID	lkprec()	lkpar.c
+ *		VOID	lstput()	lklist.c
+ *		VOID	lstrest()	lklist.c
  *
  *	side effects:
  *		A .rst file is created for each available .lst
@@ -889,6 +928,14 @@ int i;
   a_uint cpc;
   int cbytes;
 
+  /*
+   * Save the data for the parallel update
+   */
+  if (uflag > 1) {
+    lkprec(i);
+    return;
+  }
+
   /*
    * Exit if listing file is not open
    */
@@ -930,9 +977,11 @@ int i;
       for (i = a_bytes; i < rtcnt; i++) {
         if (rtflg[i]) {
           if (hfp == NULL) {
-            lklist(cpc, (int)(rtval[i] & 0xFF), rterr[i]);
+            lklist(cpc, (rtflg[i] == 1) ? (int)(rtval[i] & 0xFF) : -1,
+                   rterr[i]);
           } else {
-            hlrlist(cpc, (int)(rtval[i] & 0xFF), rterr[i]);
+            hlrlist(cpc, (rtflg[i] == 1) ? (int)(rtval[i] & 0xFF) : -1,
+                    rterr[i]);
           }
           cbytes += 1;
           cpc += (cbytes % pcb) ? 0 : 1;
@@ -944,7 +993,7 @@ int i;
      */
   } else {
     if (gline == 0)
-      fprintf(rfp, "%s", rb);
+      lstput();
 
     while (gethlr(1)) {
       if (listing & NLIST) {
@@ -954,12 +1003,10 @@ int i;
         if ((lmode == ELIST) && (listing & LIST_EQT)) {
           hlrelist();
         }
-        fprintf(rfp, "%s", rb);
+        lstput();
       }
     }
-    while (getlst(1)) {
-      fprintf(rfp, "%s", rb);
-    }
+    lstrest();
     if (tfp != NULL) {
       fclose(tfp);
       tfp = NULL;
@@ -1012,6 +1059,7 @@ int i;
  *		int	fprintf()	c_library
  *		int	sprintf()	c_library
  *		char *	strncpy()	c_library
+ *		VOID	lstput()	lklist.c
  *
  *	side effects:
  *		Lines of the LST file are copied to the RST file,
@@ -1041,7 +1089,7 @@ a_uint cpc;
    * Cleanup
    */
   if (gline == 0) {
-    fprintf(rfp, "%s", rb);
+    lstput();
   }
 
   /*
@@ -1209,30 +1257,33 @@ loop:
   }
 #endif
   if (!dgt(r, &rb[n], m)) {
-    fprintf(rfp, "%s", rb);
+    lstput();
     goto loop;
   }
   if ((int)strlen(rb) > (n + m + 2)) {
     for (i = (n + m); i < q; i++) {
       if (rb[i] != ' ') {
-        fprintf(rfp, "%s", rb);
+        lstput();
         goto loop;
       }
     }
   }
   sprintf(str, frmt, cpc);
   strncpy(&rb[n], str, m);
+  rbmod = 1;
 
   /*
    * Copy updated LST text line to RST
    */
-  fprintf(rfp, "%s", rb);
+  lstput();
 }
 
 /*)Function	VOID	lklist(cpc,v,err)
  *
  *		int	cpc		current program counter value
- *		int 	v		value of byte at this address
+ *		int 	v		value of byte at this address,
+ *					-1 for a byte removed by the
+ *					linker (listed blank)
  *		int	err		error flag for this value
  *
  *	The function lklist() performs the following functions:
@@ -1278,6 +1329,7 @@ loop:
  *		int	fprintf()	c_library
  *		int	sprintf()	c_library
  *		char *	strncpy()	c_library
+ *		VOID	lstput()	lklist.c
  *
  *	side effects:
  *		Lines of the LST file are copied to the RST file
@@ -1521,7 +1573,7 @@ loop:
    * Number must be of proper radix
    */
   if (!dgt(r, rp, s - 1)) {
-    fprintf(rfp, "%s", rb);
+    lstput();
     gline = 1;
     goto loop;
   }
@@ -1529,8 +1581,13 @@ loop:
   /*
    * Output new data value, overwrite relocation codes
    */
-  sprintf(str, frmt, v);
+  if (v < 0) {
+    sprintf(str, "%*s", s, "");
+  } else {
+    sprintf(str, frmt, v);
+  }
   strncpy(rp - 1, str, s);
+  rbmod = 1;
 
   /*
    * Output relocated code address
@@ -1539,6 +1596,7 @@ loop:
     if (dgt(r, &rb[n], m)) {
       sprintf(str, afrmt, cpc);
       strncpy(&rb[n], str, m);
+      rbmod = 1;
     }
   }
 
@@ -1552,7 +1610,7 @@ loop:
    * Output text line when updates finished
    */
   if (++gcntr == u) {
-    fprintf(rfp, "%s", rb);
+    lstput();
     gline = 1;
     /*
      * Output an error line if required
@@ -1584,20 +1642,31 @@ loop:
  *	line buffer.  At end of .lst file close the .lst and
  *	.rst files.
  *
+ *	When the .lst file is mapped the line is copied from
+ *	the mapping and only the characters of rb[] which may
+ *	be non zero are cleared.  A line is at most NINPUT - 3
+ *	characters, longer lines are split as by fgets().
+ *
  *	local variables:
- *		int	i		repeat counter
+ *		char *	p		pointer to the end of line
+ *		int	n		line length
  *
  *	global variables:
  *		int	gcntr		byte counter
  *		int	gline		read a new line if != 0
+ *		struct lkstat	lkst	link statistics
  *		FILE *	rfp		.rst file handle
  *		char 	rb[]		character array for line input
- *		char *	rp		pointer to a character array
  *		FILE *	tfp		.lst file handle
+ *		(and the lklist.c mapping variables)
  *
  *	functions called:
  *		int	fclose()	c_library
  *		int	fgets()		c_library
+ *		VOID	lstunmap()	lklist.c
+ *		VOID *	memchr()	c_library
+ *		VOID *	memcpy()	c_library
+ *		VOID *	memset()	c_library
  *
  *	side effects:
  *		the next .lst file line is read into rb[],
@@ -1607,38 +1676,222 @@ loop:
 int getlst(ngline)
 int ngline;
 {
-  int i;
+  char *p;
+  int n;
 
   /*
    * Set parameters
    */
   gline = ngline;
   gcntr = 0;
-  /*
-   * Clear text line buffer
-   */
-  for (i = 0, rp = rb; i < sizeof(rb); i++) {
-    *rp++ = 0;
-  }
 
   /*
    * Get next LST text line
    */
   if (tfp != NULL) {
-    if (fgets(rb, sizeof(rb) - 2, tfp) == NULL) {
-      fclose(tfp);
-      tfp = NULL;
-      fclose(rfp);
-      rfp = NULL;
+    if (lsb != NULL) {
+      n = (int)(lse - lsp);
+      if (n > (int)sizeof(rb) - 3) {
+        n = (int)sizeof(rb) - 3;
+      }
+      if (n != 0) {
+        if ((p = memchr(lsp, '\n', n)) != NULL) {
+          n = (int)(p - lsp) + 1;
+        }
+        if (rbmod) {
+          rbz = sizeof(rb);
+        }
+        if (rbz > n) {
+          memset(&rb[n], 0, rbz - n);
+        }
+        memcpy(rb, lsp, n);
+        rbs = lsp;
+        rbn = n;
+        rbz = n;
+        rbmod = 0;
+        lsp += n;
+        lkst.st_cnt[ST_LST] += 1;
+        return (1);
+      }
+    } else {
+      memset(rb, 0, sizeof(rb));
+      if (fgets(rb, sizeof(rb) - 2, tfp) != NULL) {
+        lkst.st_cnt[ST_LST] += 1;
+        return (1);
+      }
     }
+    lstunmap();
+    fclose(tfp);
+    tfp = NULL;
+    fclose(rfp);
+    rfp = NULL;
+  }
+  return (0);
+}
+
+/*)Function	VOID	lstmap()
+ *
+ *	The function lstmap() is called after the .lst
+ *	file tfp is opened and maps the file into memory.
+ *	If the file can not be mapped getlst() reads the
+ *	file with fgets().
+ *
+ *	local variables:
+ *		struct stat	st	file status
+ *
+ *	global variables:
+ *		char	rb[]		character array for line input
+ *		FILE *	tfp		.lst file handle
+ *		(and the lklist.c mapping variables)
+ *
+ *	functions called:
+ *		int	fileno()	c_library
+ *		int	fstat()		c_library
+ *		VOID *	mmap()		c_library
+ *
+ *	side effects:
+ *		The .lst file may be mapped.
+ */
+
+VOID lstmap() {
+#if LKMMAP
+  struct stat st;
+#endif
+
+  lsb = NULL;
+  rbs = NULL;
+  rbz = sizeof(rb);
+  rbmod = 0;
+#if LKMMAP
+  if ((tfp != NULL) && (fstat(fileno(tfp), &st) == 0) && (st.st_size > 0)) {
+    lsb = (char *)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+                       fileno(tfp), 0);
+    if (lsb == (char *)MAP_FAILED) {
+      lsb = NULL;
+    } else {
+      lsp = lsb;
+      lse = lsb + st.st_size;
+    }
+  }
+#endif
+}
+
+/*)Function	VOID	lstunmap()
+ *
+ *	The function lstunmap() removes the .lst file mapping.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		(the lklist.c mapping variables)
+ *
+ *	functions called:
+ *		int	munmap()	c_library
+ *
+ *	side effects:
+ *		The .lst file mapping is removed.
+ */
+
+static VOID lstunmap() {
+#if LKMMAP
+  if (lsb != NULL) {
+    munmap(lsb, (size_t)(lse - lsb));
+  }
+#endif
+  lsb = NULL;
+  rbs = NULL;
+}
+
+/*)Function	VOID	lstput()
+ *
+ *	The function lstput() writes the current .lst line
+ *	to the .rst file.  A line which has not been patched
+ *	is written directly from the .lst file mapping.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		char 	rb[]		character array for line input
+ *		FILE *	rfp		.rst file handle
+ *		(and the lklist.c mapping variables)
+ *
+ *	functions called:
+ *		int	fputs()		c_library
+ *		size_t	fwrite()	c_library
+ *
+ *	side effects:
+ *		A line is written to the .rst file.
+ */
+
+VOID lstput() {
+  if ((rbs != NULL) && (rbmod == 0)) {
+    fwrite(rbs, 1, rbn, rfp);
+  } else {
+    fputs(rb, rfp);
+  }
+}
+
+/*)Function	VOID	lstrest()
+ *
+ *	The function lstrest() copies the remainder of the
+ *	.lst file to the .rst file and closes the files.
+ *	A mapped .lst file is written as a single block.
+ *
+ *	local variables:
+ *		char *	p		pointer to the end of line
+ *		char *	q		line pointer
+ *		int	n		line length
+ *
+ *	global variables:
+ *		struct lkstat	lkst	link statistics
+ *		FILE *	rfp		.rst file handle
+ *		FILE *	tfp		.lst file handle
+ *		(and the lklist.c mapping variables)
+ *
+ *	functions called:
+ *		int	getlst()	lklist.c
+ *		VOID	lstput()	lklist.c
+ *		size_t	fwrite()	c_library
+ *		VOID *	memchr()	c_library
+ *
+ *	side effects:
+ *		The .lst and .rst files are closed.
+ */
+
+VOID lstrest() {
+  char *p, *q;
+  int n;
+
+  if ((tfp != NULL) && (lsb != NULL)) {
+    /*
+     * Count the lines as getlst() would
+     */
+    for (q = lsp; q < lse; q += n) {
+      n = (int)(lse - q);
+      if (n > (int)sizeof(rb) - 3) {
+        n = (int)sizeof(rb) - 3;
+      }
+      if ((p = memchr(q, '\n', n)) != NULL) {
+        n = (int)(p - q) + 1;
+      }
+      lkst.st_cnt[ST_LST] += 1;
+    }
+    fwrite(lsp, 1, lse - lsp, rfp);
+    lsp = lse;
+  }
+  while (getlst(1)) {
+    lstput();
   }
-  return (tfp ? 1 : 0);
 }
 
 /*)Function	VOID	hlrlist(cpc,v,err)
  *
  *		int	cpc		current program counter value
- *		int 	v		value of byte at this address
+ *		int 	v		value of byte at this address,
+ *					-1 for a byte removed by the
+ *					linker (listed blank)
  *		int	err		error flag for this value
  *
  *	The function hlrlist() performs the following function:
@@ -1699,6 +1952,7 @@ int ngline;
  *		int	fprintf()	c_library
  *		int	sprintf()	c_library
  *		char *	strncpy()	c_library
+ *		VOID	lstput()	lklist.c
  *
  *	side effects:
  *		Lines of the LST file are copied to the RST file
@@ -1788,7 +2042,7 @@ lpLST:
     if (bytcnt == bgncnt) {
       lsterr(err);
       if (listing && !(listing & HLR_NLST)) {
-        fprintf(rfp, "%s", rb);
+        lstput();
 #if HLR_DEBUG
         fprintf(stdout, "%s", rb);
 #endif
@@ -1818,7 +2072,7 @@ lpLST:
     lsterr(err);
     if (listing && !(listing & HLR_NLST)) {
       hlralist(cpc);
-      fprintf(rfp, "%s", rb);
+      lstput();
 #if HLR_DEBUG
       fprintf(stdout, "%s", rb);
 #endif
@@ -1831,7 +2085,7 @@ lpLST:
       lsterr(err);
       if (bytcnt == 0) {
         if (listing && !(listing & HLR_NLST)) {
-          fprintf(rfp, "%s", rb);
+          lstput();
 #if HLR_DEBUG
           fprintf(stdout, "%s", rb);
 #endif
@@ -1843,7 +2097,7 @@ lpLST:
         }
         if ((bytcnt ? --bytcnt : 0) == 0) {
           if (listing && !(listing & HLR_NLST)) {
-            fprintf(rfp, "%s", rb);
+            lstput();
 #if HLR_DEBUG
             fprintf(stdout, "%s", rb);
 #endif
@@ -1858,7 +2112,7 @@ lpLST:
       }
       if ((bytcnt ? --bytcnt : 0) == 0) {
         if (listing && !(listing & HLR_NLST)) {
-          fprintf(rfp, "%s", rb);
+          lstput();
 #if HLR_DEBUG
           fprintf(stdout, "%s", rb);
 #endif
@@ -1876,7 +2130,7 @@ lpLST:
         if (listing & LIST_EQT) {
           hlrelist();
         }
-        fprintf(rfp, "%s", rb);
+        lstput();
 #if HLR_DEBUG
         fprintf(stdout, "%s", rb);
 #endif
@@ -2169,6 +2423,7 @@ a_uint cpc;
   if (listing & LIST_LOC) {
     sprintf(str, frmt, cpc);
     strncpy(&rb[n], str, m);
+    rbmod = 1;
   }
 }
 
@@ -2428,6 +2683,7 @@ int v;
     if (gcntr == 0) {
       sprintf(str, afrmt, cpc);
       strncpy(&rb[n], str, m);
+      rbmod = 1;
     }
   }
 
@@ -2435,8 +2691,13 @@ int v;
    * Output new data value, overwrite relocation codes
    */
   if (listing & LIST_BIN) {
-    sprintf(str, dfrmt, v);
+    if (v < 0) {
+      sprintf(str, "%*s", s, "");
+    } else {
+      sprintf(str, dfrmt, v);
+    }
     strncpy(&rb[a + (s * gcntr) - 1], str, s);
+    rbmod = 1;
   }
   gcntr++;
 }
@@ -2665,6 +2926,7 @@ VOID hlrelist() {
         eqtv += hp->a_list[i]->a_addr;
         sprintf(str, afrmt, eqtv & a_mask);
         strncpy(&rb[a], str, m);
+        rbmod = 1;
         break;
       }
     }
@@ -45,6 +45,7 @@
  *		VOID	map()
  *		int	parse()
  *		VOID	doparse()
+ *		int	rtopt()
  *		VOID	setgbl()
  *		VOID	usage()
  *
@@ -71,7 +72,8 @@
  *	and look for undefined symbols.  Following these routines a linker
  *	map file may be produced and the linker output files may be opened.
  *	The second pass through the .rel files will output the linked data
- *	in one of the supported formats.
+ *	in one of the supported formats.  With the -mm option the state of
+ *	the link is saved for the next incremental relink.
  *
  *	local variables:
  *		int	c		character from argument string
@@ -109,6 +111,7 @@
  *		int	pass		linker pass number
  *		int	pflag		print linker command file flag
  *		int	radix		current number conversion radix
+ *		int	rtlen		Data bytes per record
  *		FILE	*sfp		The file handle sfp points to the
  *				 	currently open file
  *		lfile	*startp		aslink startup file structure
@@ -122,17 +125,28 @@
  *		VOID	link()		lkmain.c
  *		VOID	lkexit()	lkmain.c
  *		VOID	lkfopen()	lkbank.c
+ *		VOID	lkgc()		lkgc.c
+ *		VOID	lkienv()	lkincr.c
+ *		VOID	lkipin()	lkincr.c
+ *		VOID	lkisave()	lkincr.c
+ *		int	lkprel()	lkpar.c
+ *		VOID	lkprply()	lkpar.c
+ *		VOID	lkpupd()	lkpar.c
+ *		VOID	lkrelax()	lkrelax.c
  *		VOID	lnkarea()	lkarea.c
  *		VOID	map()		lkmain.c
  *		VOID	new()		lksym.c
  *		int	nxtline()	lklex.c
  *		int	parse()		lkmain.c
  *		VOID	reloc()		lkreloc.c
+ *		int	rtlim()		lkout.c
  *		VOID	search()	lklibr.c
  *		VOID	setarea()	lkarea.c
  *		VOID	setbank()	lkbank.c
  *		VOID	setgbl()	lkmain.c
  *		char *	sprintf()	c_library
+ *		VOID	stinit()	lkstat.c
+ *		int	stphase()	lkstat.c
  *		VOID	symdef()	lksym.c
  *		time_t	time()		c_library
  *		VOID	usage()		lkmain.c
@@ -158,6 +172,8 @@ char *argv[];
 
   fprintf(stdout, "\n");
 
+  stinit();
+
   startp = (struct lfile *)new (sizeof(struct lfile));
   startp->f_idp = "";
 
@@ -181,6 +197,9 @@ char *argv[];
 
         case 'g':
         case 'G':
+          if (argv[j][k + 1] == c) {
+            sprintf(ip + 2, "%c", argv[j][++k]);
+          }
 
         case 'k':
         case 'K':
@@ -197,21 +216,29 @@ char *argv[];
         /*
          * Options with options
          */
-        case 'i':
-        case 'I':
-          if (argv[i][++k] == '1') {
-            sprintf(ip + 2, "%c", argv[i][k]);
+        case 'm':
+        case 'M':
+          c = argv[i][++k];
+          if ((c == '1') || (c == 'm') || (c == 'M')) {
+            sprintf(ip + 2, "%c", c);
           } else {
             --k;
           }
           break;
 
-        case 'm':
-        case 'M':
-          if (argv[i][++k] == '1') {
-            sprintf(ip + 2, "%c", argv[i][k]);
-          } else {
-            --k;
+        case 'i':
+        case 'I':
+
+        case 's':
+        case 'S':
+
+        case 't':
+        case 'T':
+
+        case 'r':
+        case 'R':
+          while (ctype[argv[i][k + 1] & 0x7F] & DIGIT) {
+            sprintf(ip + strlen(ip), "%c", argv[i][++k]);
           }
           break;
 
@@ -266,6 +293,7 @@ char *argv[];
     lfp->f_type = F_REL;
   }
 
+  stphase(PH_OTHER);
   syminit();
   curtim = time(NULL);
 
@@ -284,23 +312,51 @@ char *argv[];
     p_mask = DEFAULT_PMASK;
     radix = 10;
 
-    while (nxtline()) {
-      ip = ib;
-      link();
+    stphase(pass ? PH_RELOC : PH_LOAD);
+    if ((pass != 0) && lkprel()) {
+      /*
+       * Replay the parallel pass 1 relocation
+       */
+      lkprply();
+    } else {
+      while (nxtline()) {
+        ip = ib;
+        link();
+      }
+      /*
+       * Link in library files
+       */
+      if (pass != 0) {
+        library();
+      }
     }
     if (pass == 0) {
       /*
        * Search libraries for global symbols
        */
+      stphase(PH_SEARCH);
       search();
       /*
        * Set area base addresses.
        */
+      stphase(PH_AREA);
       setarea();
       /*
        * Set bank base addresses.
        */
       setbank();
+      /*
+       * Remove unreferenced areas.
+       */
+      lkgc();
+      /*
+       * Keep the layout of the previous link.
+       */
+      lkipin();
+      /*
+       * Shrink the relaxable jumps.
+       */
+      lkrelax();
       /*
        * Link all area addresses.
        */
@@ -316,7 +372,22 @@ char *argv[];
       /*
        * Check for undefined globals.
        */
+      stphase(PH_SYMDEF);
       symdef(stderr);
+      /*
+       * Select the unchanged files.
+       */
+      lkienv();
+      /*
+       * The -sn record length must fit the
+       * address size of the S28/S37 records.
+       */
+      if (rtlen > rtlim()) {
+        fprintf(stderr, "?ASlink-Error-<record length not 1 - %d> : -s\n",
+                rtlim());
+        lkexit(ER_FATAL);
+      }
+      stphase(PH_MAP);
 #if NOICE
       /*
        * Open NoICE output file
@@ -327,21 +398,36 @@ char *argv[];
        * Output Link Map.
        */
       map();
+#if NOICE
+      /*
+       * Output sorted NoICE records
+       */
+      NoICEflush();
+#endif
       /*
        * Open output file(s)
        */
+      stphase(PH_OUTPUT);
       lkfopen();
     } else {
-      /*
-       * Link in library files
-       */
-      library();
       /*
        * Complete Processing
        */
       reloc('E');
+      /*
+       * Parallel Listing Update
+       */
+      if (uflag > 1) {
+        stphase(PH_LIST);
+        lkpupd();
+      }
     }
   }
+  /*
+   * Save the incremental relink state
+   */
+  lkisave();
+  stphase(PH_OTHER);
   lkexit(lkerr ? ER_ERROR : ER_NONE);
   return (0);
 }
@@ -376,6 +462,7 @@ int intsiz() { return (sizeof(a_uint)); }
  *		none
  *
  *	global variables:
+ *		int	aflag		-a, link statistics flag
  *		FILE *	jfp		file handle for .noi
  *		FILE *	mfp		file handle for .map
  *		FILE *	rfp		file hanlde for .rst
@@ -388,6 +475,7 @@ int intsiz() { return (sizeof(a_uint)); }
  *		int	fclose()	c_library
  *		VOID	exit()		c_library
  *		VOID	lkfclose()	lkbank.c
+ *		VOID	stlist()	lkstat.c
  *
  *	side effects:
  *		All files closed. Program terminates.
@@ -417,6 +505,9 @@ int i;
   if (yfp != NULL)
     fclose(yfp);
 #endif
+  if (aflag) {
+    stlist(stdout);
+  }
   exit(i);
 }
 
@@ -433,11 +524,13 @@ int i;
  *	global variables:
  *		int	a_bytes		T Line address bytes
  *		a_uint	a_mask		address mask
+ *		int	gcflag		Area garbage collection flag
  *		head	*headp		The pointer to the first
  *				 	head structure of a linked list
  *		int	hilo		Byte ordering
  *		head	*hp		Pointer to the current
  *				 	head structure
+ *		struct lkstat	lkst	link statistics
  *		int	pass		linker pass number
  *		int	radix		current number conversion radix
  *		sdp	sdp		Base Paged structure
@@ -454,16 +547,21 @@ int i;
  *		sym *	newsym()	lksym.c
  *		VOID	NoICEmagic()	lknoice.c
  *		VOID	reloc()		lkreloc.c
+ *		VOID	relref()	lkrloc.c
  *		int	unget()		lklex.c
  *
  *	side effects:
  *		Head, area, and symbol structures are created and
  *		the radix is set as the .rel file(s) are read.
+ *		The references of the R and P lines are saved
+ *		for the area garbage collection and the jumps
+ *		of the R lines for the branch relaxation.
  */
 
 VOID link() {
   int c;
 
+  lkst.st_cnt[ST_LINES] += 1;
   c = getnb();
   switch (c) {
 
@@ -554,6 +652,7 @@ VOID link() {
 
   case 'H':
     if (pass == 0) {
+      lkst.st_cnt[ST_MODS] += 1;
       newhead();
     } else {
       if (hp == 0) {
@@ -602,8 +701,11 @@ VOID link() {
   case 'T':
   case 'R':
   case 'P':
-    if (pass == 0)
+    if (pass == 0) {
+      if (gcflag || ((hp != NULL) && hp->h_rmode))
+        relref(c);
       break;
+    }
     reloc(c);
     break;
 
@@ -773,6 +875,7 @@ VOID map() {
  *	local variables:
  *		int	c		character value
  *		int	idx		string index
+ *		int	n		option value
  *		int	sv_type		save type of processing
  *		char	*p;		string pointer
  *		char	fid[]		file id string
@@ -787,12 +890,17 @@ VOID map() {
  *				 	containing an input REL file
  *				 	specification
  *		int	mflag		Map output flag
+ *		int	mmflag		-mm, incremental relink flag
  *		int	oflag		Output file type flag
  *		int	objflg		Linked file/library output object flag
  *		int	pflag		print linker command file flag
+ *		int	pkflag		Packed output flag
+ *		int	rfill		Binary output fill byte
+ *		int	rtlen		Data bytes per record
  *		FILE *	stderr		c_library
  *		int	uflag		Relocated listing flag
  *		int	wflag		Wide listing format
+ *		int	aflag		-a, link statistics flag
  *		int	xflag		Map file radix type flag
  *		int	yflag		SDCC Debug output flag
  *		int	zflag		Enable symbol case sensitivity
@@ -809,7 +917,10 @@ VOID map() {
  *		int	getnb()		lklex.c
  *		int	getnb()		lklex.c
  *		VOID	lkexit()	lkmain.c
+ *		VOID	lkgkeep()	lkgc.c
+ *		VOID	lkicmd()	lkincr.c
  *		char *	new()		lksym.c
+ *		int	rtopt()		lkmain.c
  *		char *	strsto()	lksym.c
  *		int	strlen()	c_library
  *		VOID	unget()		lklex.c
@@ -820,11 +931,12 @@ VOID map() {
  */
 
 int parse() {
-  int c, idx;
+  int c, idx, n;
   char *p;
   int sv_type;
   char fid[FILSPC + FILSPC];
 
+  lkicmd(ip);
   while ((c = getnb()) != 0) {
     if (c == '-') {
       while (ctype[c = get()] & LETTER) {
@@ -867,22 +979,52 @@ int parse() {
 
         case 'i':
         case 'I':
+          if (oflag == 1) {
+            pkflag = 1;
+          }
           oflag = 1;
-          if ((c = get()) == '1') {
+          n = rtopt(c, 255);
+          if (n == 1) {
             o1flag = 1;
-          } else {
-            unget(c);
+          } else if (n != 0) {
+            rtlen = n;
           }
           break;
 
         case 's':
         case 'S':
+          if (oflag == 2) {
+            pkflag = 1;
+          }
           oflag = 2;
+          n = rtopt(c, 255 - 1 - 2);
+          if (n != 0) {
+            rtlen = n;
+          }
           break;
 
         case 't':
         case 'T':
+          if (oflag == 3) {
+            pkflag = 1;
+          }
           oflag = 3;
+          n = rtopt(c, NMAX);
+          if (n != 0) {
+            rtlen = n;
+          }
+          break;
+
+        case 'r':
+        case 'R':
+          oflag = (oflag >= 4) ? 5 : 4;
+          if (ctype[c = get()] & DIGIT) {
+            for (rfill = 0; ctype[c] & DIGIT; c = get()) {
+              rfill = 10 * rfill + (c - '0');
+            }
+            rfill &= 0xFF;
+          }
+          unget(c);
           break;
 
         case 'o':
@@ -897,24 +1039,27 @@ int parse() {
 
         case 'm':
         case 'M':
-          mflag = 1;
-          if ((c = get()) == '1') {
+          c = get();
+          if (c == '1') {
             m1flag = 1;
+          } else if ((c == 'm') || (c == 'M')) {
+            mmflag = 1;
           } else {
             unget(c);
           }
+          mflag = 1;
           break;
 
 #if NOICE
         case 'j':
         case 'J':
-          jflag = 1;
+          ++jflag;
           break;
 #endif
 
         case 'u':
         case 'U':
-          uflag = 1;
+          ++uflag;
           break;
 
         case 'x':
@@ -948,12 +1093,22 @@ int parse() {
 
         case 'b':
         case 'B':
-          bassav();
+          if (((c = get()) == 'b') || (c == 'B')) {
+            lkgkeep(1);
+          } else {
+            unget(c);
+            bassav();
+          }
           return (0);
 
         case 'g':
         case 'G':
-          gblsav();
+          if (((c = get()) == 'g') || (c == 'G')) {
+            lkgkeep(0);
+          } else {
+            unget(c);
+            gblsav();
+          }
           return (0);
 
         case 'k':
@@ -971,10 +1126,15 @@ int parse() {
           wflag = 1;
           break;
 
+        case 'a':
+        case 'A':
+          ++aflag;
+          break;
+
 #if SDCDB
         case 'y':
         case 'Y':
-          yflag = 1;
+          ++yflag;
           break;
 #endif
 
@@ -1089,6 +1249,61 @@ VOID doparse() {
   startp->f_type = 0;
 }
 
+/*)Function	int	rtopt(c, max)
+ *
+ *		int	c		option character
+ *		int	max		largest record length
+ *
+ *	The function rtopt() reads the record length n of
+ *	an -in, -sn, or -tn option.  A record length which
+ *	is not in the range 1 - max is a fatal error.
+ *
+ *	rtopt() returns the record length or 0 if no
+ *	record length was given.
+ *
+ *	local variables:
+ *		int	d		digit character
+ *		int	n		record length
+ *
+ *	global variables:
+ *		char	ctype[]		array of character types, one per
+ *				 	ASCII character
+ *		FILE *	stderr		c_library
+ *
+ *	Functions called:
+ *		int	fprintf()	c_library
+ *		int	get()		lklex.c
+ *		VOID	lkexit()	lkmain.c
+ *		VOID	unget()		lklex.c
+ *
+ *	side effects:
+ *		An invalid record length terminates the linker.
+ */
+
+int rtopt(c, max)
+int c;
+int max;
+{
+  int d, n;
+
+  if ((ctype[d = get()] & DIGIT) == 0) {
+    unget(d);
+    return (0);
+  }
+  for (n = 0; ctype[d] & DIGIT; d = get()) {
+    if (n <= max) {
+      n = 10 * n + (d - '0');
+    }
+  }
+  unget(d);
+  if ((n < 1) || (n > max)) {
+    fprintf(stderr, "?ASlink-Error-<record length not 1 - %d> : -%c\n", max,
+            c);
+    lkexit(ER_FATAL);
+  }
+  return (n);
+}
+
 /*)Function	VOID	bassav()
  *
  *	The function bassav() creates a linked structure containing
@@ -1467,10 +1682,13 @@ char *usetxt[] = {
     "  -l   Library file specification, one per -l",
     "Relocation:",
     "  -b   area base address=expression",
+    "  -bb    area, keep the area and remove unreferenced areas",
     "  -g   global symbol=expression",
+    "  -gg    symbol, keep the symbol and remove unreferenced areas",
     "Map format:",
     "  -m   Map output generated as (out)file[.map]",
     "  -m1    Linker generated symbols included in (out)file[.map]",
+    "  -mm    Incremental relink, link state in (out)file[.ilk]",
     "  -w   Wide listing format for map file",
     "  -x   Hexadecimal (default)",
     "  -d   Decimal",
@@ -1480,18 +1698,32 @@ char *usetxt[] = {
     "  -i1    Legacy: start adddress record type set to 1",
     "  -s   Motorola S Record as (out)file[.s--]",
     "  -t   Tandy CoCo Disk BASIC binary as (out)file[.bi-]",
+    "  -ii  -ss  -tt  Records packed and sorted by address",
+    "  -in  -sn  -tn  n data bytes per record (1 - 255/252/256)",
+    "                 (-sn: S28 1 - 251, S37 1 - 250)",
+    "  -r   Raw binary image as (out)file[.img]",
+    "  -rr  Segmented binary as (out)file[.seg]",
+    "  -rn    Binary fill byte n (0 - 255, default 255)",
 #if NOICE
     "  -j   NoICE Debug output as (out)file[.noi]",
+    "  -jj    NoICE records sorted by address",
 #endif
 #if SDCDB
     "  -y   SDCDB Debug output as (out)file[.cdb]",
+    "  -yy    Remove repeated type records from the .cdb file",
 #endif
     "  -o   Linked file/library object output enable (default)",
     "  -v   Linked file/library object output disable",
     "List:",
     "  -u   Update listing file(s) with link data as file(s)[.rst]",
+    "  -uu    Update the listing files in parallel",
+    "Statistics:",
+    "  -a   Link timing and counter statistics to stdout",
+    "  -aa    Link statistics as JSON",
     "Case Sensitivity:",
     "  -z   Disable Case Sensitivity for Symbols",
+    "Environment:",
+    "  ASLINKPAR=n  Relocate pass 1 in up to n worker processes",
     "End:",
     "  -e   or null line terminates input",
     "",
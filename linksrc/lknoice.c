@@ -42,6 +42,9 @@
  *	lknoice.c contains the following functions:
  *		VOID	NoICEfopen()
  *		VOID	NoICEmagic()
+ *		VOID	NoICEsave()
+ *		int	NoICEcmp()
+ *		VOID	NoICEflush()
  *		VOID	DefineNoICE()
  *		VOID	DefineGlobal()
  *		VOID	DefineScoped()
@@ -57,6 +60,17 @@
  *						';!FILE' specifications
  *		char currentFile[]		file being processed
  *		char currentFunction[]		function being processed
+ *		struct noicesc *noicescp	files of the saved records
+ *		int noicesn			number of scopes
+ *		struct noicerc *noicercp	saved records
+ *		int noicenr			number of saved records
+ *
+ *	With -jj the records are saved instead of being written
+ *	and NoICEflush() writes them after the map.  The global
+ *	symbols are written first, then for each file the file
+ *	scope symbols, the LINE records, and the functions with
+ *	their scoped symbols.  Each group is sorted by address
+ *	and only the last LINE record of an address is kept.
  */
 
 struct noicefn {
@@ -66,6 +80,53 @@ struct noicefn {
 
 static struct noicefn *noicefnp = NULL;
 
+/*
+ * -jj saved record types
+ */
+#define NR_DEF 0  /* DEF, global symbol */
+#define NR_FN 1   /* DEF / FUNC, function */
+#define NR_SFN 2  /* DEFS / SFUNC, static function */
+#define NR_DEFS 3 /* DEFS, scoped symbol */
+#define NR_LINE 4 /* LINE */
+#define NR_EFN 5  /* ENDF, end of function */
+
+/*
+ * A file or function scope
+ */
+struct noicesc {
+  struct noicesc *c_np;  /* noicesc link */
+  struct noicesc *c_fnp; /* functions of a file */
+  char *c_id;            /* file or function name */
+  int c_num;             /* scope number, from 1 */
+};
+
+/*
+ * A saved record
+ */
+struct noicerc {
+  struct noicerc *r_np; /* noicerc link */
+  int r_type;           /* record type */
+  int r_file;           /* file number, 0 for a global */
+  int r_func;           /* function number, 0 for file scope */
+  char *r_fid;          /* file name */
+  char *r_cid;          /* function name */
+  char *r_id;           /* symbol name */
+  unsigned int r_line;  /* line number */
+  a_uint r_value;       /* value */
+  struct bank *r_bp;    /* bank */
+  int r_seq;            /* record number */
+};
+
+/*
+ * Sort rank of the record types within a scope
+ */
+static int noicerk[] = {1, 0, 0, 1, 2, 3};
+
+static struct noicesc *noicescp = NULL;
+static int noicesn = 0;
+static struct noicerc *noicercp = NULL;
+static int noicenr = 0;
+
 static char currentFile[NCPS];
 static char currentFunction[NCPS];
 
@@ -152,8 +213,9 @@ VOID NoICEmagic(void) {
       fprintf(jfp, "%s\n", &ip[2]);
     }
     if (pass == 0) {
+      ip += 2;
       getid(id, -1);
-      if (symeq(id, ";!FILE", 1)) {
+      if (symeq(id, "FILE", 1)) {
         getid(id, -1);
         /*
          * The name starts after the last
@@ -188,6 +250,272 @@ VOID NoICEmagic(void) {
   }
 }
 
+/*)Function	VOID	NoICEsave()
+ *
+ *		int		type	record type
+ *		char *		name	pointer to the symbol string
+ *		unsigned int	line	line number
+ *		a_uint		value	value of symbol
+ *		struct bank *	yp	pointer to associated bank
+ *
+ *	The function NoICEsave() saves a -jj NoICE record
+ *	for NoICEflush().  Global symbols have no scope,
+ *	LINE records are in the scope of the current file
+ *	and the other records in the scope of the current
+ *	file and function.
+ *
+ *	local variables:
+ *		struct noicesc * fp	pointer to file scope
+ *		struct noicesc * cp	pointer to function scope
+ *		struct noicesc * sp	temporary scope pointer
+ *		struct noicerc * rp	pointer to new record
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID *	new()		lksym.c
+ *		char *	strsto()	lksym.c
+ *		int	symeq()		lksym.c
+ *
+ *	side effects:
+ *		A record is added to the list of
+ *		saved records.
+ */
+
+VOID NoICEsave(int type, char *name, unsigned int line, a_uint value,
+               struct bank *yp) {
+  struct noicesc *fp, *cp, *sp;
+  struct noicerc *rp;
+
+  rp = (struct noicerc *)new (sizeof(struct noicerc));
+  rp->r_type = type;
+  rp->r_id = name ? strsto(name) : NULL;
+  rp->r_line = line;
+  rp->r_value = value;
+  rp->r_bp = yp;
+  rp->r_seq = noicenr++;
+  rp->r_np = noicercp;
+  noicercp = rp;
+
+  if ((type == NR_DEF) || (currentFile[0] == 0)) {
+    return;
+  }
+  for (fp = noicescp; fp != NULL; fp = fp->c_np) {
+    if (symeq(currentFile, fp->c_id, 1))
+      break;
+  }
+  if (fp == NULL) {
+    fp = (struct noicesc *)new (sizeof(struct noicesc));
+    fp->c_id = strsto(currentFile);
+    fp->c_num = ++noicesn;
+    fp->c_np = noicescp;
+    noicescp = fp;
+  }
+  rp->r_file = fp->c_num;
+  rp->r_fid = fp->c_id;
+
+  if ((type == NR_LINE) || (currentFunction[0] == 0)) {
+    return;
+  }
+  for (cp = fp->c_fnp; cp != NULL; cp = cp->c_np) {
+    if (symeq(currentFunction, cp->c_id, 1))
+      break;
+  }
+  if (cp == NULL) {
+    cp = (struct noicesc *)new (sizeof(struct noicesc));
+    cp->c_id = strsto(currentFunction);
+    cp->c_num = ++noicesn;
+    if (fp->c_fnp == NULL) {
+      fp->c_fnp = cp;
+    } else {
+      for (sp = fp->c_fnp; sp->c_np != NULL; sp = sp->c_np)
+        ;
+      sp->c_np = cp;
+    }
+  }
+  rp->r_func = cp->c_num;
+  rp->r_cid = cp->c_id;
+}
+
+/*)Function	int	NoICEcmp()
+ *
+ *		VOID *		p1	pointer to first record pointer
+ *		VOID *		p2	pointer to second record pointer
+ *
+ *	The function NoICEcmp() is the qsort() comparison
+ *	function for the saved -jj NoICE records.  The records
+ *	are ordered by file, function, record type rank,
+ *	page, address, line number and the order in which
+ *	they were saved.
+ *
+ *	local variables:
+ *		struct noicerc * r1	pointer to first record
+ *		struct noicerc * r2	pointer to second record
+ *		a_uint	m1		page of first record
+ *		a_uint	m2		page of second record
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+int NoICEcmp(const VOID *p1, const VOID *p2) {
+  struct noicerc *r1, *r2;
+  a_uint m1, m2;
+
+  r1 = *(struct noicerc **)p1;
+  r2 = *(struct noicerc **)p2;
+  if (r1->r_file != r2->r_file)
+    return ((r1->r_file < r2->r_file) ? -1 : 1);
+  if (r1->r_func != r2->r_func)
+    return ((r1->r_func < r2->r_func) ? -1 : 1);
+  if (noicerk[r1->r_type] != noicerk[r2->r_type])
+    return ((noicerk[r1->r_type] < noicerk[r2->r_type]) ? -1 : 1);
+  m1 = (r1->r_bp->b_flag & B_MAP) ? r1->r_bp->b_map : 0;
+  m2 = (r2->r_bp->b_flag & B_MAP) ? r2->r_bp->b_map : 0;
+  if (m1 != m2)
+    return ((m1 < m2) ? -1 : 1);
+  if (r1->r_value != r2->r_value)
+    return ((r1->r_value < r2->r_value) ? -1 : 1);
+  if (r1->r_line != r2->r_line)
+    return ((r1->r_line < r2->r_line) ? -1 : 1);
+  return ((r1->r_seq < r2->r_seq) ? -1 : (r1->r_seq > r2->r_seq));
+}
+
+/*)Function	VOID	NoICEflush()
+ *
+ *	The function NoICEflush() sorts the records saved
+ *	with -jj and writes them to the .noi debug file.
+ *	FILE and FUNC statements are written when the scope
+ *	changes.  Of the LINE records with the same address
+ *	only the one with the highest line number is written.
+ *
+ *	local variables:
+ *		struct noicerc **rpp	array of record pointers
+ *		struct noicerc * rp	pointer to a record
+ *		struct noicerc * np	pointer to the next record
+ *		int	file		current file number
+ *		int	func		current function number
+ *		int	open		a FUNC is open
+ *		int	i		loop counter
+ *
+ *	global variables:
+ *		int	jflag		NoICE Debug flag
+ *		FILE *	jfp		NoICE Debug File handle
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		VOID	free()		c_library
+ *		VOID *	malloc()	c_library
+ *		VOID	PagedAddress()	lknoice.c
+ *		VOID	qsort()		c_library
+ *		VOID	lkexit()	lkmain.c
+ *
+ *	side effects:
+ *		The sorted NoICE records are
+ *		placed in the .noi debug file.
+ */
+
+VOID NoICEflush(void) {
+  struct noicerc **rpp, *rp, *np;
+  int file, func, open, i;
+
+  if ((jflag < 2) || (jfp == NULL) || (noicenr == 0))
+    return;
+
+  rpp = (struct noicerc **)malloc(noicenr * sizeof(struct noicerc *));
+  if (rpp == NULL) {
+    fprintf(stderr, "Out of space!\n");
+    lkexit(ER_FATAL);
+  }
+  for (i = noicenr, rp = noicercp; rp != NULL; rp = rp->r_np) {
+    rpp[--i] = rp;
+  }
+  qsort(rpp, noicenr, sizeof(struct noicerc *), NoICEcmp);
+
+  file = func = open = 0;
+  for (i = 0; i < noicenr; i++) {
+    rp = rpp[i];
+    if ((rp->r_file != file) || (rp->r_func != func)) {
+      if (open) {
+        fprintf(jfp, "ENDF\n");
+        open = 0;
+      }
+      if (rp->r_file != file) {
+        fprintf(jfp, "FILE %s\n", rp->r_fid);
+      }
+      file = rp->r_file;
+      func = rp->r_func;
+      if (func != 0) {
+        open = 1;
+        if (rp->r_type == NR_FN) {
+          fprintf(jfp, "DEF %s ", rp->r_id);
+          PagedAddress(rp->r_value, rp->r_bp);
+          fprintf(jfp, "FUNC %s ", rp->r_id);
+          PagedAddress(rp->r_value, rp->r_bp);
+          continue;
+        } else if (rp->r_type == NR_SFN) {
+          fprintf(jfp, "DEFS %s ", rp->r_id);
+          PagedAddress(rp->r_value, rp->r_bp);
+          fprintf(jfp, "SFUNC %s ", rp->r_id);
+          PagedAddress(rp->r_value, rp->r_bp);
+          continue;
+        } else {
+          fprintf(jfp, "FUNC %s\n", rp->r_cid);
+        }
+      }
+    }
+    switch (rp->r_type) {
+    case NR_DEF:
+    case NR_FN:
+      fprintf(jfp, "DEF %s ", rp->r_id);
+      PagedAddress(rp->r_value, rp->r_bp);
+      break;
+
+    case NR_DEFS:
+    case NR_SFN:
+      fprintf(jfp, "DEFS %s ", rp->r_id);
+      PagedAddress(rp->r_value, rp->r_bp);
+      break;
+
+    case NR_LINE:
+      /*
+       * Only the last line at an address
+       */
+      if (i + 1 < noicenr) {
+        np = rpp[i + 1];
+        if ((np->r_type == NR_LINE) && (np->r_file == rp->r_file) &&
+            (np->r_value == rp->r_value) &&
+            ((np->r_bp->b_flag & B_MAP) == (rp->r_bp->b_flag & B_MAP)) &&
+            (np->r_bp->b_map == rp->r_bp->b_map)) {
+          break;
+        }
+      }
+      fprintf(jfp, "LINE %u ", rp->r_line);
+      PagedAddress(rp->r_value, rp->r_bp);
+      break;
+
+    case NR_EFN:
+      if (open) {
+        fprintf(jfp, "ENDF ");
+        PagedAddress(rp->r_value, rp->r_bp);
+        open = 0;
+      }
+      break;
+    }
+  }
+  if (open) {
+    fprintf(jfp, "ENDF\n");
+  }
+  free(rpp);
+}
+
 /*)Function	VOID	DefineNoIC()
  *
  *		char *		name	pointer to the symbol string
@@ -212,6 +540,7 @@ VOID NoICEmagic(void) {
  *		struct noicefn * tnp	temporary pointer to noicefn structure
  *
  *	global variables:
+ *		int	jflag		NoICE Debug flag
  *		FILE *	jfp		NoICE Debug File handle
  *
  *	functions called:
@@ -272,6 +601,9 @@ void DefineNoICE(char *name, a_uint value, struct bank *yp) {
         DefineStaticFunction(token2, value, yp);
       } else if (symeq(token3, ".EFN", 1) != 0) {
         /* End of function */
+        if (jflag > 1) {
+          DefineFunction(token2, 0, NULL);
+        }
         DefineEndFunction(value, yp);
       }
     } else {
@@ -342,6 +674,10 @@ void DefineNoICE(char *name, a_uint value, struct bank *yp) {
  */
 
 void DefineGlobal(char *name, a_uint value, struct bank *yp) {
+  if (jflag > 1) {
+    NoICEsave(NR_DEF, name, 0, value, yp);
+    return;
+  }
   fprintf(jfp, "DEF %s ", name);
   PagedAddress(value, yp);
 }
@@ -371,6 +707,10 @@ void DefineGlobal(char *name, a_uint value, struct bank *yp) {
  */
 
 void DefineScoped(char *name, a_uint value, struct bank *yp) {
+  if (jflag > 1) {
+    NoICEsave(NR_DEFS, name, 0, value, yp);
+    return;
+  }
   fprintf(jfp, "DEFS %s ", name);
   PagedAddress(value, yp);
 }
@@ -404,6 +744,9 @@ void DefineScoped(char *name, a_uint value, struct bank *yp) {
 void DefineFile(char *name, a_uint value, struct bank *yp) {
   if (symeq(name, currentFile, 1) == 0) {
     strcpy(currentFile, name);
+    if (jflag > 1) {
+      return;
+    }
     if (value != 0) {
       fprintf(jfp, "FILE %s ", name);
       PagedAddress(value, yp);
@@ -442,6 +785,13 @@ void DefineFile(char *name, a_uint value, struct bank *yp) {
  */
 
 void DefineFunction(char *name, a_uint value, struct bank *yp) {
+  if (jflag > 1) {
+    strcpy(currentFunction, name);
+    if (value != 0) {
+      NoICEsave(NR_FN, name, 0, value, yp);
+    }
+    return;
+  }
   if (symeq(name, currentFunction, 1) == 0) {
     strcpy(currentFunction, name);
     if (value != 0) {
@@ -484,6 +834,13 @@ void DefineFunction(char *name, a_uint value, struct bank *yp) {
  */
 
 void DefineStaticFunction(char *name, a_uint value, struct bank *yp) {
+  if (jflag > 1) {
+    strcpy(currentFunction, name);
+    if (value != 0) {
+      NoICEsave(NR_SFN, name, 0, value, yp);
+    }
+    return;
+  }
   if (symeq(name, currentFunction, 1) == 0) {
     strcpy(currentFunction, name);
     if (value != 0) {
@@ -525,7 +882,11 @@ void DefineStaticFunction(char *name, a_uint value, struct bank *yp) {
 
 void DefineEndFunction(a_uint value, struct bank *yp) {
   if (currentFunction[0] != 0) {
-    if (value != 0) {
+    if (jflag > 1) {
+      if (value != 0) {
+        NoICEsave(NR_EFN, currentFunction, 0, value, yp);
+      }
+    } else if (value != 0) {
       fprintf(jfp, "ENDF ");
       PagedAddress(value, yp);
     } else {
@@ -569,6 +930,10 @@ void DefineLine(char *lineString, a_uint value, struct bank *yp) {
   while ((indigit = digit(*lineString++, 10)) >= 0) {
     lineNumber = 10 * lineNumber + indigit;
   }
+  if (jflag > 1) {
+    NoICEsave(NR_LINE, NULL, lineNumber, value, yp);
+    return;
+  }
   fprintf(jfp, "LINE %u ", lineNumber);
   PagedAddress(value, yp);
 }
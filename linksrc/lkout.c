@@ -44,10 +44,37 @@
  *		VOID	sflush()
  *		VOID	dbx()
  *		VOID	dflush()
- *
- *	lkout.c contains no local variables.
+ *		VOID	rxx()
+ *		VOID	rstore()
+ *		VOID	rwrite()
+ *		VOID	rpack()
+ *		struct rimg *	rfind()
+ *		int	rtlim()
+ *		int	rtmax()
+ *		VOID	recbgn()
+ *		VOID	recput()
+ *		VOID	recdat()
+ *		VOID	recend()
+ *
+ *	lkout.c contains the following local variables:
+ *		struct rimg *	rimgp	first binary image
+ *		struct rimg *	rimcp	binary image of ofp
+ *		char	recbuf[]	output record
+ *		char *	recp		output record pointer
+ *		a_uint	recsum		output record checksum
+ *		int	recbin		binary output record
+ *		char	rechex[]	hexadecimal digits
  */
 
+static struct rimg *rimgp = NULL;
+static struct rimg *rimcp = NULL;
+
+static char recbuf[2 * NMAX + 32];
+static char *recp;
+static a_uint recsum;
+static int recbin;
+static char rechex[] = "0123456789ABCDEF";
+
 /*)Function	lkout(i)
  *
  *		int	i		1 - process data
@@ -62,6 +89,7 @@
  *	global variables:
  *		int	oflag		output type flag
  *		int	obj_flag	Output enabled flag
+ *		int	pkflag		Packed output flag
  *		a_uint	pc		Current relocation address
  *		int	pcb		Current pc bytes per address
  *
@@ -69,6 +97,7 @@
  *		VOID	ixx()		lkout.c
  *		VOID	sxx()		lkout.c
  *		VOID	dbx()		lkout.c
+ *		VOID	rxx()		lkout.c
  *
  *	side effects:
  *		The REL data is output in the required format.
@@ -93,6 +122,14 @@ int i;
     adb_xb(pc, 0);
   }
 
+  /*
+   * Binary and Packed Formats
+   */
+  if ((oflag >= 4) || pkflag) {
+    rxx(i);
+    return;
+  }
+
   /*
    * Intel Formats
    */
@@ -117,6 +154,8 @@ int i;
  *
  *	The function lkflush() dispatches
  *	to the required data flushing routine.
+ *	The binary and packed formats are written
+ *	from memory by lkout(0) and need no flush.
  *
  *	local variables:
  *		none
@@ -124,6 +163,7 @@ int i;
  *	global variables:
  *		int	oflag		output type flag
  *		FILE *	ofp		output file handle
+ *		int	pkflag		Packed output flag
  *
  *	functions called:
  *		VOID	iflush()	lkout.c
@@ -136,7 +176,7 @@ int i;
  */
 
 VOID lkflush() {
-  if (ofp == NULL) {
+  if ((ofp == NULL) || pkflag) {
     return;
   }
 
@@ -223,12 +263,12 @@ VOID lkflush() {
  *	the relocated data.
  *
  *	local variables:
- *		a_uint	chksum		byte checksum
  *		a_uint	lo_addr		address within segment
  *		a_uint	hi_addr		segment number
  *		int	i		loop counter
  *		a_uint	j		temporary
  *		int	k		loop counter
+ *		int	max		data bytes per record
  *		struct sym *sp		symbol pointer
  *		a_uint	symadr		symbol address
  *
@@ -246,8 +286,11 @@ VOID lkflush() {
  *		a_uint	rtadr2		address temporary
  *
  *	functions called:
- *		int	fprintf()	c_library
  *		VOID	iflush()	lkout.c
+ *		VOID	recbgn()	lkout.c
+ *		VOID	recend()	lkout.c
+ *		VOID	recput()	lkout.c
+ *		int	rtmax()		lkout.c
  *
  *	side effects:
  *		The data is placed into the output buffer.
@@ -262,15 +305,16 @@ VOID lkflush() {
  *	2	Record Type Field
  *	2	Checksum Field
  *
- *	Plus 32 data bytes (64 characters)
+ *	Plus IXXMAXBYTES data bytes (64 characters)
+ *	or the -in record length (up to 255 bytes).
  */
 
 VOID ixx(i)
 int i;
 {
-  int k;
+  int k, max;
   struct sym *sp;
-  a_uint j, lo_addr, hi_addr, symadr, chksum;
+  a_uint j, lo_addr, hi_addr, symadr;
 
   if (i) {
     if (hilo == 0) {
@@ -299,6 +343,7 @@ int i;
     for (i = 0, rtadr2 = 0; i < a_bytes; i++) {
       rtadr2 = (rtadr2 << 8) | rtval[i];
     }
+    max = rtmax();
     if ((rtadr2 != rtadr1) || rtaflg) {
       /*
        * data bytes not contiguous between records
@@ -308,9 +353,9 @@ int i;
       rtaflg = 0;
     }
     for (k = a_bytes; k < rtcnt; k++) {
-      if (rtflg[k]) {
+      if (rtflg[k] == 1) {
         rtbuf[(int)(rtadr1++ - rtadr0)] = rtval[k];
-        if (rtadr1 - rtadr0 == IXXMAXBYTES) {
+        if (rtadr1 - rtadr0 == (a_uint)max) {
           iflush();
         }
       }
@@ -322,33 +367,24 @@ int i;
       lo_addr = symadr & 0xffff;
       if (a_bytes > 2) {
         hi_addr = (symadr >> 16) & 0xffff;
-        chksum = 0x00;
-        chksum += hi_addr;
-        chksum += hi_addr >> 8;
-        chksum += 0x04;
-#ifdef LONGINT
-        fprintf(ofp, ":00%04lX04%02lX\n", hi_addr, (~chksum + 1) & 0x00ff);
-#else
-        fprintf(ofp, ":00%04X04%02X\n", hi_addr, (~chksum + 1) & 0x00ff);
-#endif
-      }
-      chksum = 0x00;
-      chksum += lo_addr;
-      chksum += lo_addr >> 8;
-      if (o1flag != 0) {
-        j = 0x01;
-      } else {
-        j = 0x03;
+        recbgn(":");
+        recput(0, 1);
+        recput(hi_addr, 2);
+        recput(4, 1);
+        recend(2);
       }
-      chksum += j;
-#ifdef LONGINT
-      fprintf(ofp, ":00%04lX%02lX%02lX\n", lo_addr, j, (~chksum + 1) & 0x00ff);
-#else
-      fprintf(ofp, ":00%04X%02X%02X\n", lo_addr, j, (~chksum + 1) & 0x00ff);
-#endif
+      recbgn(":");
+      recput(0, 1);
+      recput(lo_addr, 2);
+      recput((o1flag != 0) ? 0x01 : 0x03, 1);
+      recend(2);
     }
 
-    fprintf(ofp, ":00000001FF\n");
+    recbgn(":");
+    recput(0, 1);
+    recput(0, 2);
+    recput(1, 1);
+    recend(2);
   }
 }
 
@@ -358,23 +394,22 @@ int i;
  *	in the standard Intel format.
  *
  *	local variables:
- *		a_uint	chksum		byte checksum
- *		a_uint	lo_addr		address within segment
  *		a_uint	hi_addr		segment number
- *		int	i		loop counter
  *		int	max		number of data bytes
- *		int	reclen		record length
  *
  *	global variables:
  *		int	a_bytes		T Line Address Bytes
- *		FILE *	ofp		output file handle
  *		int	rtaflg		first output flag
  *		char	rtbuf[]		output buffer
  *		a_uint	rtadr0		address temporary
  *		a_uint	rtadr1		address temporary
+ *		a_uint	rtadr2		address temporary
  *
  *	functions called:
- *		int	fprintf()	c_library
+ *		VOID	recbgn()	lkout.c
+ *		VOID	recdat()	lkout.c
+ *		VOID	recend()	lkout.c
+ *		VOID	recput()	lkout.c
  *
  *	side effects:
  *		The data is output to the file defined by ofp.
@@ -385,62 +420,47 @@ int i;
  * of G. Osborn, gary@s-4.com.
  * The new version concatenates the assembler
  * output records when they represent contiguous
- * memory segments to produce IXXMAXBYTES data byte
- * Intel Hex output lines whenever possible, resulting
+ * memory segments to produce IXXMAXBYTES (or -in)
+ * data byte Intel Hex output lines whenever possible, resulting
  * in a substantial reduction in file size.
  * More importantly, the download time
  * to the target system is much improved.
  */
 
 VOID iflush() {
-  int i, max, reclen;
-  a_uint chksum, lo_addr, hi_addr;
+  int max;
+  a_uint hi_addr;
 
   max = (int)(rtadr1 - rtadr0);
   if (max) {
+    lkst.st_cnt[ST_OREC] += 1;
+    lkst.st_cnt[ST_OBYTES] += max;
 
     /*
      * Only the ":" and the checksum itself are excluded
      * from the checksum.  The record length includes
      * only the data bytes.
      */
-    lo_addr = rtadr0 & 0xffff;
-    reclen = max;
-    chksum = reclen;
-    chksum += lo_addr;
-    chksum += lo_addr >> 8;
-#ifdef LONGINT
-    fprintf(ofp, ":%02X%04lX00", reclen, lo_addr);
-#else
-    fprintf(ofp, ":%02X%04X00", reclen, lo_addr);
-#endif
-    for (i = 0; i < max; i++) {
-      chksum += rtbuf[i];
-      fprintf(ofp, "%02X", rtbuf[i] & 0x00ff);
-    }
+    recbgn(":");
+    recput((a_uint)max, 1);
+    recput(rtadr0, 2);
+    recput(0, 1);
+    recdat(rtbuf, max);
     /*
      * 2's complement
      */
-#ifdef LONGINT
-    fprintf(ofp, "%02lX\n", (~chksum + 1) & 0x00ff);
-#else
-    fprintf(ofp, "%02X\n", (~chksum + 1) & 0x00ff);
-#endif
+    recend(2);
     rtadr0 = rtadr1;
   }
 
   if (a_bytes > 2) {
     hi_addr = (rtadr2 >> 16) & 0xffff;
     if ((hi_addr != (rtadr1 >> 16)) || rtaflg) {
-      chksum = 0x00;
-      chksum += hi_addr;
-      chksum += hi_addr >> 8;
-      chksum += 0x04;
-#ifdef LONGINT
-      fprintf(ofp, ":00%04lX04%02lX\n", hi_addr, (~chksum + 1) & 0x00ff);
-#else
-      fprintf(ofp, ":00%04X04%02X\n", hi_addr, (~chksum + 1) & 0x00ff);
-#endif
+      recbgn(":");
+      recput(0, 1);
+      recput(hi_addr, 2);
+      recput(4, 1);
+      recend(2);
     }
   }
 }
@@ -504,14 +524,11 @@ VOID iflush() {
  *	the relocated data.
  *
  *	local variables:
- *		a_uint	addr		address temporary
- *		a_uint	chksum		byte checksum
- *		char *	frmt		format string pointer
+ *		char *	frmt		record type string
  *		int	i		loop counter
  *		a_uint	j		temporary
  *		int	k		loop counter
- *		int	max		number of data bytes
- *		int	reclen		record length
+ *		int	max		data bytes per record
  *		struct sym *sp		symbol pointer
  *		a_uint	symadr		symbol address
  *
@@ -528,7 +545,10 @@ VOID iflush() {
  *		a_uint	rtadr2		address temporary
  *
  *	functions called:
- *		int	fprintf()	c_library
+ *		VOID	recbgn()	lkout.c
+ *		VOID	recend()	lkout.c
+ *		VOID	recput()	lkout.c
+ *		int	rtmax()		lkout.c
  *		VOID	sflush()	lkout.c
  *
  *	side effects:
@@ -543,7 +563,8 @@ VOID iflush() {
  *	4/6/8	Load Address Field
  *	2	Checksum Field
  *
- *	Plus 32 data bytes (64 characters)
+ *	Plus SXXMAXBYTES data bytes (64 characters)
+ *	or the -sn record length (up to 252 bytes).
  */
 
 VOID sxx(i)
@@ -551,8 +572,8 @@ int i;
 {
   struct sym *sp;
   char *frmt;
-  int k, reclen;
-  a_uint j, addr, symadr, chksum;
+  int k, max;
+  a_uint j, symadr;
 
   if (i) {
     if (hilo == 0) {
@@ -581,6 +602,7 @@ int i;
     for (i = 0, rtadr2 = 0; i < a_bytes; i++) {
       rtadr2 = (rtadr2 << 8) | rtval[i];
     }
+    max = rtmax();
 
     if (rtadr2 != rtadr1) {
       /*
@@ -590,9 +612,9 @@ int i;
       rtadr0 = rtadr1 = rtadr2;
     }
     for (k = a_bytes; k < rtcnt; k++) {
-      if (rtflg[k]) {
+      if (rtflg[k] == 1) {
         rtbuf[(int)(rtadr1++ - rtadr0)] = rtval[k];
-        if (rtadr1 - rtadr0 == SXXMAXBYTES) {
+        if (rtadr1 - rtadr0 == (a_uint)max) {
           sflush();
         }
       }
@@ -605,59 +627,31 @@ int i;
      * include the address bytes, the data bytes,
      * and the checksum.
      */
-    reclen = 1 + a_bytes;
-    chksum = reclen;
     sp = lkpsym(".__.END.", 0);
     if (sp && (sp->s_axp->a_bap->a_ofp == ofp)) {
       symadr = symval(sp);
-      for (i = 0, addr = symadr; i < a_bytes; i++, addr >>= 8) {
-        chksum += addr;
-      }
     } else {
       symadr = 0;
     }
-#ifdef LONGINT
     switch (a_bytes) {
     default:
     case 2:
-      frmt = "S9%02X%04lX";
-      addr = symadr & 0x0000ffffl;
+      frmt = "S9";
       break;
     case 3:
-      frmt = "S8%02X%06lX";
-      addr = symadr & 0x00ffffffl;
+      frmt = "S8";
       break;
     case 4:
-      frmt = "S7%02X%08lX";
-      addr = symadr & 0xffffffffl;
+      frmt = "S7";
       break;
     }
-#else
-    switch (a_bytes) {
-    default:
-    case 2:
-      frmt = "S9%02X%04X";
-      addr = symadr & 0x0000ffff;
-      break;
-    case 3:
-      frmt = "S8%02X%06X";
-      addr = symadr & 0x00ffffff;
-      break;
-    case 4:
-      frmt = "S7%02X%08X";
-      addr = symadr & 0xffffffff;
-      break;
-    }
-#endif
-    fprintf(ofp, frmt, reclen, addr);
+    recbgn(frmt);
+    recput((a_uint)(1 + a_bytes), 1);
+    recput(symadr, a_bytes);
     /*
      * 1's complement
      */
-#ifdef LONGINT
-    fprintf(ofp, "%02lX\n", (~chksum) & 0x00ff);
-#else
-    fprintf(ofp, "%02X\n", (~chksum) & 0x00ff);
-#endif
+    recend(1);
   }
 }
 
@@ -667,22 +661,20 @@ int i;
  *	in the standard Motorola format.
  *
  *	local variables:
- *		a_uint	addr		address temporary
- *		a_uint	chksum		byte checksum
- *		char *	frmt		format string pointer
- *		int	i		loop counter
+ *		char *	frmt		record type string
  *		int	max		number of data bytes
- *		int	reclen		record length
  *
  *	global variables:
  *		int	a_bytes		T Line Address Bytes
- *		FILE *	ofp		output file handle
  *		char	rtbuf[]		output buffer
  *		a_uint	rtadr0		address temporary
  *		a_uint	rtadr1		address temporary
  *
  *	functions called:
- *		int	fprintf()	c_library
+ *		VOID	recbgn()	lkout.c
+ *		VOID	recdat()	lkout.c
+ *		VOID	recend()	lkout.c
+ *		VOID	recput()	lkout.c
  *
  *	side effects:
  *		The data is output to the file defined by ofp.
@@ -692,8 +684,8 @@ int i;
  * Written by G. Osborn, gary@s-4.com, 6-17-98.
  * The new version concatenates the assembler
  * output records when they represent contiguous
- * memory segments to produce SXXMAXBYTES data byte
- * S_ output lines whenever possible, resulting
+ * memory segments to produce SXXMAXBYTES (or -sn)
+ * data byte S_ output lines whenever possible, resulting
  * in a substantial reduction in file size.
  * More importantly, the download time
  * to the target system is much improved.
@@ -701,13 +693,14 @@ int i;
 
 VOID sflush() {
   char *frmt;
-  int i, max, reclen;
-  a_uint addr, chksum;
+  int max;
 
   max = (int)(rtadr1 - rtadr0);
   if (max == 0) {
     return;
   }
+  lkst.st_cnt[ST_OREC] += 1;
+  lkst.st_cnt[ST_OBYTES] += max;
 
   /*
    * Only the "S_" and the checksum itself are excluded
@@ -716,57 +709,26 @@ VOID sflush() {
    * include the address bytes, the data bytes,
    * and the checksum.
    */
-  reclen = max + 1 + a_bytes;
-  chksum = reclen;
-  for (i = 0, addr = rtadr0; i < a_bytes; i++, addr >>= 8) {
-    chksum += addr;
-  }
-#ifdef LONGINT
-  switch (a_bytes) {
-  default:
-  case 2:
-    frmt = "S1%02X%04lX";
-    addr = rtadr0 & 0x0000ffffl;
-    break;
-  case 3:
-    frmt = "S2%02X%06lX";
-    addr = rtadr0 & 0x00ffffffl;
-    break;
-  case 4:
-    frmt = "S3%02X%08lX";
-    addr = rtadr0 & 0xffffffffl;
-    break;
-  }
-#else
   switch (a_bytes) {
   default:
   case 2:
-    frmt = "S1%02X%04X";
-    addr = rtadr0 & 0x0000ffff;
+    frmt = "S1";
     break;
   case 3:
-    frmt = "S2%02X%06X";
-    addr = rtadr0 & 0x00ffffff;
+    frmt = "S2";
     break;
   case 4:
-    frmt = "S3%02X%08X";
-    addr = rtadr0 & 0xffffffff;
+    frmt = "S3";
     break;
   }
-#endif
-  fprintf(ofp, frmt, reclen, addr);
-  for (i = 0; i < max; i++) {
-    chksum += rtbuf[i];
-    fprintf(ofp, "%02X", rtbuf[i] & 0x00ff);
-  }
+  recbgn(frmt);
+  recput((a_uint)(max + 1 + a_bytes), 1);
+  recput(rtadr0, a_bytes);
+  recdat(rtbuf, max);
   /*
    * 1's complement
    */
-#ifdef LONGINT
-  fprintf(ofp, "%02lX\n", (~chksum) & 0x00ff);
-#else
-  fprintf(ofp, "%02X\n", (~chksum) & 0x00ff);
-#endif
+  recend(1);
   rtadr0 = rtadr1;
 }
 
@@ -809,6 +771,7 @@ VOID sflush() {
  *
  *	local variables:
  *		int	k		loop counter
+ *		int	max		data bytes per record
  *		struct sym *sp		symbol pointer
  *		a_uint	symadr		start address
  *
@@ -824,8 +787,11 @@ VOID sflush() {
  *		a_uint	rtadr2		address temporary
  *
  *	functions called:
- *		int	putc()		c_library
  *		VOID	dflush()	lkout.c
+ *		VOID	recbgn()	lkout.c
+ *		VOID	recend()	lkout.c
+ *		VOID	recput()	lkout.c
+ *		int	rtmax()		lkout.c
  *
  *	side effects:
  *		The data is placed into the output buffer.
@@ -835,7 +801,7 @@ VOID dbx(i)
 int i;
 {
   struct sym *sp;
-  int k;
+  int k, max;
   a_uint j, symadr;
 
   if (i) {
@@ -865,6 +831,7 @@ int i;
     for (i = 0, rtadr2 = 0; i < a_bytes; i++) {
       rtadr2 = (rtadr2 << 8) | rtval[i];
     }
+    max = rtmax();
 
     if (rtadr2 != rtadr1) {
       /*
@@ -874,9 +841,9 @@ int i;
       rtadr0 = rtadr1 = rtadr2;
     }
     for (k = a_bytes; k < rtcnt; k++) {
-      if (rtflg[k]) {
+      if (rtflg[k] == 1) {
         rtbuf[(int)(rtadr1++ - rtadr0)] = rtval[k];
-        if (rtadr1 - rtadr0 == (unsigned)(DBXMAXBYTES - (2 * a_bytes) - 1)) {
+        if (rtadr1 - rtadr0 == (a_uint)max) {
           dflush();
         }
       }
@@ -889,34 +856,14 @@ int i;
     } else {
       symadr = 0;
     }
+    recbgn(NULL);
     /* Terminator */
-    putc(0xFF, ofp);
-
+    recput(0xFF, 1);
     /* Size (0) */
-    switch (a_bytes) {
-    case 4:
-      putc((int)(0 >> 24) & 0xFF, ofp);
-    case 3:
-      putc((int)(0 >> 16) & 0xFF, ofp);
-    default:
-    case 2:
-      putc((int)(0 >> 8) & 0xFF, ofp);
-      putc((int)(0 >> 0) & 0xFF, ofp);
-      break;
-    }
-
+    recput(0, a_bytes);
     /* Starting Address */
-    switch (a_bytes) {
-    case 4:
-      putc((int)(symadr >> 24) & 0xFF, ofp);
-    case 3:
-      putc((int)(symadr >> 16) & 0xFF, ofp);
-    default:
-    case 2:
-      putc((int)(symadr >> 8) & 0xFF, ofp);
-      putc((int)(symadr >> 0) & 0xFF, ofp);
-      break;
-    }
+    recput(symadr, a_bytes);
+    recend(0);
   }
 }
 
@@ -926,17 +873,19 @@ int i;
  *	in the Disk BASIC loadable format
  *
  *	local variables:
- *		int	i		loop counter
  *		int	max		number of data bytes
  *
  *	global variables:
- *		FILE *	ofp		output file handle
+ *		int	a_bytes		T Line Address Bytes
  *		char	rtbuf[]		output buffer
  *		a_uint	rtadr0		address temporary
  *		a_uint	rtadr1		address temporary
  *
  *	functions called:
- *		int	putc()		c_library
+ *		VOID	recbgn()	lkout.c
+ *		VOID	recdat()	lkout.c
+ *		VOID	recend()	lkout.c
+ *		VOID	recput()	lkout.c
  *
  *	side effects:
  *		The data is output to the file defined by ofp.
@@ -947,45 +896,766 @@ int i;
  */
 
 VOID dflush() {
-  int i, max;
+  int max;
 
   max = (int)(rtadr1 - rtadr0);
   if (max == 0) {
     return;
   }
+  lkst.st_cnt[ST_OREC] += 1;
+  lkst.st_cnt[ST_OBYTES] += max;
 
+  recbgn(NULL);
   /* Preamble Byte */
-  putc(0, ofp);
-
+  recput(0, 1);
   /* Record Size */
-  switch (a_bytes) {
-  case 4:
-    putc((int)(max >> 24) & 0xFF, ofp);
-  case 3:
-    putc((int)(max >> 16) & 0xFF, ofp);
+  recput((a_uint)max, a_bytes);
+  /* Load Address */
+  recput(rtadr0, a_bytes);
+  recdat(rtbuf, max);
+  recend(0);
+
+  rtadr0 = rtadr1;
+}
+
+/*Binary Formats
+ *
+ *      Raw Binary (-r)      -  The relocated data of an output file
+ *                              as a memory image, starting at the
+ *                              lowest address written.  Gaps between
+ *                              the data are filled with the fill
+ *                              byte (-rn, default 255).
+ *
+ *      Segmented Binary (-rr)
+ *
+ *      File Mark Field      -  The four ascii characters 'ASXS'.
+ *
+ *      Segment Records      -  One record for each contiguous segment
+ *                              of data in increasing address order.
+ *
+ *           Load Address    -  4-bytes, high byte first
+ *           Segment Length  -  4-bytes, high byte first
+ *           Data Bytes      -  Segment Length data bytes
+ *
+ *      End Record           -  A final record with a Segment Length
+ *                              of 0 and the execution address
+ *                              (.__.END.) as the Load Address.
+ */
+
+/*)Function	rxx(i)
+ *
+ *		int	i		1 - process data
+ *					0 - end of data
+ *
+ *	The function rxx() places the relocated data into the
+ *	binary image of the current output file.  At the end
+ *	of data the image is written to the output file in
+ *	a binary format or as packed records.
+ *
+ *	local variables:
+ *		char	buf[]		data bytes of the T line
+ *		int	k		loop counter
+ *		int	n		number of data bytes
+ *		a_uint	j		temporary
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		int	hilo		byte order
+ *		int	rtcnt		count of data words
+ *		int	rtflg[]		output the data flag
+ *		a_uint	rtval[]		relocated data
+ *		a_uint	rtadr2		address temporary
+ *
+ *	functions called:
+ *		VOID	rpack()		lkout.c
+ *		VOID	rstore()	lkout.c
+ *		VOID	rwrite()	lkout.c
+ *
+ *	side effects:
+ *		The data is placed into the binary image.
+ */
+
+VOID rxx(i)
+int i;
+{
+  char buf[NTXT];
+  int k, n;
+  a_uint j;
+
+  if (i) {
+    if (hilo == 0) {
+      switch (a_bytes) {
+      default:
+      case 2:
+        j = rtval[0];
+        rtval[0] = rtval[1];
+        rtval[1] = j;
+        break;
+      case 3:
+        j = rtval[0];
+        rtval[0] = rtval[2];
+        rtval[2] = j;
+        break;
+      case 4:
+        j = rtval[0];
+        rtval[0] = rtval[3];
+        rtval[3] = j;
+        j = rtval[2];
+        rtval[2] = rtval[1];
+        rtval[1] = j;
+        break;
+      }
+    }
+    for (i = 0, rtadr2 = 0; i < a_bytes; i++) {
+      rtadr2 = (rtadr2 << 8) | rtval[i];
+    }
+    for (k = a_bytes, n = 0; k < rtcnt; k++) {
+      if (rtflg[k] == 1) {
+        buf[n++] = (char)rtval[k];
+      }
+    }
+    if (n != 0) {
+      rstore(rtadr2, buf, n);
+    }
+  } else if (oflag >= 4) {
+    rwrite();
+  } else {
+    rpack();
+  }
+}
+
+/*)Function	rstore(addr, p, n)
+ *
+ *		a_uint	addr		byte address
+ *		char *	p		pointer to the data bytes
+ *		int	n		number of data bytes
+ *
+ *	The function rstore() copies n data bytes to the
+ *	binary image of the output file ofp.  The data is
+ *	appended to the last segment written when it is
+ *	contiguous, else the segment containing or ending
+ *	at addr is used or a new segment is linked in
+ *	address order.  Segments overlapped by the data
+ *	are merged, the new data replacing the old.
+ *
+ *	local variables:
+ *		struct rimg *	ip	binary image
+ *		struct rseg *	rp	segment
+ *		struct rseg *	tp	segment
+ *		a_uint		m	segment end address
+ *
+ *	global variables:
+ *		FILE *	ofp		output file handle
+ *		struct rimg *	rimgp	first binary image
+ *		struct rimg *	rimcp	binary image of ofp
+ *
+ *	functions called:
+ *		VOID	free()		c_library
+ *		VOID *	memcpy()	c_library
+ *		VOID *	new()		lksym.c
+ *		VOID *	realloc()	c_library
+ *
+ *	side effects:
+ *		The binary image is updated.
+ */
+
+VOID rstore(addr, p, n)
+a_uint addr;
+char *p;
+int n;
+{
+  struct rimg *ip;
+  struct rseg *rp, *tp;
+  a_uint m;
+
+  /*
+   * Find the image of the output file
+   */
+  if ((rimcp == NULL) || (rimcp->i_fp != ofp)) {
+    for (ip = rimgp; ip != NULL; ip = ip->i_ip) {
+      if (ip->i_fp == ofp)
+        break;
+    }
+    if (ip == NULL) {
+      ip = (struct rimg *)new (sizeof(struct rimg));
+      ip->i_fp = ofp;
+      ip->i_ip = rimgp;
+      rimgp = ip;
+    }
+    rimcp = ip;
+  }
+  ip = rimcp;
+
+  /*
+   * Find the segment containing or ending at addr
+   */
+  rp = ip->i_lrp;
+  if ((rp == NULL) || (addr < rp->r_addr) || (addr > rp->r_addr + rp->r_len)) {
+    for (tp = NULL, rp = ip->i_rp; rp != NULL; tp = rp, rp = rp->r_rp) {
+      if (addr < rp->r_addr) {
+        rp = NULL;
+        break;
+      }
+      if (addr <= rp->r_addr + rp->r_len)
+        break;
+    }
+    if (rp == NULL) {
+      rp = (struct rseg *)new (sizeof(struct rseg));
+      rp->r_addr = addr;
+      if (tp == NULL) {
+        rp->r_rp = ip->i_rp;
+        ip->i_rp = rp;
+      } else {
+        rp->r_rp = tp->r_rp;
+        tp->r_rp = rp;
+      }
+    }
+  }
+  ip->i_lrp = rp;
+
+  /*
+   * Copy the data
+   */
+  m = addr + n - rp->r_addr;
+  if (m > rp->r_size) {
+    rp->r_size = (m < 4096) ? 4096 : 2 * m;
+    if ((rp->r_buf = (char *)realloc(rp->r_buf, rp->r_size)) == NULL) {
+      fprintf(stderr, "Out of space!\n");
+      lkexit(ER_FATAL);
+    }
+  }
+  memcpy(rp->r_buf + (addr - rp->r_addr), p, n);
+  if (m > rp->r_len) {
+    rp->r_len = m;
+  }
+
+  /*
+   * Merge the following segments
+   * overlapped or reached by the data
+   */
+  while (((tp = rp->r_rp) != NULL) && (tp->r_addr <= rp->r_addr + rp->r_len)) {
+    m = tp->r_addr + tp->r_len - rp->r_addr;
+    if (m > rp->r_len) {
+      if (m > rp->r_size) {
+        rp->r_size = m;
+        if ((rp->r_buf = (char *)realloc(rp->r_buf, rp->r_size)) == NULL) {
+          fprintf(stderr, "Out of space!\n");
+          lkexit(ER_FATAL);
+        }
+      }
+      memcpy(rp->r_buf + rp->r_len, tp->r_buf + (tp->r_len - (m - rp->r_len)),
+             m - rp->r_len);
+      rp->r_len = m;
+    }
+    rp->r_rp = tp->r_rp;
+    free(tp->r_buf);
+  }
+}
+
+/*)Function	rwrite()
+ *
+ *	The function rwrite() writes the binary image of the
+ *	output file ofp in the raw (-r) or segmented (-rr)
+ *	format and releases the image.
+ *
+ *	local variables:
+ *		char	buf[]		fill bytes
+ *		struct rimg *	ip	binary image
+ *		struct rseg *	rp	segment
+ *		struct rseg *	tp	segment
+ *		struct sym *	sp	symbol pointer
+ *		a_uint		m	fill bytes remaining
+ *		a_uint		pos	file address
+ *		int		n	fill bytes written
+ *		a_uint		symadr	start address
+ *
+ *	global variables:
+ *		a_uint	a_mask		address mask
+ *		FILE *	ofp		output file handle
+ *		int	oflag		output type flag
+ *		int	rfill		binary output fill byte
+ *		struct lkstat	lkst	link statistics
+ *
+ *	functions called:
+ *		VOID	free()		c_library
+ *		size_t	fwrite()	c_library
+ *		sym *	lkpsym()	lksym.c
+ *		VOID *	memset()	c_library
+ *		int	putc()		c_library
+ *		struct rimg *	rfind()	lkout.c
+ *		a_uint	symval()	lksym.c
+ *
+ *	side effects:
+ *		The binary output file is written.
+ */
+
+VOID rwrite() {
+  char buf[4096];
+  struct rimg *ip;
+  struct rseg *rp, *tp;
+  struct sym *sp;
+  a_uint m, pos, symadr;
+  int n;
+
+  ip = rfind();
+  rp = (ip != NULL) ? ip->i_rp : NULL;
+
+  if (oflag == 4) {
+    /*
+     * Raw Binary
+     */
+    memset(buf, rfill, sizeof(buf));
+    pos = (rp != NULL) ? rp->r_addr : 0;
+    for (; rp != NULL; rp = rp->r_rp) {
+      for (m = rp->r_addr - pos; m != 0; m -= n) {
+        n = (m > sizeof(buf)) ? sizeof(buf) : (int)m;
+        fwrite(buf, 1, n, ofp);
+      }
+      fwrite(rp->r_buf, 1, rp->r_len, ofp);
+      pos = rp->r_addr + rp->r_len;
+      lkst.st_cnt[ST_OREC] += 1;
+      lkst.st_cnt[ST_OBYTES] += rp->r_len;
+    }
+  } else {
+    /*
+     * Segmented Binary
+     */
+    fwrite("ASXS", 1, 4, ofp);
+    for (; rp != NULL; rp = rp->r_rp) {
+      for (n = 24; n >= 0; n -= 8) {
+        putc((int)(rp->r_addr >> n) & 0xFF, ofp);
+      }
+      for (n = 24; n >= 0; n -= 8) {
+        putc((int)(rp->r_len >> n) & 0xFF, ofp);
+      }
+      fwrite(rp->r_buf, 1, rp->r_len, ofp);
+      lkst.st_cnt[ST_OREC] += 1;
+      lkst.st_cnt[ST_OBYTES] += rp->r_len;
+    }
+    sp = lkpsym(".__.END.", 0);
+    if (sp && (sp->s_axp->a_bap->a_ofp == ofp)) {
+      symadr = symval(sp) & a_mask;
+    } else {
+      symadr = 0;
+    }
+    for (n = 24; n >= 0; n -= 8) {
+      putc((int)(symadr >> n) & 0xFF, ofp);
+    }
+    for (n = 0; n < 4; n++) {
+      putc(0, ofp);
+    }
+  }
+
+  /*
+   * Release the image
+   */
+  if (ip != NULL) {
+    for (rp = ip->i_rp; rp != NULL; rp = tp) {
+      tp = rp->r_rp;
+      free(rp->r_buf);
+    }
+  }
+}
+
+/*)Function	rpack()
+ *
+ *	The function rpack() writes the image of the output
+ *	file ofp as Intel Hex (-ii), Motorola S (-ss), or
+ *	Disk BASIC (-tt) records.  The records are output in
+ *	increasing address order, each record is filled to
+ *	the maximum length of the format and a record ends
+ *	only at the end of a segment (or a 64K boundary for
+ *	the Intel Hex format).  The end of data records are
+ *	output by ixx(0), sxx(0), or dbx(0) and the image
+ *	is released.
+ *
+ *	local variables:
+ *		struct rimg *	ip	binary image
+ *		struct rseg *	rp	segment
+ *		struct rseg *	tp	segment
+ *		a_uint		addr	record address
+ *		a_uint		hi	upper 16 bits of the address
+ *		a_uint		m	segment offset
+ *		int		max	maximum record length
+ *		int		n	record length
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		int	oflag		output type flag
+ *		char	rtbuf[]		output buffer
+ *		a_uint	rtadr0		address temporary
+ *		a_uint	rtadr1		address temporary
+ *		a_uint	rtadr2		address temporary
+ *		int	rtaflg		force an Intel Hex extended
+ *					address record
+ *
+ *	functions called:
+ *		VOID	dbx()		lkout.c
+ *		VOID	dflush()	lkout.c
+ *		VOID	free()		c_library
+ *		VOID	iflush()	lkout.c
+ *		VOID	ixx()		lkout.c
+ *		VOID *	memcpy()	c_library
+ *		struct rimg *	rfind()	lkout.c
+ *		int	rtmax()		lkout.c
+ *		VOID	sflush()	lkout.c
+ *		VOID	sxx()		lkout.c
+ *
+ *	side effects:
+ *		The packed records are written to the output file.
+ */
+
+VOID rpack() {
+  struct rimg *ip;
+  struct rseg *rp, *tp;
+  a_uint addr, hi, m;
+  int max, n;
+
+  max = rtmax();
+  ip = rfind();
+  rtadr0 = rtadr1 = 0;
+  rtaflg = 1;
+  hi = 0;
+  for (rp = (ip != NULL) ? ip->i_rp : NULL; rp != NULL; rp = rp->r_rp) {
+    for (m = 0; m < rp->r_len; m += n) {
+      addr = rp->r_addr + m;
+      n = ((rp->r_len - m) > (a_uint)max) ? max : (int)(rp->r_len - m);
+      if ((oflag == 1) && (((addr & 0xFFFF) + n) > 0x10000)) {
+        n = (int)(0x10000 - (addr & 0xFFFF));
+      }
+      if ((addr >> 16) != hi) {
+        hi = addr >> 16;
+        rtaflg = 1;
+      }
+      /*
+       * Output the previous record
+       */
+      rtadr2 = addr;
+      switch (oflag) {
+      default:
+      case 1:
+        iflush();
+        break;
+      case 2:
+        sflush();
+        break;
+      case 3:
+        dflush();
+        break;
+      }
+      rtaflg = 0;
+      rtadr0 = rtadr1 = addr;
+      memcpy(rtbuf, rp->r_buf + m, n);
+      rtadr1 += n;
+    }
+  }
+  rtadr2 = rtadr1;
+  switch (oflag) {
   default:
+  case 1:
+    iflush();
+    ixx(0);
+    break;
   case 2:
-    putc((int)(max >> 8) & 0xFF, ofp);
-    putc((int)(max >> 0) & 0xFF, ofp);
+    sflush();
+    sxx(0);
+    break;
+  case 3:
+    dflush();
+    dbx(0);
     break;
   }
 
-  /* Load Address */
-  switch (a_bytes) {
-  case 4:
-    putc((int)(rtadr0 >> 24) & 0xFF, ofp);
+  /*
+   * Release the image
+   */
+  if (ip != NULL) {
+    for (rp = ip->i_rp; rp != NULL; rp = tp) {
+      tp = rp->r_rp;
+      free(rp->r_buf);
+    }
+  }
+}
+
+/*)Function	struct rimg *	rfind()
+ *
+ *	The function rfind() removes the image of the output
+ *	file ofp from the image list and returns a pointer to
+ *	the image, or NULL if no data was written to ofp.
+ *
+ *	local variables:
+ *		struct rimg *	ip	binary image
+ *		struct rimg **	ipp	link to the binary image
+ *
+ *	global variables:
+ *		FILE *	ofp		output file handle
+ *		struct rimg *	rimgp	first binary image
+ *		struct rimg *	rimcp	binary image of ofp
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The image is unlinked from the image list.
+ */
+
+struct rimg *rfind() {
+  struct rimg *ip, **ipp;
+
+  for (ipp = &rimgp; (ip = *ipp) != NULL; ipp = &ip->i_ip) {
+    if (ip->i_fp == ofp) {
+      *ipp = ip->i_ip;
+      break;
+    }
+  }
+  if (rimcp == ip) {
+    rimcp = NULL;
+  }
+  return (ip);
+}
+
+/*)Function	int	rtlim()
+ *
+ *	The function rtlim() returns the largest number of
+ *	data bytes of a record of the current output format:
+ *
+ *		Intel Hex	255 data bytes
+ *		S19/S28/S37	252/251/250 data bytes
+ *				(the record length field
+ *				includes the address and
+ *				the checksum)
+ *		Disk BASIC	NMAX data bytes
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		int	oflag		output type flag
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+int rtlim() {
+  switch (oflag) {
+  default:
+  case 1:
+    return (255);
+  case 2:
+    return (255 - 1 - a_bytes);
   case 3:
-    putc((int)(rtadr0 >> 16) & 0xFF, ofp);
+    return (NMAX);
+  }
+}
+
+/*)Function	int	rtmax()
+ *
+ *	The function rtmax() returns the number of data bytes
+ *	per output record of the current output format.  The
+ *	default is the format's standard length, else the
+ *	record length specified by -in, -sn, or -tn, which
+ *	was checked against rtlim() by parse() and main().
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		int	oflag		output type flag
+ *		int	rtlen		-in/-sn/-tn record length
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+int rtmax() {
+  if (rtlen != 0)
+    return (rtlen);
+  switch (oflag) {
   default:
+  case 1:
+    return (IXXMAXBYTES);
   case 2:
-    putc((int)(rtadr0 >> 8) & 0xFF, ofp);
-    putc((int)(rtadr0 >> 0) & 0xFF, ofp);
-    break;
+    return (SXXMAXBYTES);
+  case 3:
+    return (DBXMAXBYTES - (2 * a_bytes) - 1);
   }
+}
+
+/*)Function	VOID	recbgn(mark)
+ *
+ *		char *	mark		record mark string or
+ *					NULL for a binary record
+ *
+ *	The function recbgn() starts a new output record.
+ *	The record mark is not included in the checksum.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		char	recbuf[]	output record
+ *		char *	recp		output record pointer
+ *		a_uint	recsum		output record checksum
+ *		int	recbin		binary output record
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The output record is reset.
+ */
 
-  for (i = 0; i < max; i++) {
-    putc(rtbuf[i], ofp);
+VOID recbgn(mark)
+char *mark;
+{
+  recp = recbuf;
+  recsum = 0;
+  recbin = (mark == NULL);
+  if (mark != NULL) {
+    while (*mark) {
+      *recp++ = *mark++;
+    }
   }
+}
 
-  rtadr0 = rtadr1;
+/*)Function	VOID	recput(v, n)
+ *
+ *		a_uint	v		value
+ *		int	n		number of bytes
+ *
+ *	The function recput() appends the n low order bytes
+ *	of v, high byte first, to the output record as
+ *	hexadecimal digits or binary bytes and adds them
+ *	to the record checksum.
+ *
+ *	local variables:
+ *		int	c		byte value
+ *
+ *	global variables:
+ *		char *	recp		output record pointer
+ *		a_uint	recsum		output record checksum
+ *		int	recbin		binary output record
+ *		char	rechex[]	hexadecimal digits
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The bytes are placed into the output record.
+ */
+
+VOID recput(v, n)
+a_uint v;
+int n;
+{
+  int c;
+
+  while (n-- > 0) {
+    c = (int)(v >> (8 * n)) & 0xFF;
+    recsum += c;
+    if (recbin) {
+      *recp++ = (char)c;
+    } else {
+      *recp++ = rechex[c >> 4];
+      *recp++ = rechex[c & 0x0F];
+    }
+  }
+}
+
+/*)Function	VOID	recdat(p, n)
+ *
+ *		char *	p		pointer to the data bytes
+ *		int	n		number of data bytes
+ *
+ *	The function recdat() appends n data bytes
+ *	to the output record.
+ *
+ *	local variables:
+ *		int	c		byte value
+ *
+ *	global variables:
+ *		char *	recp		output record pointer
+ *		a_uint	recsum		output record checksum
+ *		int	recbin		binary output record
+ *		char	rechex[]	hexadecimal digits
+ *
+ *	functions called:
+ *		VOID *	memcpy()	c_library
+ *
+ *	side effects:
+ *		The data bytes are placed into the output record.
+ */
+
+VOID recdat(p, n)
+char *p;
+int n;
+{
+  int c;
+
+  if (recbin) {
+    memcpy(recp, p, n);
+    recp += n;
+    return;
+  }
+  while (n-- > 0) {
+    c = *p++ & 0xFF;
+    recsum += c;
+    *recp++ = rechex[c >> 4];
+    *recp++ = rechex[c & 0x0F];
+  }
+}
+
+/*)Function	VOID	recend(ck)
+ *
+ *		int	ck		0 - no checksum
+ *					1 - 1's complement checksum
+ *					2 - 2's complement checksum
+ *
+ *	The function recend() appends the checksum and the
+ *	end of line to a text record and writes the record
+ *	to the output file.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		FILE *	ofp		output file handle
+ *		char	recbuf[]	output record
+ *		char *	recp		output record pointer
+ *		a_uint	recsum		output record checksum
+ *		int	recbin		binary output record
+ *
+ *	functions called:
+ *		size_t	fwrite()	c_library
+ *		VOID	recput()	lkout.c
+ *
+ *	side effects:
+ *		The record is written to the file defined by ofp.
+ */
+
+VOID recend(ck)
+int ck;
+{
+  switch (ck) {
+  case 1:
+    recput(~recsum, 1);
+    break;
+  case 2:
+    recput(~recsum + 1, 1);
+    break;
+  default:
+    break;
+  }
+  if (!recbin) {
+    *recp++ = '\n';
+  }
+  fwrite(recbuf, 1, (size_t)(recp - recbuf), ofp);
 }
@@ -0,0 +1,1152 @@
+/* lkpar.c */
+
+/*
+ *  Copyright (C) 1989-2017  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+/*
+ * sched_getaffinity() and CPU_COUNT()
+ */
+#define _GNU_SOURCE
+
+#include "aslink.h"
+
+#if LKPAR
+/*
+ * unistd.h, also included by sys/wait.h, declares
+ * a link() which is not the linker function link()
+ */
+#define link unistd_link
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#undef link
+#endif
+
+/*)Module	lkpar.c
+ *
+ *	The module lkpar.c contains the functions which
+ *	create the relocated listing (.rst) files of the
+ *	-uu option in parallel.
+ *
+ *	During pass 1 the relocated data normally passed to
+ *	lkulist() is saved for each .rel file which has a
+ *	.lst file.  After the relocation is complete each
+ *	.lst / .hlr / .rst file set is processed by a separate
+ *	worker process which replays the saved data through
+ *	lkulist().  The listing files of different modules
+ *	are independent so the .rst files are identical to
+ *	those created by -u.
+ *
+ *	When LKPAR is 0 or a worker can not be started the
+ *	saved data is replayed serially.
+ *
+ *	lkpar.c also contains the functions of the parallel
+ *	pass 1 relocation.  The modules are divided into
+ *	consecutive groups, one for each worker process.
+ *	Each worker reads all the .rel files, relocates the
+ *	R lines of its own modules, and writes an event for
+ *	each relocated R line, paging error, and change of
+ *	the input file to a temporary file.  The main process
+ *	does not read the .rel files, it replays the events
+ *	of the workers in order so the output files, listings,
+ *	map, and error messages are identical to those of a
+ *	serial link.  If a worker fails the pass is relocated
+ *	serially.
+ *
+ *	As every worker parses all the .rel files the parallel
+ *	relocation is not the default.  It is enabled by the
+ *	environment variable ASLINKPAR=n, n being the largest
+ *	number of workers.
+ *
+ *	lkpar.c contains the following functions:
+ *		int	lkpncpu()
+ *		VOID	lkpopen(fid)
+ *		VOID	lkprec(i)
+ *		int	lkprel()
+ *		VOID	lkprerp(str)
+ *		VOID	lkprerr(error)
+ *		VOID	lkprev(rp, type)
+ *		VOID	lkprfil()
+ *		int	lkprnxt()
+ *		int	lkprown()
+ *		VOID	lkprply()
+ *		VOID	lkprput(aindex, n)
+ *		VOID	lkprwk(w, cp)
+ *		VOID	lkpupd()
+ *		VOID	lkprun(lp)
+ *
+ *	lkpar.c contains the following local variables:
+ *		struct lkplst *	lkplp	first listing
+ *		struct lkplst *	lkpllp	last listing
+ *		struct lkplst *	lkpcur	listing of the current
+ *					.rel file or NULL
+ *		FILE **	lkprfp		event file of each worker
+ *		int	lkprnw		number of workers
+ *		int	lkprnm		number of modules
+ *		int	lkprw		worker number of this process
+ *		int	lkprn		current module number
+ *		struct head *	lkprhp	current module
+ *		struct lkpre	lkpre[]	relocation errors of an R line
+ *		int	lkprne		number of relocation errors
+ *		int	lkprie		next replayed relocation error
+ */
+
+static struct lkplst *lkplp;
+static struct lkplst *lkpllp;
+static struct lkplst *lkpcur;
+
+static FILE **lkprfp;
+static int lkprnw;
+static int lkprnm;
+static int lkprw;
+static int lkprn;
+static struct head *lkprhp;
+static struct lkpre lkpre[NTXT];
+static int lkprne;
+static int lkprie;
+
+/*
+ * Relocation counters returned by a worker
+ * after the status and the number of lines
+ */
+#define NPRCNT (ST_RERR - ST_TREC + 1)
+#define NPRWK (2 + NPRCNT)
+
+/*)Function	VOID	lkpopen(fid)
+ *
+ *		char *	fid		.rel file specification
+ *
+ *	The function lkpopen() is called by nxtline() after
+ *	the .lst, .rst, and optional .hlr files of a .rel file
+ *	have been opened.  The files are closed and a listing
+ *	structure is linked to save the relocated data.
+ *
+ *	local variables:
+ *		struct lkplst *	lp	listing structure
+ *
+ *	global variables:
+ *		FILE	*hfp		The file handle to the current
+ *					HLR file
+ *		FILE	*rfp		The file handle to the current
+ *					output RST file
+ *		FILE	*tfp		The file handle to the current
+ *					LST file
+ *
+ *	functions called:
+ *		int	fclose()	c_library
+ *		VOID *	new()		lksym.c
+ *		char *	strsto()	lksym.c
+ *
+ *	side effects:
+ *		The listing files are closed and a listing
+ *		structure is linked into the listing list.
+ */
+
+VOID lkpopen(fid)
+char *fid;
+{
+  struct lkplst *lp;
+
+  lp = (struct lkplst *)new (sizeof(struct lkplst));
+  lp->p_fid = strsto(fid);
+  lp->p_hlr = (hfp != NULL);
+  if (lkpllp == NULL) {
+    lkplp = lp;
+  } else {
+    lkpllp->p_next = lp;
+  }
+  lkpllp = lp;
+  lkpcur = lp;
+
+  fclose(tfp);
+  tfp = NULL;
+  fclose(rfp);
+  rfp = NULL;
+  if (hfp != NULL) {
+    fclose(hfp);
+    hfp = NULL;
+  }
+}
+
+/*)Function	VOID	lkprec(i)
+ *
+ *		int	i	i # 0	save the relocated data
+ *				i = 0	save the end of the .rel file
+ *
+ *	The function lkprec() is called by lkulist() for -uu
+ *	and saves the state used by lkulist() as an event of
+ *	the current listing.  Events without relocated data
+ *	are ignored.
+ *
+ *	local variables:
+ *		struct lkpev *	ep	event structure
+ *		int	n		loop counter
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		a_uint	a_mask		Address Mask
+ *		int	ASxxxx_VERSION	ASxxxx REL file version
+ *		struct head *hp		pointer to the current head structure
+ *		a_uint	pc		current relocation address
+ *		int	pcb		current bytes per pc word
+ *		int	radix		current number conversion radix
+ *		int	rtcnt		count of data words
+ *		int	rterr[]		data error flags
+ *		int	rtflg[]		output the data flag
+ *		a_uint	rtval[]		relocated data
+ *
+ *	functions called:
+ *		VOID *	new()		lksym.c
+ *
+ *	side effects:
+ *		An event is linked to the current listing.
+ *		The end of the .rel file ends the listing.
+ */
+
+VOID lkprec(i)
+int i;
+{
+  struct lkpev *ep;
+  int n;
+
+  if (lkpcur == NULL)
+    return;
+  if (i && (rtcnt == 0))
+    return;
+
+  ep = (struct lkpev *)new (sizeof(struct lkpev));
+  ep->e_hp = hp;
+  ep->e_pc = pc;
+  ep->e_mask = a_mask;
+  ep->e_pcb = (char)pcb;
+  ep->e_abytes = (char)a_bytes;
+  ep->e_radix = (char)radix;
+  ep->e_vers = (char)ASxxxx_VERSION;
+  if (i) {
+    ep->e_cnt = (char)rtcnt;
+    for (n = 0; n < rtcnt; n++) {
+      ep->e_val[n] = (char)rtval[n];
+      ep->e_flg[n] = (char)rtflg[n];
+      ep->e_err[n] = (char)rterr[n];
+    }
+  }
+  if (lkpcur->p_evl == NULL) {
+    lkpcur->p_ev = ep;
+  } else {
+    lkpcur->p_evl->e_next = ep;
+  }
+  lkpcur->p_evl = ep;
+  if (i == 0) {
+    lkpcur = NULL;
+  }
+}
+
+/*)Function	VOID	lkprun(lp)
+ *
+ *		struct lkplst *	lp	listing structure
+ *
+ *	The function lkprun() opens the listing files of
+ *	lp and creates the .rst file by restoring the saved
+ *	events and calling lkulist().
+ *
+ *	local variables:
+ *		struct lkpev *	ep	event structure
+ *		int	n		loop counter
+ *
+ *	global variables:
+ *		int	gline		get a line from the LST file
+ *		int	hline		get a line from the HLR file
+ *		FILE	*hfp		The file handle to the current
+ *					HLR file
+ *		FILE	*rfp		The file handle to the current
+ *					output RST file
+ *		FILE	*tfp		The file handle to the current
+ *					LST file
+ *		int	uflag		Relocated listing flag
+ *		(and the globals saved by lkprec())
+ *
+ *	functions called:
+ *		FILE *	afile()		lkmain.c
+ *		int	fclose()	c_library
+ *		VOID	lkulist()	lklist.c
+ *		VOID	lstmap()	lklist.c
+ *
+ *	side effects:
+ *		The .rst file of lp is created.
+ */
+
+VOID lkprun(lp)
+struct lkplst *lp;
+{
+  struct lkpev *ep;
+  int n;
+
+  uflag = 1;
+  if ((tfp = afile(lp->p_fid, "lst", 0)) == NULL)
+    return;
+  if ((rfp = afile(lp->p_fid, "rst", 1)) == NULL) {
+    fclose(tfp);
+    tfp = NULL;
+    return;
+  }
+  hfp = lp->p_hlr ? afile(lp->p_fid, "hlr", 4) : NULL;
+  lstmap();
+  gline = 1;
+  hline = 1;
+
+  for (ep = lp->p_ev; ep != NULL; ep = ep->e_next) {
+    hp = ep->e_hp;
+    pc = ep->e_pc;
+    a_mask = ep->e_mask;
+    pcb = ep->e_pcb;
+    a_bytes = ep->e_abytes;
+    radix = ep->e_radix;
+    ASxxxx_VERSION = ep->e_vers;
+    rtcnt = ep->e_cnt;
+    for (n = 0; n < rtcnt; n++) {
+      rtval[n] = (a_uint)(ep->e_val[n] & 0xFF);
+      rtflg[n] = ep->e_flg[n];
+      rterr[n] = ep->e_err[n];
+    }
+    lkulist(rtcnt ? 1 : 0);
+  }
+  lkulist(0);
+  if (hfp != NULL) {
+    fclose(hfp);
+    hfp = NULL;
+  }
+}
+
+/*)Function	int	lkpncpu()
+ *
+ *	The function lkpncpu() returns the number of processors
+ *	available to the linker: the processors of its CPU
+ *	affinity mask, else the online processors.
+ *
+ *	local variables:
+ *		cpu_set_t	set	CPU affinity mask
+ *		int	n		number of processors
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		int	sched_getaffinity()	c_library
+ *		long	sysconf()	c_library
+ *
+ *	side effects:
+ *		none
+ */
+
+int lkpncpu() {
+#if LKPAR
+  int n;
+#ifdef CPU_COUNT
+  cpu_set_t set;
+
+  CPU_ZERO(&set);
+  n = (sched_getaffinity(0, sizeof(set), &set) == 0) ? CPU_COUNT(&set) : 0;
+#else
+  n = 0;
+#endif
+  if (n < 1) {
+    n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  }
+  return ((n < 1) ? 1 : n);
+#else
+  return (1);
+#endif
+}
+
+/*)Function	VOID	lkpupd()
+ *
+ *	The function lkpupd() creates the .rst files saved
+ *	during pass 1.  One worker process is started for each
+ *	listing with at most one worker for each available
+ *	processor running at a time.  The listing line counts
+ *	of the workers are returned through a shared memory
+ *	array and added to the link statistics.
+ *
+ *	If the workers are not available the listings are
+ *	processed serially.
+ *
+ *	local variables:
+ *		struct lkplst *	lp	listing structure
+ *		long *		cnt	shared listing line counts
+ *		int	i		listing index
+ *		int	n		number of listings
+ *		int	nrun		running workers
+ *		int	ncpu		maximum running workers
+ *		int	status		worker exit status
+ *		pid_t	pid		worker process id
+ *
+ *	global variables:
+ *		struct lkstat	lkst	link statistics
+ *
+ *	functions called:
+ *		int	fflush()	c_library
+ *		pid_t	fork()		c_library
+ *		int	lkpncpu()	lkpar.c
+ *		VOID	lkprun()	lkpar.c
+ *		VOID *	mmap()		c_library
+ *		int	munmap()	c_library
+ *		pid_t	wait()		c_library
+ *		VOID	_exit()		c_library
+ *
+ *	side effects:
+ *		The .rst files are created.
+ */
+
+VOID lkpupd() {
+  struct lkplst *lp;
+#if LKPAR
+  long *cnt;
+  int i, n, nrun, ncpu, status;
+  pid_t pid;
+
+  for (n = 0, lp = lkplp; lp != NULL; lp = lp->p_next) {
+    n += 1;
+  }
+  if (n > 1) {
+    ncpu = lkpncpu();
+    cnt = (long *)mmap(NULL, n * sizeof(long), PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (cnt != (long *)MAP_FAILED) {
+      for (i = 0; i < n; i++) {
+        cnt[i] = -1;
+      }
+      fflush(NULL);
+      nrun = 0;
+      for (i = 0, lp = lkplp; lp != NULL; i++) {
+        if (nrun >= ncpu) {
+          if (wait(&status) > 0) {
+            nrun -= 1;
+          }
+        }
+        if ((pid = fork()) == 0) {
+          lkst.st_cnt[ST_LST] = 0;
+          lkprun(lp);
+          cnt[i] = lkst.st_cnt[ST_LST];
+          _exit(0);
+        }
+        if (pid < 0) {
+          break;
+        }
+        nrun += 1;
+        lp = lp->p_next;
+      }
+      while (nrun > 0) {
+        if (wait(&status) <= 0)
+          break;
+        nrun -= 1;
+      }
+      /*
+       * Listings not completed by a worker
+       * are processed serially.
+       */
+      for (i = 0, lp = lkplp; lp != NULL; i++, lp = lp->p_next) {
+        if (cnt[i] < 0) {
+          lkprun(lp);
+        } else {
+          lkst.st_cnt[ST_LST] += cnt[i];
+        }
+      }
+      munmap(cnt, n * sizeof(long));
+      lkplp = lkpllp = NULL;
+      return;
+    }
+  }
+#endif
+  for (lp = lkplp; lp != NULL; lp = lp->p_next) {
+    lkprun(lp);
+  }
+  lkplp = lkpllp = NULL;
+}
+
+/*)Function	int	lkprel()
+ *
+ *	The function lkprel() starts the parallel pass 1
+ *	relocation.  The relocation is done in parallel when
+ *	the environment variable ASLINKPAR is at least 2,
+ *	pass 0 read at least PRMIN lines, all input files are
+ *	.rel files, no NoICE file is created, no -mm incremental
+ *	relink state is saved, and there are at least two
+ *	modules and two available processors.  The number of
+ *	workers is the smallest of ASLINKPAR, the number of
+ *	available processors and the number of modules, so a
+ *	worker is not started for a processor outside the CPU
+ *	affinity of the linker.  The line and relocation counters
+ *	of the workers are returned through a shared memory
+ *	array and added to the link statistics.
+ *
+ *	lkprel() returns 1 if the events of all the workers
+ *	are available for the replay by lkprply() and 0 if
+ *	pass 1 must be relocated serially.
+ *
+ *	local variables:
+ *		long *		cnt	shared worker status and counters
+ *		struct head *	thp	pointer to a head structure
+ *		struct lfile *	lfp	pointer to an input file
+ *		int	i		worker index
+ *		int	j		loop counter
+ *		int	n		number of started workers
+ *		int	ncpu		available processors
+ *		char *	p		ASLINKPAR value
+ *		int	status		worker exit status
+ *		pid_t	pid		worker process id
+ *
+ *	global variables:
+ *		lfile	*filep		The pointer *filep points to the
+ *					beginning of a linked list of
+ *					lfile structures.
+ *		head	*headp		The pointer to the first
+ *					head structure of a linked list
+ *		FILE *	jfp		NoICE output file handle
+ *		struct lkstat	lkst	link statistics
+ *		int	mmflag		-mm, incremental relink flag
+ *
+ *	functions called:
+ *		int	atoi()		c_library
+ *		int	fclose()	c_library
+ *		int	fflush()	c_library
+ *		pid_t	fork()		c_library
+ *		char *	getenv()	c_library
+ *		int	lkpncpu()	lkpar.c
+ *		VOID	lkprwk()	lkpar.c
+ *		VOID *	mmap()		c_library
+ *		int	munmap()	c_library
+ *		VOID *	new()		lksym.c
+ *		VOID	rewind()	c_library
+ *		FILE *	tmpfile()	c_library
+ *		pid_t	wait()		c_library
+ *		VOID	_exit()		c_library
+ *
+ *	side effects:
+ *		The workers relocate pass 1.
+ */
+
+int lkprel() {
+#if LKPAR
+  long *cnt;
+  struct head *thp;
+  struct lfile *lfp;
+  char *p;
+  int i, j, n, ncpu, status;
+  pid_t pid;
+
+  if (((p = getenv("ASLINKPAR")) == NULL) || ((n = atoi(p)) < 2))
+    return (0);
+  if ((lkst.st_cnt[ST_LINES] < PRMIN) || mmflag)
+    return (0);
+#if NOICE
+  if (jfp != NULL)
+    return (0);
+#endif
+  for (lfp = filep; lfp != NULL; lfp = lfp->f_flp) {
+    if (lfp->f_type != F_REL)
+      return (0);
+  }
+  for (lkprnm = 0, thp = headp; thp != NULL; thp = thp->h_hp) {
+    lkprnm += 1;
+  }
+  ncpu = lkpncpu();
+  lkprnw = (ncpu < lkprnm) ? ncpu : lkprnm;
+  if (n < lkprnw) {
+    lkprnw = n;
+  }
+  if (lkprnw < 2)
+    return (0);
+
+  cnt = (long *)mmap(NULL, lkprnw * NPRWK * sizeof(long),
+                     PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (cnt == (long *)MAP_FAILED)
+    return (0);
+  lkprfp = (FILE **)new (lkprnw * sizeof(FILE *));
+  for (i = 0; i < lkprnw; i++) {
+    cnt[i * NPRWK] = -1;
+    if ((lkprfp[i] = tmpfile()) == NULL)
+      break;
+  }
+  n = 0;
+  if (i == lkprnw) {
+    fflush(NULL);
+    for (; n < lkprnw; n++) {
+      if ((pid = fork()) == 0) {
+        lkprwk(n, &cnt[n * NPRWK]);
+        _exit(0);
+      }
+      if (pid < 0)
+        break;
+    }
+    for (j = 0; j < n; j++) {
+      if (wait(&status) <= 0)
+        break;
+    }
+  }
+  /*
+   * All the workers must have completed
+   */
+  for (i = 0; i < lkprnw; i++) {
+    if (cnt[i * NPRWK] < 0)
+      break;
+  }
+  if (i < lkprnw) {
+    for (i = 0; i < lkprnw; i++) {
+      if (lkprfp[i] != NULL)
+        fclose(lkprfp[i]);
+    }
+    munmap(cnt, lkprnw * NPRWK * sizeof(long));
+    return (0);
+  }
+  /*
+   * Every worker reads all the lines
+   */
+  lkst.st_cnt[ST_LINES] += cnt[1];
+  for (i = 0; i < lkprnw; i++) {
+    for (j = 0; j < NPRCNT; j++) {
+      lkst.st_cnt[ST_TREC + j] += cnt[i * NPRWK + 2 + j];
+    }
+    rewind(lkprfp[i]);
+  }
+  munmap(cnt, lkprnw * NPRWK * sizeof(long));
+  return (1);
+#else
+  return (0);
+#endif
+}
+
+/*)Function	VOID	lkprwk(w, cp)
+ *
+ *		int	w		worker number
+ *		long *	cp		shared status and counters
+ *					of the worker
+ *
+ *	The function lkprwk() is the pass 1 of worker w.
+ *	All output files are disabled, the .rel files are
+ *	read and the R lines of the modules of the worker are
+ *	relocated into the event file.  When the relocation
+ *	completed without an error the line and relocation
+ *	counters are copied to cp[1] ... and cp[0] is set.
+ *
+ *	local variables:
+ *		struct bank *	bkp	pointer to a bank structure
+ *		int	e		error count at the start
+ *		int	i		loop counter
+ *		long	l		line count at the start
+ *		struct lkprr	r	end of pass 1 event
+ *
+ *	global variables:
+ *		int	aflag		-a, link statistics flag
+ *		bank	*bankp		pointer to the first bank
+ *		char	ib[]		.rel file text line
+ *		char *	ip		pointer into the .rel file text line
+ *		FILE *	jfp		NoICE output file handle
+ *		int	lkerr		error flag
+ *		struct lkstat	lkst	link statistics
+ *		FILE *	mfp		map file handle
+ *		int	oflag		output type flag
+ *		FILE *	ofp		output file handle
+ *		int	rlpar		parallel relocation mode
+ *		int	uflag		relocated listing flag
+ *		FILE *	yfp		SDCDB output file handle
+ *
+ *	functions called:
+ *		int	ferror()	c_library
+ *		int	fflush()	c_library
+ *		FILE *	freopen()	c_library
+ *		VOID	library()	lklibr.c
+ *		VOID	link()		lkmain.c
+ *		VOID	lkprev()	lkpar.c
+ *		int	lkprown()	lkpar.c
+ *		VOID *	memset()	c_library
+ *		int	nxtline()	lklex.c
+ *
+ *	side effects:
+ *		The events of the worker modules
+ *		are written to the worker file.
+ */
+
+VOID lkprwk(w, cp)
+int w;
+long *cp;
+{
+  struct bank *bkp;
+  struct lkprr r;
+  int e, i;
+  long l;
+
+  rlpar = PR_WORK;
+  lkprw = w;
+  lkprn = -1;
+  lkprhp = NULL;
+  lkprne = 0;
+  e = lkerr;
+  l = lkst.st_cnt[ST_LINES];
+
+  /*
+   * The main process reports the errors
+   * and writes all the output files.
+   */
+  freopen("/dev/null", "w", stderr);
+  aflag = 0;
+  uflag = 0;
+  oflag = 0;
+  ofp = NULL;
+  mfp = NULL;
+#if NOICE
+  jfp = NULL;
+#endif
+#if SDCDB
+  yfp = NULL;
+#endif
+  for (bkp = bankp; bkp != NULL; bkp = bkp->b_bp) {
+    bkp->b_ofp = NULL;
+  }
+  for (i = ST_TREC; i <= ST_RERR; i++) {
+    lkst.st_cnt[i] = 0;
+  }
+
+  while (nxtline()) {
+    ip = ib;
+    link();
+  }
+  library();
+
+  /*
+   * The last worker ends the pass
+   */
+  if (lkprown()) {
+    memset(&r, 0, sizeof(r));
+    lkprev(&r, PE_END);
+  }
+
+  if ((fflush(lkprfp[w]) == 0) && !ferror(lkprfp[w]) && (lkerr == e)) {
+    cp[1] = lkst.st_cnt[ST_LINES] - l;
+    for (i = 0; i < NPRCNT; i++) {
+      cp[2 + i] = lkst.st_cnt[ST_TREC + i];
+    }
+    cp[0] = 1;
+  }
+}
+
+/*)Function	int	lkprown()
+ *
+ *	The function lkprown() selects the worker of the
+ *	current module.  The module number is advanced until
+ *	the current head structure is reached, the lines
+ *	before the first module belong to the first worker.
+ *
+ *	lkprown() returns 1 if the current module is
+ *	relocated by this worker and 0 otherwise.
+ *
+ *	local variables:
+ *		int	w		worker of the current module
+ *
+ *	global variables:
+ *		head	*headp		The pointer to the first
+ *					head structure of a linked list
+ *		head	*hp		pointer to the current head structure
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The current module number may be changed.
+ */
+
+int lkprown() {
+  int w;
+
+  while (lkprhp != hp) {
+    lkprhp = (lkprhp == NULL) ? headp : lkprhp->h_hp;
+    lkprn += 1;
+  }
+  w = (lkprn < 0) ? 0 : (int)(((long)lkprn * lkprnw) / lkprnm);
+  if (w >= lkprnw) {
+    w = lkprnw - 1;
+  }
+  return (w == lkprw);
+}
+
+/*)Function	VOID	lkprev(rp, type)
+ *
+ *		struct lkprr *	rp	event
+ *		int	type		event type
+ *
+ *	The function lkprev() saves the linker state of the
+ *	current line in the event rp and writes the event and
+ *	its rp->r_nerr saved errors to the file of the worker.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		a_uint	a_mask		Address Mask
+ *		int	ASxxxx_VERSION	ASxxxx REL file version
+ *		int	hilo		byte ordering parameter
+ *		head	*hp		pointer to the current head structure
+ *		int	obj_flag	Linked file/library object flag
+ *		a_uint	p_mask		Page Mask
+ *		int	radix		current number conversion radix
+ *		a_uint	s_mask		Sign Mask
+ *		sdp	sdp		base page structure
+ *		a_uint	v_mask		Value Mask
+ *
+ *	functions called:
+ *		size_t	fwrite()	c_library
+ *
+ *	side effects:
+ *		The event is written to the worker file.
+ */
+
+VOID lkprev(rp, type)
+struct lkprr *rp;
+int type;
+{
+  rp->r_type = type;
+  rp->r_hp = hp;
+  rp->r_obj = obj_flag;
+  rp->r_vers = ASxxxx_VERSION;
+  rp->r_radix = radix;
+  rp->r_hilo = hilo;
+  rp->r_abytes = a_bytes;
+  rp->r_amask = a_mask;
+  rp->r_smask = s_mask;
+  rp->r_vmask = v_mask;
+  rp->r_pmask = p_mask;
+  rp->r_sdp = sdp;
+  fwrite(rp, sizeof(struct lkprr), 1, lkprfp[lkprw]);
+  fwrite(lkpre, sizeof(struct lkpre), rp->r_nerr, lkprfp[lkprw]);
+}
+
+/*)Function	VOID	lkprfil()
+ *
+ *	The function lkprfil() is called by nxtline() of a
+ *	worker before the next input file is opened.  The
+ *	worker of the current module saves the change of
+ *	the input file.
+ *
+ *	local variables:
+ *		struct lkprr	r	input file event
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID	lkprev()	lkpar.c
+ *		int	lkprown()	lkpar.c
+ *		VOID *	memset()	c_library
+ *
+ *	side effects:
+ *		An event may be written to the worker file.
+ */
+
+VOID lkprfil() {
+  struct lkprr r;
+
+  if (lkprown()) {
+    memset(&r, 0, sizeof(r));
+    lkprev(&r, PE_FILE);
+  }
+}
+
+/*)Function	VOID	lkprerr(error)
+ *
+ *		int	error		relocation error code
+ *
+ *	The function lkprerr() saves the relocation error
+ *	and the rerr structure of the current R line entry
+ *	for the replay.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		int	lkerr		error flag
+ *		rerr	rerr		linker error structure
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The error is saved.  Too many errors
+ *		fail the worker.
+ */
+
+VOID lkprerr(error)
+int error;
+{
+  if (lkprne >= NTXT) {
+    lkerr++;
+    return;
+  }
+  lkpre[lkprne].e_rerr = rerr;
+  lkpre[lkprne].e_err = error;
+  lkprne += 1;
+}
+
+/*)Function	VOID	lkprerp(str)
+ *
+ *		char *	str		paging error string
+ *
+ *	The function lkprerp() saves a paging error of
+ *	the current P line for the replay.
+ *
+ *	local variables:
+ *		struct lkprr	r	paging error event
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		VOID	lkprev()	lkpar.c
+ *		VOID *	memset()	c_library
+ *
+ *	side effects:
+ *		An event is written to the worker file.
+ */
+
+VOID lkprerp(str)
+char *str;
+{
+  struct lkprr r;
+
+  memset(&r, 0, sizeof(r));
+  r.r_str = str;
+  lkprev(&r, PE_PAGE);
+}
+
+/*)Function	VOID	lkprput(aindex, n)
+ *
+ *		int	aindex		R line area index
+ *		int	n		number of relocation entries
+ *
+ *	The function lkprput() writes the relocated data
+ *	and the saved errors of the current R line to the
+ *	file of the worker.
+ *
+ *	local variables:
+ *		int	i		loop counter
+ *		struct lkprr	r	R line event
+ *
+ *	global variables:
+ *		a_uint	pc		relocated base address
+ *		int	pcb		bytes per instruction word
+ *		int	rtcnt		count of data words
+ *		int	rterr[]		data error flags
+ *		int	rtflg[]		output the data flag
+ *		a_uint	rtval[]		relocated data
+ *
+ *	functions called:
+ *		VOID	lkprev()	lkpar.c
+ *		VOID *	memset()	c_library
+ *
+ *	side effects:
+ *		The R line is written to the worker file.
+ */
+
+VOID lkprput(aindex, n)
+int aindex;
+int n;
+{
+  struct lkprr r;
+  int i;
+
+  memset(&r, 0, sizeof(r));
+  r.r_aindex = aindex;
+  r.r_pc = pc;
+  r.r_pcb = pcb;
+  r.r_cnt = rtcnt;
+  r.r_nent = n;
+  r.r_nerr = lkprne;
+  for (i = 0; i < rtcnt; i++) {
+    r.r_val[i] = rtval[i];
+    r.r_flg[i] = rtflg[i];
+    r.r_err[i] = rterr[i];
+  }
+  lkprev(&r, PE_REL);
+  lkprne = 0;
+}
+
+/*)Function	VOID	lkprply()
+ *
+ *	The function lkprply() replays the events of the
+ *	workers in the order of the workers.  The linker state
+ *	of each event is restored, a change of the input file
+ *	closes and opens the listing files as nxtline(), and
+ *	the R lines and paging errors are replayed by relrply()
+ *	and relpply().  The event files are closed.
+ *
+ *	local variables:
+ *		FILE *	fp		worker file handle
+ *		int	i		worker index
+ *		int	j		loop counter
+ *		int	ph		previous statistics phase
+ *		struct lkprr	r	event
+ *
+ *	global variables:
+ *		lfile	*cfp		The pointer *cfp points to the
+ *				 	current lfile structure
+ *		lfile	*filep		The pointer *filep points to the
+ *					beginning of a linked list of
+ *					lfile structures.
+ *		int	gline		get a line from the LST file
+ *		int	hline		get a line from the HLR file
+ *		a_uint	pc		relocated base address
+ *		int	pcb		bytes per instruction word
+ *		int	rtcnt		count of data words
+ *		int	rterr[]		data error flags
+ *		int	rtflg[]		output the data flag
+ *		a_uint	rtval[]		relocated data
+ *		(and the globals saved by lkprev())
+ *
+ *	functions called:
+ *		int	fclose()	c_library
+ *		int	ferror()	c_library
+ *		int	fprintf()	c_library
+ *		size_t	fread()		c_library
+ *		VOID	lkexit()	lkmain.c
+ *		VOID	lkulist()	lklist.c
+ *		VOID	lkuopen()	lklex.c
+ *		VOID	relpply()	lkrloc.c
+ *		VOID	relrply()	lkrloc.c
+ *		int	stphase()	lkstat.c
+ *
+ *	side effects:
+ *		Pass 1 is completed.  A read error is fatal.
+ */
+
+VOID lkprply() {
+  FILE *fp;
+  struct lkprr r;
+  int i, j, ph;
+
+  for (i = 0; i < lkprnw; i++) {
+    fp = lkprfp[i];
+    while (fread(&r, sizeof(r), 1, fp) == 1) {
+      if ((r.r_cnt < 0) || (r.r_cnt > NTXT) || (r.r_nerr < 0) ||
+          (r.r_nerr > NTXT) ||
+          (fread(lkpre, sizeof(struct lkpre), r.r_nerr, fp) !=
+           (size_t)r.r_nerr))
+        break;
+      hp = r.r_hp;
+      obj_flag = r.r_obj;
+      ASxxxx_VERSION = r.r_vers;
+      radix = r.r_radix;
+      hilo = r.r_hilo;
+      a_bytes = r.r_abytes;
+      a_mask = r.r_amask;
+      s_mask = r.r_smask;
+      v_mask = r.r_vmask;
+      p_mask = r.r_pmask;
+      sdp = r.r_sdp;
+
+      switch (r.r_type) {
+      case PE_FILE:
+        /*
+         * Next .rel file
+         */
+        obj_flag = 0;
+        if (cfp != NULL) {
+          ph = stphase(PH_LIST);
+          lkulist(0);
+          stphase(ph);
+        }
+        cfp = (cfp == NULL) ? filep : cfp->f_flp;
+        if (cfp != NULL) {
+          obj_flag = cfp->f_obj;
+          if (obj_flag == 0) {
+            lkuopen(cfp->f_idp);
+          }
+          gline = 1;
+          hline = 1;
+        } else {
+          filep = NULL;
+        }
+        break;
+
+      case PE_REL:
+        pc = r.r_pc;
+        pcb = r.r_pcb;
+        rtcnt = r.r_cnt;
+        for (j = 0; j < rtcnt; j++) {
+          rtval[j] = r.r_val[j];
+          rtflg[j] = r.r_flg[j];
+          rterr[j] = r.r_err[j];
+        }
+        lkprne = r.r_nerr;
+        lkprie = 0;
+        relrply(r.r_aindex, r.r_nent);
+        break;
+
+      case PE_PAGE:
+        relpply(r.r_str);
+        break;
+
+      case PE_END:
+        break;
+
+      default:
+        r.r_cnt = -1;
+        break;
+      }
+      if (r.r_cnt < 0)
+        break;
+    }
+    if (!feof(fp) || ferror(fp)) {
+      fprintf(stderr, "Parallel Relocation Error\n");
+      lkexit(ER_FATAL);
+    }
+    fclose(fp);
+  }
+}
+
+/*)Function	int	lkprnxt()
+ *
+ *	The function lkprnxt() restores the rerr structure
+ *	of the next saved error of the current R line.
+ *
+ *	lkprnxt() returns the error code or 0 if there
+ *	are no more errors.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		rerr	rerr		linker error structure
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		The rerr structure is changed.
+ */
+
+int lkprnxt() {
+  if (lkprie >= lkprne)
+    return (0);
+  rerr = lkpre[lkprie].e_rerr;
+  return (lkpre[lkprie++].e_err);
+}
@@ -0,0 +1,511 @@
+/* lkrelax.c */
+
+/*
+ *  Copyright (C) 1989-2017  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include "aslink.h"
+
+/*)Module	lkrelax.c
+ *
+ *	The module lkrelax.c contains the functions of the
+ *	Z80 branch relaxation.  A module assembled with the
+ *	.relax directive names the merge mode of its jumps
+ *	in the H line:
+ *
+ *		H 2 areas 2 global symbols 2 banks 2 modes 1 relax
+ *
+ *	A jp or jp cc (cc = NZ, Z, NC or C) to a relocatable
+ *	address is output alone in a T line and relocated
+ *	with this mode.  The T line holds the opcode, the
+ *	address and the merge base.  In pass 0 these jumps
+ *	are linked to their areax by lkradd().
+ *
+ *	Before the area addresses are linked lkrelax() lays
+ *	out the areas with lnkarea() and shrinks each jump
+ *	whose target is in the range of a jr.  A shrunk jump
+ *	found out of range in a later layout pass is kept as
+ *	a jp.  The passes are repeated until no jump changes,
+ *	the symbols of the areax sections are then moved down
+ *	by the bytes removed before them.
+ *
+ *	In pass 1 relr() moves the T line addresses and the
+ *	area references by lkrbef() and lkrjr() outputs the
+ *	shrunk jumps as a jr.
+ *
+ *	The assembler reports an error for a constant
+ *	difference of labels or a .bndry directive spanning
+ *	a relaxable jump, .relax 0 keeps the jumps of a
+ *	region (e.g. a jump table) as a jp.  The jumps of
+ *	absolute areas are not relaxed.
+ *
+ *	lkrelax.c contains the following functions:
+ *		VOID	lkradd(axp, ofs, op, rsp, rap, val)
+ *		a_uint	lkrbef(axp, ofs)
+ *		int	lkrcmp(p1, p2)
+ *		VOID	lkrelax()
+ *		VOID	lkrjr(axp, rtbase)
+ *		a_uint	lkrval(xp)
+ *
+ *	lkrelax.c contains the following local variables:
+ *		int	lkrxn		number of jumps linked
+ */
+
+static int lkrxn;
+
+/*)Function	VOID	lkradd(axp, ofs, op, rsp, rap, val)
+ *
+ *		areax *	axp		areax of the jump
+ *		a_uint	ofs		offset of the opcode in the areax
+ *		int	op		opcode
+ *		sym *	rsp		target symbol or NULL
+ *		areax *	rap		target areax or NULL
+ *		a_uint	val		target offset or addend
+ *
+ *	The function lkradd() is called by relref() in pass 0
+ *	for a jump relocated with the relaxable jump mode of
+ *	the module.  A jp or jp cc (cc = NZ, Z, NC or C) is
+ *	linked to its areax.
+ *
+ *	local variables:
+ *		struct lkrx *	xp	pointer to a jump
+ *
+ *	global variables:
+ *		int	lkrxn		number of jumps linked
+ *
+ *	functions called:
+ *		VOID *	new()		lksym.c
+ *
+ *	side effects:
+ *		The jumps of the areax are updated.
+ */
+
+VOID lkradd(axp, ofs, op, rsp, rap, val)
+struct areax *axp;
+a_uint ofs;
+int op;
+struct sym *rsp;
+struct areax *rap;
+a_uint val;
+{
+  struct lkrx *xp;
+
+  switch (op) {
+  case 0xC3: /* jp */
+  case 0xC2: /* jp nz */
+  case 0xCA: /* jp z */
+  case 0xD2: /* jp nc */
+  case 0xDA: /* jp c */
+    break;
+
+  default:
+    return;
+  }
+  xp = (struct lkrx *)new (sizeof(struct lkrx));
+  xp->x_ofs = ofs;
+  xp->x_op = op;
+  xp->x_sp = rsp;
+  xp->x_axp = rap;
+  xp->x_val = val;
+  xp->x_state = RX_LONG;
+  xp->x_xp = axp->a_rxp;
+  axp->a_rxp = xp;
+  axp->a_nrx += 1;
+  lkrxn += 1;
+}
+
+/*)Function	a_uint	lkrbef(axp, ofs)
+ *
+ *		areax *	axp		pointer to an areax structure
+ *		a_uint	ofs		offset in the areax
+ *
+ *	The function lkrbef() returns the number of bytes
+ *	removed from the areax before the offset ofs.  A
+ *	shrunk jump removes the byte following its jr.
+ *
+ *	local variables:
+ *		int	hi		search limit
+ *		int	lo		search limit
+ *		int	m		search index
+ *		struct lkrx *	xp	array of jumps
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+a_uint lkrbef(axp, ofs)
+struct areax *axp;
+a_uint ofs;
+{
+  struct lkrx *xp;
+  int hi, lo, m;
+
+  if ((axp == NULL) || (axp->a_nrx == 0))
+    return (0);
+
+  xp = axp->a_rxp;
+  lo = 0;
+  hi = axp->a_nrx;
+  while (lo < hi) {
+    m = (lo + hi) / 2;
+    if ((xp[m].x_ofs + 2) < ofs) {
+      lo = m + 1;
+    } else {
+      hi = m;
+    }
+  }
+  return ((lo == 0) ? 0 : (a_uint)xp[lo - 1].x_nsh);
+}
+
+/*)Function	int	lkrcmp(p1, p2)
+ *
+ *		VOID *		p1	pointer to first jump
+ *		VOID *		p2	pointer to second jump
+ *
+ *	The function lkrcmp() is the qsort() comparison
+ *	function of the jumps of an areax, the jumps are
+ *	ordered by their offset.
+ *
+ *	local variables:
+ *		struct lkrx *	x1	pointer to first jump
+ *		struct lkrx *	x2	pointer to second jump
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		none
+ *
+ *	side effects:
+ *		none
+ */
+
+int lkrcmp(const VOID *p1, const VOID *p2) {
+  struct lkrx *x1, *x2;
+
+  x1 = (struct lkrx *)p1;
+  x2 = (struct lkrx *)p2;
+  if (x1->x_ofs != x2->x_ofs)
+    return ((x1->x_ofs < x2->x_ofs) ? -1 : 1);
+  return (0);
+}
+
+/*)Function	a_uint	lkrval(xp)
+ *
+ *		struct lkrx *	xp	pointer to a jump
+ *
+ *	The function lkrval() returns the target address
+ *	of a jump in the current layout pass.
+ *
+ *	local variables:
+ *		sym *	sp		pointer to a symbol structure
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		a_uint	lkrbef()	lkrelax.c
+ *		a_uint	symval()	lksym.c
+ *
+ *	side effects:
+ *		none
+ */
+
+a_uint lkrval(xp)
+struct lkrx *xp;
+{
+  struct sym *sp;
+
+  if ((sp = xp->x_sp) != NULL) {
+    return (symval(sp) - lkrbef(sp->s_axp, sp->s_addr) + xp->x_val);
+  }
+  return (xp->x_axp->a_addr + xp->x_val - lkrbef(xp->x_axp, xp->x_val));
+}
+
+/*)Function	VOID	lkrelax()
+ *
+ *	The function lkrelax() is called before lnkarea() and
+ *	shrinks the jumps whose target is in the range of a
+ *	jr.  The jumps of each areax are sorted, the jumps of
+ *	absolute areas, of word addressed areas and of the
+ *	sections removed by the area garbage collection are
+ *	dropped.  Each layout pass restores the areax sizes
+ *	less the bytes removed and links the area addresses
+ *	with lnkarea().  A jump whose jr displacement fits
+ *	is shrunk, a shrunk jump whose displacement no longer
+ *	fits is kept as a jp.  The passes end when no jump
+ *	changes.  The areax sizes are restored for the final
+ *	lnkarea() and the symbols are moved down by the bytes
+ *	removed before them.
+ *
+ *	local variables:
+ *		a_uint	a		address of a jump
+ *		int	chg		a jump changed
+ *		a_uint	d		jr displacement
+ *		int	i		loop counter
+ *		int	j		loop counter
+ *		int	n		number of areax
+ *		int	nsh		shrunk jumps of an areax
+ *		a_uint *osz		areax sizes
+ *		area *	tap		pointer to an area structure
+ *		areax *	taxp		pointer to an areax structure
+ *		sym *	sp		pointer to a symbol structure
+ *		struct lkrx *	xp	pointer to a jump
+ *		struct lkrx *	xv	array of jumps
+ *
+ *	global variables:
+ *		area	*areap		The pointer to the first
+ *				 	area structure of a linked list
+ *		int	lkrxn		number of jumps linked
+ *		struct lkstat	lkst	link statistics
+ *		int	rxpass		relaxation layout pass flag
+ *		sym *	symhash[]	array of pointers to NHASH
+ *				 	linked symbol lists
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		VOID	free()		c_library
+ *		VOID	lkexit()	lkmain.c
+ *		a_uint	lkrbef()	lkrelax.c
+ *		a_uint	lkrval()	lkrelax.c
+ *		VOID	lnkarea()	lkarea.c
+ *		VOID *	malloc()	c_library
+ *		VOID	qsort()		c_library
+ *
+ *	side effects:
+ *		Jumps are shrunk, the areax sizes and the
+ *		symbol addresses are updated.
+ */
+
+VOID lkrelax() {
+  struct area *tap;
+  struct areax *taxp;
+  struct lkrx *xp, *xv;
+  struct sym *sp;
+  a_uint *osz;
+  a_uint a, d;
+  int chg, i, j, n, nsh;
+
+  if (lkrxn == 0)
+    return;
+
+  /*
+   * Sort the jumps of each areax
+   */
+  for (n = 0, tap = areap; tap != NULL; tap = tap->a_ap) {
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      n += 1;
+      if (taxp->a_nrx == 0)
+        continue;
+      if (((tap->a_flag & A4_ABS) == A4_ABS) || (tap->a_flag & A4_WLMSK) ||
+          (taxp->a_gc == GC_DEAD)) {
+        taxp->a_rxp = NULL;
+        taxp->a_nrx = 0;
+        continue;
+      }
+      xv = (struct lkrx *)malloc(taxp->a_nrx * sizeof(struct lkrx));
+      if (xv == NULL) {
+        fprintf(stderr, "Out of space!\n");
+        lkexit(ER_FATAL);
+      }
+      for (i = 0, xp = taxp->a_rxp; xp != NULL; xp = xp->x_xp, i++) {
+        xv[i] = *xp;
+        xv[i].x_xp = NULL;
+      }
+      qsort(xv, taxp->a_nrx, sizeof(struct lkrx), lkrcmp);
+      taxp->a_rxp = xv;
+      lkst.st_cnt[ST_RXJP] += taxp->a_nrx;
+    }
+  }
+
+  osz = (a_uint *)malloc((n + 1) * sizeof(a_uint));
+  if (osz == NULL) {
+    fprintf(stderr, "Out of space!\n");
+    lkexit(ER_FATAL);
+  }
+  for (i = 0, tap = areap; tap != NULL; tap = tap->a_ap) {
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      osz[i++] = taxp->a_size;
+    }
+  }
+
+  /*
+   * Layout passes
+   */
+  do {
+    lkst.st_cnt[ST_RXPASS] += 1;
+    for (i = 0, tap = areap; tap != NULL; tap = tap->a_ap) {
+      for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+        taxp->a_size = osz[i++];
+        if (taxp->a_nrx != 0) {
+          taxp->a_size -= taxp->a_rxp[taxp->a_nrx - 1].x_nsh;
+        }
+      }
+    }
+    rxpass = 1;
+    lnkarea();
+    rxpass = 0;
+
+    chg = 0;
+    for (tap = areap; tap != NULL; tap = tap->a_ap) {
+      for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+        for (j = 0; j < taxp->a_nrx; j++) {
+          xp = &taxp->a_rxp[j];
+          if (xp->x_state == RX_PIN)
+            continue;
+          /*
+           * jr displacement in the 16-bit address space
+           */
+          if ((xp->x_sp != NULL) && ((xp->x_sp->s_type & S_DEF) == 0)) {
+            d = 0x100;
+          } else {
+            a = taxp->a_addr + xp->x_ofs - lkrbef(taxp, xp->x_ofs);
+            d = (lkrval(xp) - (a + 2) + 0x80) & 0xFFFF;
+          }
+          if ((d < 0x100) && (xp->x_state == RX_LONG)) {
+            xp->x_state = RX_SHORT;
+            chg = 1;
+          } else if ((d >= 0x100) && (xp->x_state == RX_SHORT)) {
+            xp->x_state = RX_PIN;
+            chg = 1;
+          }
+        }
+      }
+    }
+
+    for (tap = areap; tap != NULL; tap = tap->a_ap) {
+      for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+        for (nsh = 0, j = 0; j < taxp->a_nrx; j++) {
+          xp = &taxp->a_rxp[j];
+          nsh += (xp->x_state == RX_SHORT) ? 1 : 0;
+          xp->x_nsh = nsh;
+        }
+      }
+    }
+  } while (chg);
+
+  /*
+   * Restore the areax sizes for lnkarea()
+   */
+  for (i = 0, tap = areap; tap != NULL; tap = tap->a_ap) {
+    for (taxp = tap->a_axp; taxp != NULL; taxp = taxp->a_axp) {
+      taxp->a_size = osz[i++];
+      if (taxp->a_nrx != 0) {
+        nsh = taxp->a_rxp[taxp->a_nrx - 1].x_nsh;
+        taxp->a_size -= nsh;
+        lkst.st_cnt[ST_RXJR] += nsh;
+      }
+    }
+  }
+  free(osz);
+
+  /*
+   * Move the symbols
+   */
+  for (i = 0; i < NHASH; i++) {
+    for (sp = symhash[i]; sp != NULL; sp = sp->s_sp) {
+      if ((sp->s_axp != NULL) && (sp->s_axp->a_nrx != 0)) {
+        sp->s_addr -= lkrbef(sp->s_axp, sp->s_addr);
+      }
+    }
+  }
+}
+
+/*)Function	VOID	lkrjr(axp, rtbase)
+ *
+ *		areax *	axp		areax of the R line
+ *		a_uint	rtbase		T line offset in the areax
+ *
+ *	The function lkrjr() is called by relr() after the
+ *	relocation of a T line of an areax with jumps.  A
+ *	shrunk jump is replaced by a jr, the displacement
+ *	is loaded into the merged address and the last byte
+ *	of the jump is not output and is listed blank.
+ *
+ *	local variables:
+ *		a_uint	d		jr displacement
+ *		int	hi		search limit
+ *		int	k		rtval[] index of the merged address
+ *		int	lo		search limit
+ *		int	m		search index
+ *		struct lkrx *	xp	array of jumps
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		int	lkerr		error flag
+ *		a_uint	pc		relocated base address
+ *		int	rtcnt		number of values evaluated
+ *		int	rtflg[]		output the data flag
+ *		a_uint	rtval[]		relocated data
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		a_uint	gtb_xb()	lkrloc.c
+ *
+ *	side effects:
+ *		The T line data may be changed.
+ */
+
+VOID lkrjr(axp, rtbase)
+struct areax *axp;
+a_uint rtbase;
+{
+  struct lkrx *xp;
+  a_uint d;
+  int hi, k, lo, m;
+
+  if (rtcnt != (1 + 3 * a_bytes))
+    return;
+
+  xp = axp->a_rxp;
+  lo = 0;
+  hi = axp->a_nrx;
+  while (lo < hi) {
+    m = (lo + hi) / 2;
+    if (xp[m].x_ofs < rtbase) {
+      lo = m + 1;
+    } else {
+      hi = m;
+    }
+  }
+  if ((lo == axp->a_nrx) || (xp[lo].x_ofs != rtbase) ||
+      (xp[lo].x_state != RX_SHORT))
+    return;
+
+  k = 1 + 2 * a_bytes;
+  d = gtb_xb(k) - (pc + 2);
+  if (((d + 0x80) & 0xFFFF) >= 0x100) {
+    fprintf(stderr, "\n?ASlink-Warning-Relaxed jump range error at %X\n",
+            (unsigned int)(pc & 0xFFFF));
+    lkerr++;
+    return;
+  }
+  rtval[a_bytes] =
+      (xp[lo].x_op == 0xC3) ? 0x18 : (0x20 | (xp[lo].x_op & 0x18));
+  rtval[k] = d & 0xFF;
+  rtflg[k + 1] = 2;
+}
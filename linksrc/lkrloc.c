@@ -37,288 +37,2095 @@
  *	The module lkrloc.c contains the functions which
  *	perform the relocation calculations.
  *
+ *	The T, R, P, and E lines of all REL file versions
+ *	are processed by the same functions.  The parts which
+ *	depend on the REL file version, the R line symbol
+ *	bit, the relocation of a single R line entry, and
+ *	the error messages, are described by an entry of the
+ *	relfmt[] table which reloc() selects for the version
+ *	of the current REL file.  The relocation of the R line
+ *	entries is performed by relr3() in lkrloc3.c and
+ *	relr4() in lkrloc4.c.
+ *
  *	lkrloc.c contains the following functions:
  *		a_uint	adb_1b()
  *		a_uint	adb_2b()
  *		a_uint	adb_3b()
  *		a_uint	adb_4b()
+ *		a_uint	adb_byte()
+ *		a_uint	adb_sel()
  *		a_uint	adb_xb()
  *		a_uint	adw_xb()
+ *		VOID	erpdmp()
+ *		VOID	errdmp()
  *		a_uint	evword()
+ *		a_uint	gtb_1b()
+ *		a_uint	gtb_2b()
+ *		a_uint	gtb_3b()
+ *		a_uint	gtb_4b()
+ *		a_uint	gtb_xb()
  *		VOID	prntval()
+ *		a_uint	ptb_1b()
+ *		a_uint	ptb_2b()
+ *		a_uint	ptb_3b()
+ *		a_uint	ptb_4b()
+ *		a_uint	ptb_xb()
+ *		VOID	rele()
+ *		VOID	relerr()
+ *		VOID	relerp()
+ *		VOID	relfsel()
  *		VOID	reloc()
+ *		VOID	relofp()
+ *		VOID	relout()
+ *		VOID	relp()
+ *		VOID	relpply()
+ *		VOID	relr()
+ *		VOID	relref()
+ *		VOID	relrply()
+ *		VOID	relt()
+ *
+ *	lkrloc.c contains the following local variables:
+ *		struct relfmt	relfmt[]	REL file formats
+ *		struct relfmt *	rlfp		current REL file format
+ *		int	rlsave		T line is only saved
+ *		char	rltxt[]		saved T line
+ *
+ */
+
+static struct relfmt relfmt[] = {
+    {3, R3_AREA, R3_SYM, 0, relr3, errmsg3, " pgoffset"},
+    {4, R4_AREA, R4_SYM, A4_WLMSK, relr4, errmsg4, "    pgoffset"},
+    {0, 0, 0, 0, NULL, NULL, NULL}};
+
+static struct relfmt *rlfp;
+
+static int rlsave;
+static char rltxt[NINPUT];
+
+/*)Function	VOID	relfsel()
+ *
+ *	The function relfsel() selects the relfmt[] entry
+ *	of the current REL file version.
+ *
+ *	local variable:
+ *		struct relfmt *	fp	REL file format
+ *
+ *	global variables:
+ *		int	ASxxxx_VERSION	ASxxxx REL file version
+ *		struct relfmt	relfmt[]	REL file formats
+ *		struct relfmt *	rlfp	current REL file format
+ *
+ *	called functions:
+ *		int	fprintf()	c_library
+ *		VOID	lkexit()	lkmain.c
+ *
+ *	side effects:
+ *		rlfp is set.  An unknown version is fatal.
+ *
+ */
+
+VOID relfsel() {
+  struct relfmt *fp;
+
+  if ((rlfp == NULL) || (rlfp->f_vers != ASxxxx_VERSION)) {
+    for (fp = relfmt; fp->f_vers != 0; fp++) {
+      if (fp->f_vers == ASxxxx_VERSION)
+        break;
+    }
+    if (fp->f_vers == 0) {
+      fprintf(stderr, "Internal Version Error");
+      lkexit(ER_FATAL);
+    }
+    rlfp = fp;
+  }
+}
+
+/*)Function	VOID	reloc(c)
+ *
+ *		int c			process code
+ *
+ *	The function reloc() selects the relfmt[] entry of
+ *	the current REL file version and calls a particular
+ *	relocation function determined by the process code.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		int	lkerr		error flag
+ *		int	rlpar		parallel relocation mode
+ *		int	rlsave		T line is only saved
+ *
+ *	called functions:
+ *		int	fprintf()	c_library
+ *		int	lkprown()	lkpar.c
+ *		VOID	rele()		lkrloc.c
+ *		VOID	relfsel()	lkrloc.c
+ *		VOID	relp()		lkrloc.c
+ *		VOID	relr()		lkrloc.c
+ *		VOID	relt()		lkrloc.c
+ *
+ *	side effects:
+ *		Refer to the called relocation functions.
+ *
+ *	A parallel relocation worker skips the R lines of
+ *	the modules relocated by another worker.  The T lines
+ *	of these modules are only saved because the P lines,
+ *	which set the paging of all following modules, must
+ *	still be evaluated.
+ *
+ */
+
+VOID reloc(c)
+int c;
+{
+  relfsel();
+
+  /*
+   * Parallel Relocation
+   */
+  rlsave = 0;
+  if ((rlpar == PR_WORK) && (c != 'E')) {
+    if (lkprown() == 0) {
+      if (c == 'R')
+        return;
+      rlsave = 1;
+    }
+  }
+
+  switch (c) {
+
+  case 'T':
+    relt();
+    break;
+
+  case 'R':
+    relr();
+    break;
+
+  case 'P':
+    relp();
+    break;
+
+  case 'E':
+    rele();
+    break;
+
+  default:
+    fprintf(stderr, "Undefined Relocation Operation\n");
+    lkerr++;
+    break;
+  }
+}
+
+/*)Function	VOID	relt()
+ *
+ *	The function relt() evaluates a T line read by
+ *	the linker. Each byte value read is saved in the
+ *	rtval[] array, rtflg[] is set, and the number of
+ *	evaluations is maintained in rtcnt.
+ *
+ *		T Line
+ *
+ *		T xx xx nn nn nn nn nn ...
+ *
+ *
+ *		In:	"T n0 n1 n2 n3 ... nn"
+ *
+ *		Out:	  0    1    2    ..  rtcnt
+ *			+----+----+----+----+----+
+ *		  rtval | n0 | n1 | n2 | .. | nn |
+ *			+----+----+----+----+----+
+ *		  rtflag|  1 |  1 |  1 |  1 |  1 |
+ *			+----+----+----+----+----+
+ *
+ * 	The  T  line contains the assembled code output by the assem-
+ *	bler with xx xx being the offset address from the  current  area
+ *	base address and nn being the assembled instructions and data in
+ *	byte format.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		char *	ip		pointer into the REL file text line
+ *		int	rlsave		T line is only saved
+ *		char	rltxt[]		saved T line
+ *		int	rtcnt		number of values evaluated
+ *		int	rtflg[]		array of evaluation flags
+ *		int	rtval[]		array of evaluation values
+ *
+ *	called functions:
+ *		int	eval()		lkeval.c
+ *		int	more()		lklex.c
+ *		char *	strcpy()	c_library
+ *
+ *	side effects:
+ *		Linker input T line evaluated.
+ *
+ *	When the module is relocated by another worker
+ *	the T line is only saved for a following P line.
+ *
+ */
+
+VOID relt() {
+  if (rlsave) {
+    strcpy(rltxt, ip);
+    return;
+  }
+  rtcnt = 0;
+  while (more()) {
+    if (rtcnt < NTXT) {
+      rtval[rtcnt] = eval();
+      rtflg[rtcnt] = 1;
+      rterr[rtcnt] = 0;
+      rtcnt++;
+    }
+  }
+  lkst.st_cnt[ST_TREC] += 1;
+  if (rtcnt > a_bytes) {
+    lkst.st_cnt[ST_BYTES] += rtcnt - a_bytes;
+  }
+}
+
+/*)Function	VOID	relr()
+ *
+ *	The function relr() evaluates a R line read by
+ *	the linker.  The R line data is combined with the
+ *	previous T line data to perform the relocation of
+ *	code and data bytes.  The S19 / IHX output and
+ *	translation of the LST files to RST files may be
+ *	performed.
+ *
+ *		R Line
+ *
+ *		R 0 0 nn nn n1 n2 xx xx ...
+ *
+ * 	The R line provides the relocation information to the linker.
+ *	The nn nn value is the current area index, i.e.  which area  the
+ *	current  values  were  assembled.  Relocation information is en-
+ *	coded in groups of 4 bytes:
+ *
+ *	1.  n1 is the relocation mode and object format
+ *	2.  n2 is a byte index into the corresponding T line data
+ *	3.  xx xx  is the area/symbol index for the area/symbol be-
+ *	 	ing referenced.  the corresponding area/symbol is found
+ *		in the header area/symbol lists.
+ *
+ *	The groups of 4 bytes are repeated for each item requiring relo-
+ *	cation in the preceeding T line.  relr() decodes each group and
+ *	looks up the area/symbol value, the relocation of the T line
+ *	data is done by the f_rent function of the REL file format
+ *	which interprets the version dependent n1 and n2 bits.
+ *
+ *	local variable:
+ *		areax	**a		pointer to array of area pointers
+ *		int	aindex		area index
+ *		int	error		error code
+ *		int	i		loop counter
+ *		int	n		number of relocation entries
+ *		struct relent	re	relocation entry
+ *		a_uint	rtbase		base code address
+ *		sym	**s		pointer to array of symbol pointers
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		a_uint	a_mask		address mask
+ *		area	*ap	        pointer to the area structure
+ *		head	*hp		pointer to the head structure
+ *		int	lkerr		error flag
+ *		int	oflag		output type flag
+ *		FILE	*ofp	        object output file handle
+ *		a_uint	pc		relocated base address
+ *		int	pcb	        bytes per instruction word
+ *		rerr	rerr		linker error structure
+ *		struct relfmt *	rlfp	current REL file format
+ *		int	rlpar		parallel relocation mode
+ *		bank	*rtabnk	        current bank structure
+ *		int	rtaflg		current bank structure flags
+ *		int	rtcnt		number of values evaluated
+ *		int	rtend		end of the rtval[] data read
+ *		FILE	*stderr		standard error device
+ *		int	uflag		relocation listing flag
+ *
+ *	called functions:
+ *		a_uint	adb_xb()	lkrloc.c
+ *		a_uint	evword()	lkrloc.c
+ *		int	eval()		lkeval.c
+ *		int	fprintf()	c_library
+ *		a_uint	gtb_xb()	lkrloc.c
+ *		VOID	lkirec()	lkincr.c
+ *		VOID	lkprerr()	lkpar.c
+ *		VOID	lkprput()	lkpar.c
+ *		a_uint	lkrbef()	lkrelax.c
+ *		VOID	lkrjr()		lkrelax.c
+ *		int	more()		lklex.c
+ *		VOID	relerr()	lkrloc.c
+ *		VOID	relofp()	lkrloc.c
+ *		VOID	relout()	lkrloc.c
+ *		int	symval()	lksym.c
+ *		int	(*f_rent)()	lkrloc3.c / lkrloc4.c
+ *
+ *	side effects:
+ *		The R and T lines are combined to produce
+ *		relocated code and data.  Output Sxx / Ixx
+ *		and relocated listing files may be produced.
+ *
+ *	The R line of an areax removed by lkgc() is skipped.
+ *
+ *	The addresses in an areax with relaxed jumps are less
+ *	the bytes removed before them, a relaxed jump of the
+ *	line is output as a jr by lkrjr().
+ *
+ *	A parallel relocation worker saves the relocated data
+ *	and errors with lkprput() instead of the output.  The
+ *	main process then replays the saved data with relrply()
+ *	in the order of the R lines.
+ *
+ */
+
+VOID relr() {
+  struct relent re;
+  int aindex, error, i, n;
+  a_uint rtbase;
+  struct areax **a;
+  struct sym **s;
+
+  /*
+   * Get area and symbol lists
+   */
+  a = hp->a_list;
+  s = hp->s_list;
+
+  lkst.st_cnt[ST_RREC] += 1;
+
+  /*
+   * Verify Area Mode
+   */
+  if (eval() != rlfp->f_area || eval()) {
+    fprintf(stderr, "R input error\n");
+    lkerr++;
+    return;
+  }
+
+  /*
+   * Get area pointer
+   */
+  aindex = (int)evword();
+  if (aindex >= hp->h_narea) {
+    fprintf(stderr, "R area error\n");
+    lkerr++;
+    return;
+  }
+
+  /*
+   * A section removed by the area
+   * garbage collection is not output
+   */
+  if (a[aindex]->a_gc == GC_DEAD) {
+    return;
+  }
+
+  /*
+   * Select Output File
+   */
+  if (oflag != 0) {
+    relofp(a[aindex]);
+  }
+
+  /*
+   * Base values:
+   *	rtbase is the base address from the T line
+   *	rtofst is the number of T line data bytes
+   *		discarded during processing
+   *
+   */
+  rtend = 0;
+  rtbase = adb_xb(0, 0);
+  re.e_rtofst = a_bytes;
+
+  /*
+   * Relocate address, less the bytes
+   * removed by the branch relaxation
+   */
+  pc = adb_xb(a[aindex]->a_addr - lkrbef(a[aindex], rtbase & a_mask), 0);
+
+  /*
+   * Number of 'bytes' per PC address
+   */
+  pcb = 1 + (rlfp->f_wlmsk & a[aindex]->a_bap->a_flag);
+
+  /*
+   * Do remaining relocations
+   */
+  for (n = 0; more(); n++) {
+    re.e_relv = 0;
+    re.e_rtpofst = re.e_rtofst;
+    re.e_mode = (int)eval();
+    re.e_rtp = (int)eval();
+    re.e_rindex = (int)evword();
+
+    /*
+     * Relocation Statistics
+     */
+    lkst.st_cnt[ST_RELOC] += 1;
+    if (re.e_mode & rlfp->f_sym) {
+      lkst.st_cnt[ST_RSYM] += 1;
+    }
+
+    /*
+     * Symbol or Area references
+     */
+    if (re.e_mode & rlfp->f_sym) {
+      if (re.e_rindex >= hp->h_nsym) {
+        fprintf(stderr, "R symbol error\n");
+        lkerr++;
+        return;
+      }
+      re.e_reli = symval(s[re.e_rindex]);
+    } else {
+      if (re.e_rindex >= hp->h_narea) {
+        fprintf(stderr, "R area error\n");
+        lkerr++;
+        return;
+      }
+      re.e_reli = a[re.e_rindex]->a_addr;
+      if (a[re.e_rindex]->a_nrx != 0) {
+        re.e_reli -= lkrbef(a[re.e_rindex],
+                             gtb_xb(re.e_rtp & 0x0F) & a_mask);
+      }
+    }
+
+    /*
+     * Relocate the T line data
+     */
+    error = (*rlfp->f_rent)(&re);
+
+    /*
+     * Error Processing
+     */
+    if (error) {
+      lkst.st_cnt[ST_RERR] += 1;
+      rerr.aindex = aindex;
+      rerr.mode = re.e_mode;
+      rerr.rtbase = rtbase + ((re.e_rtp - re.e_rtpofst) / pcb);
+      rerr.rindex = re.e_rindex;
+      rerr.rval = re.e_relv - re.e_reli;
+      if (rlpar == PR_WORK) {
+        lkprerr(error);
+      } else {
+        relerr(rlfp->f_errmsg[error]);
+      }
+
+      for (i = re.e_rtp; i < re.e_rtp + a_bytes; i++) {
+        if (rtflg[i]) {
+          rterr[i] = error;
+          break;
+        }
+      }
+    }
+  }
+
+  /*
+   * A relaxed jump is output as a jr
+   */
+  if (a[aindex]->a_nrx != 0) {
+    lkrjr(a[aindex], rtbase & a_mask);
+  }
+
+  /*
+   * A worker saves the relocated data.  Data
+   * read past the T line depends on the previous
+   * T lines and fails the worker.
+   */
+  if (rlpar == PR_WORK) {
+    if (rtend > rtcnt)
+      lkerr++;
+    lkprput(aindex, n);
+    return;
+  }
+  /*
+   * The -mm relink saves the relocated data
+   */
+  lkirec(aindex, n);
+  relout(n);
+}
+
+/*)Function	VOID	relofp(axp)
+ *
+ *		areax	*axp		pointer to the R line area
+ *
+ *	The function relofp() selects the output file
+ *	and the bank of the area of the current R line.
+ *	The output of the previous file is flushed when
+ *	the file changes.
+ *
+ *	local variable:
+ *		int	ph		previous statistics phase
+ *
+ *	global variables:
+ *		area	*ap	        pointer to the area structure
+ *		FILE	*ofp	        object output file handle
+ *		bank	*rtabnk	        current bank structure
+ *		int	rtaflg		current bank structure flags
+ *
+ *	called functions:
+ *		VOID	lkflush()	lkout.c
+ *		int	stphase()	lkstat.c
+ *
+ *	side effects:
+ *		The output file and bank are changed.
+ *
+ */
+
+VOID relofp(axp)
+struct areax *axp;
+{
+  int ph;
+
+  ap = axp->a_bap;
+  if (ofp != NULL) {
+    rtabnk->b_rtaflg = rtaflg;
+    if (ofp != ap->a_ofp) {
+      ph = stphase(PH_OUTPUT);
+      lkflush();
+      stphase(ph);
+    }
+  }
+  ofp = ap->a_ofp;
+  rtabnk = ap->a_bp;
+  rtaflg = rtabnk->b_rtaflg;
+}
+
+/*)Function	VOID	relout(n)
+ *
+ *		int	n		number of relocation entries
+ *
+ *	The function relout() outputs the relocated data
+ *	of the current R line to the relocated listing and
+ *	to the output file.
+ *
+ *	local variable:
+ *		int	ph		previous statistics phase
+ *
+ *	global variables:
+ *		int	obj_flag	Linked file/library object flag
+ *		int	oflag		output type flag
+ *		bank	*rtabnk	        current bank structure
+ *		int	uflag		relocation listing flag
+ *
+ *	called functions:
+ *		VOID	lkout()		lkout.c
+ *		VOID	lkulist		lklist.c
+ *		int	stphase()	lkstat.c
+ *
+ *	side effects:
+ *		Output Sxx / Ixx and relocated
+ *		listing files may be produced.
+ *
+ */
+
+VOID relout(n)
+int n;
+{
+  int ph;
+
+  /*
+   * Bank Has Output
+   */
+  if ((n != 0) && (oflag != 0) && (obj_flag == 0)) {
+    rtabnk->b_oflag = 1;
+  }
+  if (uflag != 0) {
+    ph = stphase(PH_LIST);
+    lkulist(1);
+    stphase(ph);
+  }
+  if (oflag != 0) {
+    ph = stphase(PH_OUTPUT);
+    lkout(1);
+    stphase(ph);
+  }
+}
+
+/*)Function	VOID	relrply(aindex, n)
+ *
+ *		int	aindex		R line area index
+ *		int	n		number of relocation entries
+ *
+ *	The function relrply() replays an R line relocated
+ *	by a parallel relocation worker.  The relocated data
+ *	and the errors have been restored by lkprply(), the
+ *	errors are reported and the data is output as by
+ *	relr().
+ *
+ *	local variable:
+ *		int	error		error code
+ *
+ *	global variables:
+ *		head	*hp		pointer to the head structure
+ *		int	oflag		output type flag
+ *		struct relfmt *	rlfp	current REL file format
+ *
+ *	called functions:
+ *		int	lkprnxt()	lkpar.c
+ *		VOID	relerr()	lkrloc.c
+ *		VOID	relfsel()	lkrloc.c
+ *		VOID	relofp()	lkrloc.c
+ *		VOID	relout()	lkrloc.c
+ *
+ *	side effects:
+ *		Errors reported.  Output Sxx / Ixx and
+ *		relocated listing files may be produced.
+ *
+ */
+
+VOID relrply(aindex, n)
+int aindex;
+int n;
+{
+  int error;
+
+  relfsel();
+  if (oflag != 0) {
+    relofp(hp->a_list[aindex]);
+  }
+  while ((error = lkprnxt()) != 0) {
+    relerr(rlfp->f_errmsg[error]);
+  }
+  relout(n);
+}
+
+/*)Function	VOID	relpply(str)
+ *
+ *		char	*str		error string
+ *
+ *	The function relpply() replays a paging error
+ *	found by a parallel relocation worker.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		none
+ *
+ *	called functions:
+ *		VOID	relerp()	lkrloc.c
+ *		VOID	relfsel()	lkrloc.c
+ *
+ *	side effects:
+ *		Error reported.
+ *
+ */
+
+VOID relpply(str)
+char *str;
+{
+  relfsel();
+  relerp(str);
+}
+
+/*)Function	VOID	relref(c)
+ *
+ *		int	c		line type: T, R or P
+ *
+ *	The function relref() evaluates a T, R or P line read
+ *	in pass 0.  For the area garbage collection each
+ *	symbol or area referenced by a R or P line is linked
+ *	to the areax of the line by lkgadd().  For a module
+ *	assembled for the branch relaxation the T line is
+ *	saved and a jump alone in the T line and relocated
+ *	with the relaxable jump mode is linked to the areax
+ *	by lkradd().  A line in error is skipped, the
+ *	error is reported in pass 1.
+ *
+ *	local variable:
+ *		areax	**a		pointer to array of area pointers
+ *		int	aindex		area index
+ *		int	i		rtval[] index of the jump address
+ *		int	mode		relocation mode
+ *		areax	*rap		referenced areax
+ *		int	rindex		symbol / area index
+ *		sym	*rsp		referenced symbol
+ *		int	rtp		R line data index
+ *		sym	**s		pointer to array of symbol pointers
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *		a_uint	a_mask		address mask
+ *		int	gcflag		Area garbage collection flag
+ *		head	*hp		pointer to the head structure
+ *		struct relfmt *	rlfp	current REL file format
+ *		int	rtcnt		number of values evaluated
+ *		a_uint	rtval[]		T line values
+ *
+ *	called functions:
+ *		a_uint	evword()	lkrloc.c
+ *		int	eval()		lkeval.c
+ *		a_uint	gtb_xb()	lkrloc.c
+ *		VOID	lkgadd()	lkgc.c
+ *		VOID	lkradd()	lkrelax.c
+ *		int	more()		lklex.c
+ *		VOID	relfsel()	lkrloc.c
+ *
+ *	side effects:
+ *		The references and jumps of the areax are updated.
+ *
+ */
+
+VOID relref(c)
+int c;
+{
+  int aindex, i, mode, rindex, rtp;
+  struct areax **a;
+  struct areax *rap;
+  struct sym **s;
+  struct sym *rsp;
+
+  if (hp == NULL)
+    return;
+  /*
+   * Save the T line of a relaxed module
+   */
+  if (c == 'T') {
+    if (hp->h_rmode == 0)
+      return;
+    rtcnt = 0;
+    while (more() && (rtcnt < NTXT)) {
+      rtval[rtcnt++] = eval();
+    }
+    return;
+  }
+  a = hp->a_list;
+  s = hp->s_list;
+
+  relfsel();
+  if ((eval() != rlfp->f_area) || eval())
+    return;
+  aindex = (int)evword();
+  if (aindex >= hp->h_narea)
+    return;
+
+  mode = 0;
+  rtp = 0;
+  rap = NULL;
+  rsp = NULL;
+  while (more()) {
+    mode = (int)eval();
+    rtp = (int)eval();
+    rindex = (int)evword();
+    if (mode & rlfp->f_sym) {
+      if (rindex >= hp->h_nsym)
+        return;
+      rap = NULL;
+      rsp = s[rindex];
+    } else {
+      if (rindex >= hp->h_narea)
+        return;
+      rap = a[rindex];
+      rsp = NULL;
+    }
+    if (gcflag)
+      lkgadd(a[aindex], rap, rsp);
+  }
+
+  /*
+   * A jump alone in its T line with the
+   * relaxable jump mode of the module
+   */
+  if ((c == 'R') && (hp->h_rmode != 0) && (a_bytes == 2) &&
+      ((rap != NULL) || (rsp != NULL)) &&
+      (((rtp >> 4) & 0x0F) == hp->h_rmode) &&
+      ((mode & ~rlfp->f_sym) == R4_WORD)) {
+    i = rtp & 0x0F;
+    if ((i == (a_bytes + 1)) && ((i + 2 * a_bytes) == rtcnt)) {
+      lkradd(a[aindex], gtb_xb(0) & a_mask, (int)(rtval[a_bytes] & 0xFF),
+             rsp, rap, gtb_xb(i) & a_mask);
+    }
+  }
+}
+
+/*)Function	VOID	relp()
+ *
+ *	The function relp() evaluates a P line read by
+ *	the linker.  The P line data is combined with the
+ *	previous T line data to set the base page address
+ *	and test the paging boundary and length.
+ *
+ *		P Line
+ *
+ *		P 0 0 nn nn n1 n2 xx xx
+ *
+ * 	The  P  line provides the paging information to the linker as
+ *	specified by a .setdp directive.  The format of  the  relocation
+ *	information is identical to that of the R line.  The correspond-
+ *	ing T line has the following information:
+ *		T xx xx aa aa bb bb
+ *
+ * 	Where  aa aa is the area reference number which specifies the
+ *	selected page area and bb bb is the base address  of  the  page.
+ *	bb bb will require relocation processing if the 'n1 n2 xx xx' is
+ *	specified in the P line.  The linker will verify that  the  base
+ *	address is on a 256 byte boundary and that the page length of an
+ *	area defined with the PAG type is not larger than 256 bytes.
+ *
+ *	local variable:
+ *		areax	**a		pointer to array of area pointers
+ *		int	aindex		area index
+ *		int	mode		relocation mode
+ *		char *	pip		saved REL file text pointer
+ *		a_uint	relv		relocation value
+ *		int	rindex		symbol / area index
+ *		int	rtp		index into T data
+ *		sym	**s		pointer to array of symbol pointers
+ *
+ *	global variables:
+ *		head	*hp		pointer to the head structure
+ *		int	lkerr		error flag
+ *		char *	ip		pointer into the REL file text line
+ *		a_uint	p_mask		page mask
+ *		struct relfmt *	rlfp	current REL file format
+ *		int	rlpar		parallel relocation mode
+ *		int	rlsave		T line is only saved
+ *		char	rltxt[]		saved T line
+ *		int	rtcnt		number of values evaluated
+ *		int	rtend		end of the rtval[] data read
+ *		sdp	sdp		base page structure
+ *		FILE	*stderr		standard error device
+ *
+ *	called functions:
+ *		a_uint	adb_xb()	lkrloc.c
+ *		a_uint	evword()	lkrloc.c
+ *		int	eval()		lkeval.c
+ *		int	fprintf()	c_library
+ *		int	more()		lklex.c
+ *		VOID	relerp()	lkrloc.c
+ *		int	symval()	lksym.c
+ *
+ *	side effects:
+ *		The P and T lines are combined to set
+ *		the base page address and report any
+ *		paging errors.
+ *
+ */
+
+VOID relp() {
+  int aindex, rindex;
+  int mode, rtp;
+  a_uint relv;
+  char *pip;
+  struct areax **a;
+  struct sym **s;
+
+  /*
+   * Get area and symbol lists
+   */
+  a = hp->a_list;
+  s = hp->s_list;
+
+  /*
+   * Evaluate the saved T line
+   */
+  if (rlsave) {
+    pip = ip;
+    ip = rltxt;
+    rtcnt = 0;
+    while (more()) {
+      if (rtcnt < NTXT) {
+        rtval[rtcnt] = eval();
+        rtflg[rtcnt] = 1;
+        rterr[rtcnt] = 0;
+        rtcnt++;
+      }
+    }
+    ip = pip;
+  }
+  rtend = 0;
+
+  /*
+   * Verify Area Mode
+   */
+  if ((eval() != rlfp->f_area) || eval()) {
+    fprintf(stderr, "P input error\n");
+    lkerr++;
+  }
+
+  /*
+   * Get area pointer
+   */
+  aindex = (int)evword();
+  if (aindex >= hp->h_narea) {
+    fprintf(stderr, "P area error\n");
+    lkerr++;
+    return;
+  }
+
+  /*
+   * Do remaining relocations
+   */
+  while (more()) {
+    mode = (int)eval();
+    rtp = (int)eval();
+    rindex = (int)evword();
+
+    /*
+     * Symbol or Area references
+     */
+    if (mode & rlfp->f_sym) {
+      if (rindex >= hp->h_nsym) {
+        fprintf(stderr, "P symbol error\n");
+        lkerr++;
+        return;
+      }
+      relv = symval(s[rindex]);
+    } else {
+      if (rindex >= hp->h_narea) {
+        fprintf(stderr, "P area error\n");
+        lkerr++;
+        return;
+      }
+      relv = a[rindex]->a_addr;
+    }
+    adb_xb(relv, rtp);
+  }
+
+  /*
+   * Paged values
+   */
+  aindex = (int)adb_xb(0, a_bytes);
+  if (aindex >= hp->h_narea) {
+    fprintf(stderr, "P area error\n");
+    lkerr++;
+    return;
+  }
+  sdp.s_areax = a[aindex];
+  sdp.s_area = sdp.s_areax->a_bap;
+  sdp.s_addr = adb_xb(0, a_bytes * 2);
+  if (rtcnt > a_bytes * 3) {
+    p_mask = adb_xb(0, a_bytes * 3);
+  }
+  if (sdp.s_area->a_addr & p_mask || sdp.s_addr & p_mask)
+    relerp("Page Definition Boundary Error");
+
+  /*
+   * Data read past the T line
+   * fails a parallel relocation worker
+   */
+  if ((rlpar == PR_WORK) && (rtend > rtcnt))
+    lkerr++;
+}
+
+/*)Function	VOID	rele()
+ *
+ *	The function rele() closes all open output files
+ *	at the end of the linking process.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		int	oflag		output type flag
+ *		int	uflag		relocation listing flag
+ *
+ *	called functions:
+ *		VOID	lkfclose()	lkbank.c
+ *		VOID	lkflush()	lkout.c
+ *		VOID	lkulist()	lklist.c
+ *		int	stphase()	lkstat.c
+ *
+ *	side effects:
+ *		All open output files are closed.
+ *
+ */
+
+VOID rele() {
+  int ph;
+
+  if (uflag != 0) {
+    ph = stphase(PH_LIST);
+    lkulist(0);
+    stphase(ph);
+  }
+  if (oflag != 0) {
+    ph = stphase(PH_OUTPUT);
+    lkflush();
+    lkfclose();
+    stphase(ph);
+  }
+}
+
+/*)Function	VOID	relerr(str)
+ *
+ *		char	*str		error string
+ *
+ *	The function relerr() outputs the error string to
+ *	stderr and to the map file (if it is open).
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		FILE	*mfp		handle for the map file
+ *
+ *	called functions:
+ *		VOID	errdmp()	lkrloc.c
+ *
+ *	side effects:
+ *		Error message inserted into map file.
+ *
+ */
+
+VOID relerr(str)
+char *str;
+{
+  errdmp(stderr, str);
+  if (mfp)
+    errdmp(mfp, str);
+}
+
+/*)Function	VOID	errdmp(fptr, str)
+ *
+ *		FILE	*fptr		output file handle
+ *		char	*str		error string
+ *
+ *	The function errdmp() outputs the error string str
+ *	to the device specified by fptr.  Additional information
+ *	is output about the definition and referencing of
+ *	the symbol / area error.
+ *
+ *	local variable:
+ *		int	mode		error mode
+ *		int	aindex		area index
+ *		int	lkerr		error flag
+ *		int	rindex		error index
+ *		sym	**s		pointer to array of symbol pointers
+ *		areax	**a		pointer to array of area pointers
+ *		areax	*raxp		error area extension pointer
+ *
+ *	global variables:
+ *		struct relfmt *	rlfp	current REL file format
+ *		sdp	sdp		base page structure
+ *
+ *	called functions:
+ *		int	fprintf()	c_library
+ *		VOID	prntval()	lkrloc.c
+ *
+ *	side effects:
+ *		Error reported.
+ *
+ */
+
+VOID errdmp(fptr, str)
+FILE *fptr;
+char *str;
+{
+  int mode, aindex, rindex;
+  struct sym **s;
+  struct areax **a;
+  struct areax *raxp;
+
+  a = hp->a_list;
+  s = hp->s_list;
+
+  mode = rerr.mode;
+  aindex = rerr.aindex;
+  rindex = rerr.rindex;
+
+  /*
+   * Print Error
+   */
+  fprintf(fptr, "\n?ASlink-Warning-%s", str);
+  lkerr++;
+
+  /*
+   * Print symbol if symbol based
+   */
+  if (mode & rlfp->f_sym) {
+    fprintf(fptr, " for symbol  %s\n", &s[rindex]->s_id[0]);
+  } else {
+    fprintf(fptr, "\n");
+  }
+
+  /*
+   * Print Ref Info
+   */
+  /*         11111111112222222222333333333344444444445555555555666666666677777*/
+  /*12345678901234567890123456789012345678901234567890123456789012345678901234*/
+  /*        |                 |                 |                 |           */
+  fprintf(fptr, "         file              module            area             "
+                "      offset\n");
+  fprintf(fptr, "  Refby  %-14.14s    %-14.14s    %-14.14s    ",
+          hp->h_lfile->f_idp, &hp->m_id[0], &a[aindex]->a_bap->a_id[0]);
+  prntval(fptr, rerr.rtbase);
+
+  /*
+   * Print Def Info
+   */
+  if (mode & rlfp->f_sym) {
+    raxp = s[rindex]->s_axp;
+  } else {
+    raxp = a[rindex];
+  }
+  /*         11111111112222222222333333333344444444445555555555666666666677777*/
+  /*12345678901234567890123456789012345678901234567890123456789012345678901234*/
+  /*        |                 |                 |                 |           */
+  fprintf(fptr, "  Defin  %-14.14s    %-14.14s    %-14.14s    ",
+          raxp->a_bhp->h_lfile->f_idp, &raxp->a_bhp->m_id[0],
+          &raxp->a_bap->a_id[0]);
+  if (mode & rlfp->f_sym) {
+    prntval(fptr, s[rindex]->s_addr);
+  } else {
+    prntval(fptr, rerr.rval);
+  }
+}
+
+/*)Function	VOID	relerp(str)
+ *
+ *		char	*str		error string
+ *
+ *	The function relerp() outputs the paging error string to
+ *	stderr and to the map file (if it is open).
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		FILE	*mfp		handle for the map file
+ *		int	rlpar		parallel relocation mode
+ *		int	rlsave		T line is only saved
+ *
+ *	called functions:
+ *		VOID	erpdmp()	lkrloc.c
+ *		VOID	lkprerp()	lkpar.c
+ *
+ *	side effects:
+ *		Error message inserted into map file.
+ *
+ *	A parallel relocation worker saves the paging
+ *	errors of its own modules for the replay.
+ *
+ */
+
+VOID relerp(str)
+char *str;
+{
+  if (rlpar == PR_WORK) {
+    if (rlsave == 0)
+      lkprerp(str);
+    return;
+  }
+  erpdmp(stderr, str);
+  if (mfp)
+    erpdmp(mfp, str);
+}
+
+/*)Function	VOID	erpdmp(fptr, str)
+ *
+ *		FILE	*fptr		output file handle
+ *		char	*str		error string
+ *
+ *	The function erpdmp() outputs the error string str
+ *	to the device specified by fptr.
+ *
+ *	local variable:
+ *		head	*thp		pointer to head structure
+ *
+ *	global variables:
+ *		int	lkerr		error flag
+ *		struct relfmt *	rlfp	current REL file format
+ *		sdp	sdp		base page structure
+ *
+ *	called functions:
+ *		int	fprintf()	c_library
+ *		VOID	prntval()	lkrloc.c
+ *
+ *	side effects:
+ *		Error reported.
+ *
+ */
+
+VOID erpdmp(fptr, str)
+FILE *fptr;
+char *str;
+{
+  struct head *thp;
+
+  thp = sdp.s_areax->a_bhp;
+
+  /*
+   * Print Error
+   */
+  fprintf(fptr, "\n?ASlink-Warning-%s\n", str);
+  lkerr++;
+
+  /*
+   * Print PgDef Info
+   */
+  /*         111111111122222222223333333333444444444455555555556666666666777*/
+  /*123456789012345678901234567890123456789012345678901234567890123456789012*/
+  fprintf(fptr, "         file              module            pgarea           "
+                "%s\n",
+          rlfp->f_pghdr);
+  fprintf(fptr, "  PgDef  %-14.14s    %-14.14s    %-14.14s    ",
+          thp->h_lfile->f_idp, &thp->m_id[0], &sdp.s_area->a_id[0]);
+  prntval(fptr, sdp.s_area->a_addr + sdp.s_addr);
+}
+
+/*)Function	a_uint 	evword()
+ *
+ *	The function evword() combines two byte values
+ *	into a single word value.
+ *
+ *	local variable:
+ *		a_uint	v		temporary evaluation variable
+ *
+ *	global variables:
+ *		hilo			byte ordering parameter
+ *
+ *	called functions:
+ *		int	eval()		lkeval.c
+ *
+ *	side effects:
+ *		Relocation text line is scanned to combine
+ *		two byte values into a single word value.
+ *
+ */
+
+a_uint evword() {
+  a_uint v;
+
+  if (hilo) {
+    v = (eval() << 8);
+    v += eval();
+  } else {
+    v = eval();
+    v += (eval() << 8);
+  }
+  return (v);
+}
+
+/*)Function	a_uint 	adb_1b(v, i)
+ *
+ *		a_uint	v		value to add to byte
+ *		int	i		rtval[] index
+ *
+ *	The function adb_1b() adds the value of v to
+ *	the single byte value contained in rtval[i].
+ *	The new value of rtval[i] is returned.
+ *
+ *	local variable:
+ *		a_uint	j		temporary evaluation variable
+ *
+ *	global variables:
+ *		int	rtend		end of the rtval[] data read
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		The byte value of rtval[] is changed.
+ *
+ */
+
+a_uint adb_1b(v, i)
+a_uint v;
+int i;
+{
+  a_uint j;
+
+  if (i + 1 > rtend)
+    rtend = i + 1;
+
+  j = v + rtval[i];
+  rtval[i] = j & ((a_uint)0x000000FF);
+
+  return (j);
+}
+
+/*)Function	a_uint 	adb_2b(v, i)
+ *
+ *		a_uint	v		value to add to word
+ *		int	i		rtval[] index
+ *
+ *	The function adb_2b() adds the value of v to the
+ *	2 byte value contained in rtval[i] and rtval[i+1].
+ *	The new value of rtval[i] / rtval[i+1] is returned.
+ *
+ *	local variable:
+ *		a_uint	j		temporary evaluation variable
+ *
+ *	global variables:
+ *		hilo			byte ordering parameter
+ *		int	rtend		end of the rtval[] data read
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		The 2 byte value of rtval[] is changed.
+ *
+ */
+
+a_uint adb_2b(v, i)
+a_uint v;
+int i;
+{
+  a_uint j;
+
+  if (i + 2 > rtend)
+    rtend = i + 2;
+
+  if (hilo) {
+    j = v + (rtval[i + 0] << 8) + (rtval[i + 1] << 0);
+    rtval[i + 0] = (j >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (j >> 0) & ((a_uint)0x000000FF);
+  } else {
+    j = v + (rtval[i + 0] << 0) + (rtval[i + 1] << 8);
+    rtval[i + 0] = (j >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
+  }
+  return (j);
+}
+
+/*)Function	a_uint 	adb_3b(v, i)
+ *
+ *		a_uint	v		value to add to word
+ *		int	i		rtval[] index
+ *
+ *	The function adb_3b() adds the value of v to the
+ *	three byte value contained in rtval[i], rtval[i+1], and rtval[i+2].
+ *	The new value of rtval[i] / rtval[i+1] / rtval[i+2] is returned.
+ *
+ *	local variable:
+ *		a_uint	j		temporary evaluation variable
+ *
+ *	global variables:
+ *		hilo			byte ordering parameter
+ *		int	rtend		end of the rtval[] data read
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		The 3 byte value of rtval[] is changed.
+ *
+ */
+
+a_uint adb_3b(v, i)
+a_uint v;
+int i;
+{
+  a_uint j;
+
+  if (i + 3 > rtend)
+    rtend = i + 3;
+
+  if (hilo) {
+    j = v + (rtval[i + 0] << 16) + (rtval[i + 1] << 8) + (rtval[i + 2] << 0);
+    rtval[i + 0] = (j >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (j >> 0) & ((a_uint)0x000000FF);
+  } else {
+    j = v + (rtval[i + 0] << 0) + (rtval[i + 1] << 8) + (rtval[i + 2] << 16);
+    rtval[i + 0] = (j >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (j >> 16) & ((a_uint)0x000000FF);
+  }
+  return (j);
+}
+
+/*)Function	a_uint 	adb_4b(v, i)
+ *
+ *		a_uint	v		value to add to word
+ *		int	i		rtval[] index
+ *
+ *	The function adb_4b() adds the value of v to the
+ *	four byte value contained in rtval[i], ..., rtval[i+3].
+ *	The new value of rtval[i], ...,  rtval[i+3] is returned.
+ *
+ *	local variable:
+ *		a_uint	j		temporary evaluation variable
+ *
+ *	global variables:
+ *		hilo			byte ordering parameter
+ *		int	rtend		end of the rtval[] data read
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		The 4 byte value of rtval[] is changed.
+ *
+ */
+
+a_uint adb_4b(v, i)
+a_uint v;
+int i;
+{
+  a_uint j;
+
+  if (i + 4 > rtend)
+    rtend = i + 4;
+
+  if (hilo) {
+    j = v + (rtval[i + 0] << 24) + (rtval[i + 1] << 16) + (rtval[i + 2] << 8) +
+        (rtval[i + 3] << 0);
+    rtval[i + 0] = (j >> 24) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (j >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (j >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 3] = (j >> 0) & ((a_uint)0x000000FF);
+  } else {
+    j = v + (rtval[i + 0] << 0) + (rtval[i + 1] << 8) + (rtval[i + 2] << 16) +
+        (rtval[i + 3] << 24);
+    rtval[i + 0] = (j >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (j >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 3] = (j >> 24) & ((a_uint)0x000000FF);
+  }
+  return (j);
+}
+
+/*)Function	a_uint 	adb_xb(v, i)
+ *
+ *		a_uint	v		value to add to x-bytes
+ *		int	i		rtval[] index
+ *
+ *	The function adb_xb() adds the value of v to
+ *	the value contained in rtval[i] for x-bytes.
+ *	The new value of rtval[i] for x-bytes is returned.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		int	a_bytes		T Line Address Bytes
+ *
+ *	called functions:
+ *		a_uint	adb_1b()	lkrloc.c
+ *		a_uint	adb_2b()	lkrloc.c
+ *		a_uint	adb_3b()	lkrloc.c
+ *		a_uint	adb_4b()	lkrloc.c
+ *
+ *	side effects:
+ *		The x-byte value of rtval[] is changed.
+ *
+ */
+
+a_uint adb_xb(v, i)
+a_uint v;
+int i;
+{
+  a_uint j;
+
+#ifdef LONGINT
+  switch (a_bytes) {
+  case 1:
+    j = adb_1b(v, i);
+    j = (j & ((a_uint)0x00000080l) ? j | ~((a_uint)0x0000007Fl)
+                                   : j & ((a_uint)0x0000007Fl));
+    break;
+  case 2:
+    j = adb_2b(v, i);
+    j = (j & ((a_uint)0x00008000l) ? j | ~((a_uint)0x00007FFFl)
+                                   : j & ((a_uint)0x00007FFFl));
+    break;
+  case 3:
+    j = adb_3b(v, i);
+    j = (j & ((a_uint)0x00800000l) ? j | ~((a_uint)0x007FFFFFl)
+                                   : j & ((a_uint)0x007FFFFFl));
+    break;
+  case 4:
+    j = adb_4b(v, i);
+    j = (j & ((a_uint)0x80000000l) ? j | ~((a_uint)0x7FFFFFFFl)
+                                   : j & ((a_uint)0x7FFFFFFFl));
+    break;
+  default:
+    j = 0;
+    break;
+  }
+#else
+  switch (a_bytes) {
+  case 1:
+    j = adb_1b(v, i);
+    j = (j & ((a_uint)0x00000080) ? j | ~((a_uint)0x0000007F)
+                                  : j & ((a_uint)0x0000007F));
+    break;
+  case 2:
+    j = adb_2b(v, i);
+    j = (j & ((a_uint)0x00008000) ? j | ~((a_uint)0x00007FFF)
+                                  : j & ((a_uint)0x00007FFF));
+    break;
+  case 3:
+    j = adb_3b(v, i);
+    j = (j & ((a_uint)0x00800000) ? j | ~((a_uint)0x007FFFFF)
+                                  : j & ((a_uint)0x007FFFFF));
+    break;
+  case 4:
+    j = adb_4b(v, i);
+    j = (j & ((a_uint)0x80000000) ? j | ~((a_uint)0x7FFFFFFF)
+                                  : j & ((a_uint)0x7FFFFFFF));
+    break;
+  default:
+    j = 0;
+    break;
+  }
+#endif
+  return (j);
+}
+
+/*)Function	a_uint 	adw_xb(x, v, i)
+ *
+ *		int	x		number of bytes to allow
+ *		a_uint	v		value to add to byte
+ *		int	i		rtval[] index
+ *
+ *	The function adw_xb() adds the value of v to the
+ *	value contained in rtval[i] through rtval[i + a_bytes - 1].
+ *	The new value of rtval[i] .... is returned.
+ *	The rtflg[] is cleared for bytes of higher order than x.
+ *
+ *	local variable:
+ *		a_uint	j		temporary evaluation variable
+ *
+ *	global variables:
+ *		int	a_bytes		T line byte count
+ *		int	hilo		byte ordering parameter
+ *		int	rtflg[]		output byte flags
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		The value of rtval[] is changed.
+ *		The rtflg[] values corresponding to all bytes
+ *		of higher order than x are cleared to reflect
+ *		the fact that x bytes are selected.
+ *
+ */
+
+a_uint adw_xb(x, v, i)
+int x;
+a_uint v;
+int i;
+{
+  a_uint j;
+  int n;
+
+  j = adb_xb(v, i);
+  /*
+   * X LS Bytes
+   */
+  i += (hilo ? 0 : x);
+  for (n = 0; n < (a_bytes - x); n++, i++) {
+    rtflg[i] = 0;
+  }
+  return (j);
+}
+
+/*)Function	a_uint 	adb_sel(p, v, i)
+ *
+ *		int	p		byte select
+ *		a_uint	v		value to add to byte
+ *		int	i		rtval[] index
+ *
+ *	The function adb_sel() adds the value of v to the
+ *	value contained in rtval[i] through rtval[i + a_bytes - 1].
+ *	The new value of rtval[i] ... is returned.
+ *	The rtflg[] flags are cleared for all rtval[i] ... except
+ *	for the p'th byte of the value.
+ *
+ *	local variable:
+ *		a_uint	j		temporary evaluation variable
+ *		int	m		selected byte index
+ *		int	n		loop counter
+ *
+ *	global variables:
+ *		int	a_bytes		T line byte count
+ *		int	hilo		byte ordering parameter
+ *		int	rtflg[]		output byte flags
+ *
+ *	called functions:
+ *		a_uint	adb_xb()	lkrloc.c
+ *
+ *	side effects:
+ *		The value of rtval[] is changed.
+ *		The rtflg[] values corresponding to all bytes
+ *		except the selected byte of the value are cleared
+ *		to reflect a single byte is selected.
+ *
+ */
+
+a_uint adb_sel(p, v, i)
+int p;
+a_uint v;
+int i;
+{
+  a_uint j;
+  int m, n;
+
+  j = adb_xb(v, i);
+  /*
+   * Select byte of data
+   */
+  m = (hilo ? a_bytes - 1 - p : p);
+  for (n = 0; n < a_bytes; n++) {
+    if (n != m)
+      rtflg[i + n] = 0;
+  }
+  return (j);
+}
+
+/*)Function	a_uint 	adb_byte(p, v, i)
+ *
+ *		int	p		byte select
+ *		a_uint	v		value to add to byte
+ *		int	i		rtval[] index
+ *
+ *	The function adb_byte() adds the value of v to the
+ *	value contained in rtval[i] through rtval[i + a_bytes - 1].
+ *	The p'th byte of the new value of rtval[i] ... is returned.
+ *	The rtflg[] flags are cleared for all rtval[i] ... except
+ *	for the selected byte.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		none
+ *
+ *	called functions:
+ *		a_uint	adb_sel()	lkrloc.c
+ *
+ *	side effects:
+ *		The value of rtval[] is changed.
+ *		The rtflg[] values corresponding to all bytes
+ *		except the selected byte of the value are cleared
+ *		to reflect a single byte is selected.
+ *
+ */
+
+a_uint adb_byte(p, v, i)
+int p;
+a_uint v;
+int i;
+{
+  return ((adb_sel(p, v, i) >> (8 * p)) & ((a_uint)0x000000FF));
+}
+
+/*)Function	a_uint 	gtb_1b(i)
+ *
+ *		int	i		rtval[] index
+ *
+ *	The function gtb_1b() returns the single
+ *	byte value contained in rtval[i].
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		a_uint	rtval[]		relocation data
+ *		int	rtend		end of the rtval[] data read
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		none
+ *
+ */
+
+a_uint gtb_1b(i)
+int i;
+{
+  if (i + 1 > rtend)
+    rtend = i + 1;
+  return (rtval[i]);
+}
+
+/*)Function	a_uint 	ptb_1b(v, i)
+ *
+ *		a_uint	v		value to put
+ *		int	i		rtval[] index
+ *
+ *	The function ptb_1b() places the byte value
+ *	of v into a single byte in rtval[i].
+ *	The new value of rtval[i] is returned.
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		a_uint	rtval[]		relocation data
+ *
+ *	called functions:
+ *		none
+ *
+ *	side effects:
+ *		The byte value of rtval[] is changed.
+ *
+ */
+
+a_uint ptb_1b(v, i)
+a_uint v;
+int i;
+{
+  return (rtval[i] = v & ((a_uint)0x000000FF));
+}
+
+/*)Function	a_uint 	gtb_2b(i)
+ *
+ *		int	i		rtval[] index
+ *
+ *	The function gtb_1b() returns the value of
+ *	2 bytes contained in rtval[i].
+ *
+ *	local variable:
+ *		none
+ *
+ *	global variables:
+ *		int	hilo		byte ordering parameter
+ *		a_uint	rtval[]		relocation data
+ *		a_uint	v		evaluation temporary
+ *		int	rtend		end of the rtval[] data read
+ *
+ *	called functions:
+ *		none
  *
- *	lkrloc.c the local variable errmsg[].
+ *	side effects:
+ *		none
  *
  */
 
-/*)Function	VOID	reloc(c)
+a_uint gtb_2b(i)
+int i;
+{
+  a_uint v;
+
+  if (i + 2 > rtend)
+    rtend = i + 2;
+
+  if (hilo) {
+    v = (rtval[i + 0] << 8) + (rtval[i + 1] << 0);
+  } else {
+    v = (rtval[i + 0] << 0) + (rtval[i + 1] << 8);
+  }
+  return (v);
+}
+
+/*)Function	a_uint 	ptb_2b(v, i)
  *
- *		int c			process code
+ *		int	v		value to put
+ *		int	i		rtval[] index
  *
- *	The function reloc() calls the proper version
- *	of the linker code.
+ *	The function ptb_1b() places the value
+ *	of v into 2 bytes of rtval[i].
+ *	The new value of rtval[i] is returned.
  *
  *	local variable:
  *		none
  *
  *	global variables:
- *		ASxxxx_VERSION		ASxxxx REL file version
+ *		int	hilo		byte ordering parameter
+ *		a_uint	rtval[]		relocation data
  *
  *	called functions:
- *		VOID	reloc3()	lkrloc3.c
- *		VOID	reloc4()	lkrloc4.c
+ *		none
  *
  *	side effects:
- *		Refer to the called relocation functions.
+ *		The value of rtval[] is changed.
  *
  */
 
-VOID reloc(c)
-int c;
+a_uint ptb_2b(v, i)
+a_uint v;
+int i;
 {
-  switch (ASxxxx_VERSION) {
-  case 3:
-    reloc3(c);
-    break;
-
-  case 4:
-    reloc4(c);
-    break;
-
-  default:
-    fprintf(stderr, "Internal Version Error");
-    lkexit(ER_FATAL);
-    break;
+  if (hilo) {
+    rtval[i + 0] = (v >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (v >> 0) & ((a_uint)0x000000FF);
+  } else {
+    rtval[i + 0] = (v >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (v >> 8) & ((a_uint)0x000000FF);
   }
+  return (v);
 }
 
-/*)Function	a_uint 	evword()
+/*)Function	a_uint 	gtb_3b(i)
  *
- *	The function evword() combines two byte values
- *	into a single word value.
+ *		int	i		rtval[] index
+ *
+ *	The function gtb_1b() returns the value of
+ *	3 bytes contained in rtval[i].
  *
  *	local variable:
- *		a_uint	v		temporary evaluation variable
+ *		none
  *
  *	global variables:
- *		hilo			byte ordering parameter
+ *		int	hilo		byte ordering parameter
+ *		a_uint	rtval[]		relocation data
+ *		a_uint	v		evaluation temporary
+ *		int	rtend		end of the rtval[] data read
  *
  *	called functions:
- *		int	eval()		lkeval.c
+ *		none
  *
  *	side effects:
- *		Relocation text line is scanned to combine
- *		two byte values into a single word value.
+ *		none
  *
  */
 
-a_uint evword() {
+a_uint gtb_3b(i)
+int i;
+{
   a_uint v;
 
+  if (i + 3 > rtend)
+    rtend = i + 3;
+
   if (hilo) {
-    v = (eval() << 8);
-    v += eval();
+    v = (rtval[i + 0] << 16) + (rtval[i + 1] << 8) + (rtval[i + 2] << 0);
   } else {
-    v = eval();
-    v += (eval() << 8);
+    v = (rtval[i + 0] << 0) + (rtval[i + 1] << 8) + (rtval[i + 2] << 16);
   }
   return (v);
 }
 
-/*)Function	a_uint 	adb_1b(v, i)
+/*)Function	a_uint 	ptb_3b(v, i)
  *
- *		a_uint	v		value to add to byte
+ *		int	v		value to put
  *		int	i		rtval[] index
  *
- *	The function adb_1b() adds the value of v to
- *	the single byte value contained in rtval[i].
+ *	The function ptb_1b() places the value
+ *	of v into 3 bytes of rtval[i].
  *	The new value of rtval[i] is returned.
  *
  *	local variable:
- *		a_uint	j		temporary evaluation variable
+ *		none
  *
  *	global variables:
- *		none
+ *		int	hilo		byte ordering parameter
+ *		a_uint	rtval[]		relocation data
  *
  *	called functions:
  *		none
  *
  *	side effects:
- *		The byte value of rtval[] is changed.
+ *		The value of rtval[] is changed.
  *
  */
 
-a_uint adb_1b(v, i)
+a_uint ptb_3b(v, i)
 a_uint v;
 int i;
 {
-  a_uint j;
-
-  j = v + rtval[i];
-  rtval[i] = j & ((a_uint)0x000000FF);
-
-  return (j);
+  if (hilo) {
+    rtval[i + 0] = (v >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (v >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (v >> 0) & ((a_uint)0x000000FF);
+  } else {
+    rtval[i + 0] = (v >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (v >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (v >> 16) & ((a_uint)0x000000FF);
+  }
+  return (v);
 }
 
-/*)Function	a_uint 	adb_2b(v, i)
+/*)Function	a_uint 	gtb_4b(i)
  *
- *		a_uint	v		value to add to word
  *		int	i		rtval[] index
  *
- *	The function adb_2b() adds the value of v to the
- *	2 byte value contained in rtval[i] and rtval[i+1].
- *	The new value of rtval[i] / rtval[i+1] is returned.
+ *	The function gtb_1b() returns the value of
+ *	4 bytes contained in rtval[i].
  *
  *	local variable:
- *		a_uint	j		temporary evaluation variable
+ *		none
  *
  *	global variables:
- *		hilo			byte ordering parameter
+ *		int	hilo		byte ordering parameter
+ *		a_uint	rtval[]		relocation data
+ *		a_uint	v		evaluation temporary
+ *		int	rtend		end of the rtval[] data read
  *
  *	called functions:
  *		none
  *
  *	side effects:
- *		The 2 byte value of rtval[] is changed.
+ *		none
  *
  */
 
-a_uint adb_2b(v, i)
-a_uint v;
+a_uint gtb_4b(i)
 int i;
 {
-  a_uint j;
+  a_uint v;
+
+  if (i + 4 > rtend)
+    rtend = i + 4;
 
   if (hilo) {
-    j = v + (rtval[i + 0] << 8) + (rtval[i + 1] << 0);
-    rtval[i + 0] = (j >> 8) & ((a_uint)0x000000FF);
-    rtval[i + 1] = (j >> 0) & ((a_uint)0x000000FF);
+    v = (rtval[i + 0] << 24) + (rtval[i + 1] << 16) + (rtval[i + 2] << 8) +
+        (rtval[i + 3] << 0);
   } else {
-    j = v + (rtval[i + 0] << 0) + (rtval[i + 1] << 8);
-    rtval[i + 0] = (j >> 0) & ((a_uint)0x000000FF);
-    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
+    v = (rtval[i + 0] << 0) + (rtval[i + 1] << 8) + (rtval[i + 2] << 16) +
+        (rtval[i + 3] << 24);
   }
-  return (j);
+  return (v);
 }
 
-/*)Function	a_uint 	adb_3b(v, i)
+/*)Function	a_uint 	ptb_4b(v, i)
  *
- *		a_uint	v		value to add to word
+ *		int	v		value to put
  *		int	i		rtval[] index
  *
- *	The function adb_3b() adds the value of v to the
- *	three byte value contained in rtval[i], rtval[i+1], and rtval[i+2].
- *	The new value of rtval[i] / rtval[i+1] / rtval[i+2] is returned.
+ *	The function ptb_1b() places the value
+ *	of v into 4 bytes of rtval[i].
+ *	The new value of rtval[i] is returned.
  *
  *	local variable:
- *		a_uint	j		temporary evaluation variable
+ *		none
  *
  *	global variables:
- *		hilo			byte ordering parameter
+ *		int	hilo		byte ordering parameter
+ *		a_uint	rtval[]		relocation data
  *
  *	called functions:
  *		none
  *
  *	side effects:
- *		The 3 byte value of rtval[] is changed.
+ *		The value of rtval[] is changed.
  *
  */
 
-a_uint adb_3b(v, i)
+a_uint ptb_4b(v, i)
 a_uint v;
 int i;
 {
-  a_uint j;
-
   if (hilo) {
-    j = v + (rtval[i + 0] << 16) + (rtval[i + 1] << 8) + (rtval[i + 2] << 0);
-    rtval[i + 0] = (j >> 16) & ((a_uint)0x000000FF);
-    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
-    rtval[i + 2] = (j >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 0] = (v >> 24) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (v >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (v >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 3] = (v >> 0) & ((a_uint)0x000000FF);
   } else {
-    j = v + (rtval[i + 0] << 0) + (rtval[i + 1] << 8) + (rtval[i + 2] << 16);
-    rtval[i + 0] = (j >> 0) & ((a_uint)0x000000FF);
-    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
-    rtval[i + 2] = (j >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 0] = (v >> 0) & ((a_uint)0x000000FF);
+    rtval[i + 1] = (v >> 8) & ((a_uint)0x000000FF);
+    rtval[i + 2] = (v >> 16) & ((a_uint)0x000000FF);
+    rtval[i + 3] = (v >> 24) & ((a_uint)0x000000FF);
   }
-  return (j);
+  return (v);
 }
 
-/*)Function	a_uint 	adb_4b(v, i)
+/*)Function	a_uint 	gtb_xb(i)
  *
- *		a_uint	v		value to add to word
  *		int	i		rtval[] index
  *
- *	The function adb_4b() adds the value of v to the
- *	four byte value contained in rtval[i], ..., rtval[i+3].
- *	The new value of rtval[i], ...,  rtval[i+3] is returned.
+ *	The function gtb_xb() returns the value of v
+ *	contained in rtval[i] for x-bytes.
  *
  *	local variable:
- *		a_uint	j		temporary evaluation variable
+ *		a_uint	v		evaluation temporary
  *
  *	global variables:
- *		hilo			byte ordering parameter
+ *		int	a_bytes		T Line Address Bytes
  *
  *	called functions:
- *		none
+ *		a_uint	gtb_1b()	lkrloc.c
+ *		a_uint	gtb_2b()	lkrloc.c
+ *		a_uint	gtb_3b()	lkrloc.c
+ *		a_uint	gtb_4b()	lkrloc.c
  *
  *	side effects:
- *		The 4 byte value of rtval[] is changed.
+ *		none
  *
  */
 
-a_uint adb_4b(v, i)
-a_uint v;
+a_uint gtb_xb(i)
 int i;
 {
-  a_uint j;
+  a_uint v;
 
-  if (hilo) {
-    j = v + (rtval[i + 0] << 24) + (rtval[i + 1] << 16) + (rtval[i + 2] << 8) +
-        (rtval[i + 3] << 0);
-    rtval[i + 0] = (j >> 24) & ((a_uint)0x000000FF);
-    rtval[i + 1] = (j >> 16) & ((a_uint)0x000000FF);
-    rtval[i + 2] = (j >> 8) & ((a_uint)0x000000FF);
-    rtval[i + 3] = (j >> 0) & ((a_uint)0x000000FF);
-  } else {
-    j = v + (rtval[i + 0] << 0) + (rtval[i + 1] << 8) + (rtval[i + 2] << 16) +
-        (rtval[i + 3] << 24);
-    rtval[i + 0] = (j >> 0) & ((a_uint)0x000000FF);
-    rtval[i + 1] = (j >> 8) & ((a_uint)0x000000FF);
-    rtval[i + 2] = (j >> 16) & ((a_uint)0x000000FF);
-    rtval[i + 3] = (j >> 24) & ((a_uint)0x000000FF);
+#ifdef LONGINT
+  switch (a_bytes) {
+  case 1:
+    v = gtb_1b(i);
+    v = (v & ((a_uint)0x00000080l) ? v | ~((a_uint)0x0000007Fl)
+                                   : v & ((a_uint)0x0000007Fl));
+    break;
+  case 2:
+    v = gtb_2b(i);
+    v = (v & ((a_uint)0x00008000l) ? v | ~((a_uint)0x00007FFFl)
+                                   : v & ((a_uint)0x00007FFFl));
+    break;
+  case 3:
+    v = gtb_3b(i);
+    v = (v & ((a_uint)0x00800000l) ? v | ~((a_uint)0x007FFFFFl)
+                                   : v & ((a_uint)0x007FFFFFl));
+    break;
+  case 4:
+    v = gtb_4b(i);
+    v = (v & ((a_uint)0x80000000l) ? v | ~((a_uint)0x7FFFFFFFl)
+                                   : v & ((a_uint)0x7FFFFFFFl));
+    break;
+  default:
+    v = 0;
+    break;
   }
-  return (j);
+#else
+  switch (a_bytes) {
+  case 1:
+    v = gtb_1b(i);
+    v = (v & ((a_uint)0x00000080) ? v | ~((a_uint)0x0000007F)
+                                  : v & ((a_uint)0x0000007F));
+    break;
+  case 2:
+    v = gtb_2b(i);
+    v = (v & ((a_uint)0x00008000) ? v | ~((a_uint)0x00007FFF)
+                                  : v & ((a_uint)0x00007FFF));
+    break;
+  case 3:
+    v = gtb_3b(i);
+    v = (v & ((a_uint)0x00800000) ? v | ~((a_uint)0x007FFFFF)
+                                  : v & ((a_uint)0x007FFFFF));
+    break;
+  case 4:
+    v = gtb_4b(i);
+    v = (v & ((a_uint)0x80000000) ? v | ~((a_uint)0x7FFFFFFF)
+                                  : v & ((a_uint)0x7FFFFFFF));
+    break;
+  default:
+    v = 0;
+    break;
+  }
+#endif
+  return (v);
 }
 
-/*)Function	a_uint 	adb_xb(v, i)
+/*)Function	a_uint 	ptb_xb(v, i)
  *
- *		a_uint	v		value to add to x-bytes
+ *		int	v		value to add to x-bytes
  *		int	i		rtval[] index
  *
- *	The function adb_xb() adds the value of v to
- *	the value contained in rtval[i] for x-bytes.
+ *	The function ptb_xb() places the value of v
+ *	in rtval[i] for x-bytes.
  *	The new value of rtval[i] for x-bytes is returned.
  *
  *	local variable:
- *		none
+ *		a_uint	j		evaluation temporary
  *
  *	global variables:
  *		int	a_bytes		T Line Address Bytes
  *
  *	called functions:
- *		a_uint	adb_1b()	lkrloc.c
- *		a_uint	adb_2b()	lkrloc.c
- *		a_uint	adb_3b()	lkrloc.c
- *		a_uint	adb_4b()	lkrloc.c
+ *		a_uint	ptb_1b()	lkrloc.c
+ *		a_uint	ptb_2b()	lkrloc.c
+ *		a_uint	ptb_3b()	lkrloc.c
+ *		a_uint	ptb_4b()	lkrloc.c
  *
  *	side effects:
  *		The x-byte value of rtval[] is changed.
  *
  */
 
-a_uint adb_xb(v, i)
+a_uint ptb_xb(v, i)
 a_uint v;
 int i;
 {
@@ -327,22 +2134,22 @@ int i;
 #ifdef LONGINT
   switch (a_bytes) {
   case 1:
-    j = adb_1b(v, i);
+    j = ptb_1b(v, i);
     j = (j & ((a_uint)0x00000080l) ? j | ~((a_uint)0x0000007Fl)
                                    : j & ((a_uint)0x0000007Fl));
     break;
   case 2:
-    j = adb_2b(v, i);
+    j = ptb_2b(v, i);
     j = (j & ((a_uint)0x00008000l) ? j | ~((a_uint)0x00007FFFl)
                                    : j & ((a_uint)0x00007FFFl));
     break;
   case 3:
-    j = adb_3b(v, i);
+    j = ptb_3b(v, i);
     j = (j & ((a_uint)0x00800000l) ? j | ~((a_uint)0x007FFFFFl)
                                    : j & ((a_uint)0x007FFFFFl));
     break;
   case 4:
-    j = adb_4b(v, i);
+    j = ptb_4b(v, i);
     j = (j & ((a_uint)0x80000000l) ? j | ~((a_uint)0x7FFFFFFFl)
                                    : j & ((a_uint)0x7FFFFFFFl));
     break;
@@ -353,22 +2160,22 @@ int i;
 #else
   switch (a_bytes) {
   case 1:
-    j = adb_1b(v, i);
+    j = ptb_1b(v, i);
     j = (j & ((a_uint)0x00000080) ? j | ~((a_uint)0x0000007F)
                                   : j & ((a_uint)0x0000007F));
     break;
   case 2:
-    j = adb_2b(v, i);
+    j = ptb_2b(v, i);
     j = (j & ((a_uint)0x00008000) ? j | ~((a_uint)0x00007FFF)
                                   : j & ((a_uint)0x00007FFF));
     break;
   case 3:
-    j = adb_3b(v, i);
+    j = ptb_3b(v, i);
     j = (j & ((a_uint)0x00800000) ? j | ~((a_uint)0x007FFFFF)
                                   : j & ((a_uint)0x007FFFFF));
     break;
   case 4:
-    j = adb_4b(v, i);
+    j = ptb_4b(v, i);
     j = (j & ((a_uint)0x80000000) ? j | ~((a_uint)0x7FFFFFFF)
                                   : j & ((a_uint)0x7FFFFFFF));
     break;
@@ -379,56 +2186,6 @@ int i;
 #endif
   return (j);
 }
-
-/*)Function	a_uint 	adw_xb(x, v, i)
- *
- *		int	x		number of bytes to allow
- *		a_uint	v		value to add to byte
- *		int	i		rtval[] index
- *
- *	The function adw_xb() adds the value of v to the
- *	value contained in rtval[i] through rtval[i + a_bytes - 1].
- *	The new value of rtval[i] .... is returned.
- *	The rtflg[] is cleared for bytes of higher order than x.
- *
- *	local variable:
- *		a_uint	j		temporary evaluation variable
- *
- *	global variables:
- *		int	a_bytes		T line byte count
- *		int	hilo		byte ordering parameter
- *		int	rtflg[]		output byte flags
- *
- *	called functions:
- *		none
- *
- *	side effects:
- *		The value of rtval[] is changed.
- *		The rtflg[] values corresponding to all bytes
- *		of higher order than x are cleared to reflect
- *		the fact that x bytes are selected.
- *
- */
-
-a_uint adw_xb(x, v, i)
-int x;
-a_uint v;
-int i;
-{
-  a_uint j;
-  int n;
-
-  j = adb_xb(v, i);
-  /*
-   * X LS Bytes
-   */
-  i += (hilo ? 0 : x);
-  for (n = 0; n < (a_bytes - x); n++, i++) {
-    rtflg[i] = 0;
-  }
-  return (j);
-}
-
 /*)Function	VOID	prntval(fptr, v)
  *
  *		FILE	*fptr		output file handle
@@ -34,9 +34,17 @@
  *	lksdcdb.c contains the following functions:
  *		VOID	SDCDBfopen()
  *		VOID	SDCDBcopy()
+ *		int	SDCDBtype()
  *		VOID	DefineSDCDB()
+ *
+ *	lksdcdb.c contains the following local variables:
+ *		char	cdbbuf[]	copy buffer
+ *		struct cdbtyp *	cdbtyp[]	copied type records
  */
 
+static char cdbbuf[NCDBBUF];
+static struct cdbtyp *cdbtyp[NCDBHASH];
+
 /*)Function	VOID	SDCDBfopen()
  *
  *	The function SDCDBfopen() opens the SDCDB output file
@@ -77,23 +85,38 @@ VOID SDCDBfopen(void) {
  *		char *	str		pointer to the file spec
  *
  *	The function SDCDBcopy() copies an existing cdb file
- *	into the linker cdb file.
+ *	into the linker cdb file.  The file is copied in blocks
+ *	of NCDBBUF bytes.  With -yy the blocks are split into
+ *	records and a type record (T:) which has already been
+ *	copied from another module is not copied again.  A
+ *	record longer than the buffer is always copied.
  *
  * 	The function is called from lklex.c and lklibr.c
  *
  *	local variables:
+ *		char *	cp		start of the text to copy
+ *		char *	ep		end of the complete records
+ *		char *	p		start of a record
+ *		char *	q		end of a record
+ *		int	m		bytes read
+ *		int	n		bytes in the buffer
+ *		int	part		the buffer starts within
+ *					a long record
  *		FILE *	xfp		file handle
- *		char	line[]		line from file
  *
  *	global variables:
+ *		char	cdbbuf[]	copy buffer
  *		int	yflag		SDCDB Debug flag
  *		FILE *	yfp		SDCDB Debug File handle
  *
  *	functions called:
  *		FILE *	afile()		lkmain.c
- *		int	fgets()		c_library
- *		int	fprintf()	c_library
  *		int	fclose()	c_library
+ *		size_t	fread()		c_library
+ *		size_t	fwrite()	c_library
+ *		VOID *	memchr()	c_library
+ *		VOID *	memmove()	c_library
+ *		int	SDCDBtype()	lksdcdb.c
  *
  *	side effects:
  *		SDCDB cdb file is copied into
@@ -104,7 +127,8 @@ VOID SDCDBcopy(str)
 char *str;
 {
   FILE *xfp;
-  char line[NINPUT];
+  char *cp, *ep, *p, *q;
+  int m, n, part;
 
   /*
    * Copy cdb file if present and requested.
@@ -112,14 +136,112 @@ char *str;
   if (yflag && yfp) {
     xfp = afile(str, "cdb", 0);
     if (xfp) {
-      while (fgets(line, sizeof(line), xfp) != NULL) {
-        fprintf(yfp, "%s", line);
-      }
+      n = 0;
+      part = 0;
+      do {
+        m = (int)fread(&cdbbuf[n], 1, NCDBBUF - n, xfp);
+        n += m;
+        if (yflag == 1) {
+          fwrite(cdbbuf, 1, n, yfp);
+          n = 0;
+          continue;
+        }
+        /*
+         * Complete records end with a newline,
+         * at the end of the file or when the
+         * buffer is full all the text is copied.
+         */
+        ep = &cdbbuf[n];
+        if ((m != 0) && (n != NCDBBUF)) {
+          continue;
+        }
+        if (m != 0) {
+          while ((ep > cdbbuf) && (ep[-1] != '\n')) {
+            ep--;
+          }
+          if (ep == cdbbuf) {
+            fwrite(cdbbuf, 1, n, yfp);
+            n = 0;
+            part = 1;
+            continue;
+          }
+        }
+        /*
+         * Skip the repeated type records
+         */
+        for (cp = p = cdbbuf; p < ep; p = q, part = 0) {
+          q = (char *)memchr(p, '\n', ep - p);
+          q = (q == NULL) ? ep : q + 1;
+          if ((part == 0) && (p[0] == 'T') && (p[1] == ':') &&
+              SDCDBtype(p, (int)(q - p))) {
+            fwrite(cp, 1, p - cp, yfp);
+            cp = q;
+          }
+        }
+        fwrite(cp, 1, ep - cp, yfp);
+        n -= (int)(ep - cdbbuf);
+        memmove(cdbbuf, ep, n);
+      } while (m != 0);
       fclose(xfp);
     }
   }
 }
 
+/*)Function	int	SDCDBtype(rec, len)
+ *
+ *		char *	rec		pointer to the type record
+ *		int	len		record length
+ *
+ *	The function SDCDBtype() looks up a type record
+ *	in the copied type records.  A new type record is
+ *	added to the hash table.
+ *
+ *	SDCDBtype() returns 1 if the type record has
+ *	already been copied and 0 otherwise.
+ *
+ *	local variables:
+ *		char *	p		pointer into the record
+ *		unsigned int	h	hash value
+ *		int	i		loop counter
+ *		struct cdbtyp *	tp	type record
+ *
+ *	global variables:
+ *		struct cdbtyp *	cdbtyp[]	copied type records
+ *
+ *	functions called:
+ *		int	memcmp()	c_library
+ *		VOID *	memcpy()	c_library
+ *		VOID *	new()		lksym.c
+ *
+ *	side effects:
+ *		A new type record is added to the hash table.
+ */
+
+int SDCDBtype(rec, len)
+char *rec;
+int len;
+{
+  struct cdbtyp *tp;
+  unsigned int h;
+  char *p;
+  int i;
+
+  for (h = 0, p = rec, i = 0; i < len; i++) {
+    h = (h * 31) + (*p++ & 0xFF);
+  }
+  for (tp = cdbtyp[h & CDBHMASK]; tp != NULL; tp = tp->t_tp) {
+    if ((tp->t_len == len) && (memcmp(tp->t_rec, rec, len) == 0))
+      return (1);
+  }
+  tp = (struct cdbtyp *)new (sizeof(struct cdbtyp));
+  tp->t_rec = (char *)new (len);
+  memcpy(tp->t_rec, rec, len);
+  tp->t_len = len;
+  tp->t_tp = cdbtyp[h & CDBHMASK];
+  cdbtyp[h & CDBHMASK] = tp;
+  return (0);
+}
+
 /*)Function	VOID	DefineSDCDB()
  *
  *		char *	name		pointer to the symbol string
@@ -164,6 +286,7 @@ a_uint value;
   j = 0;
   p1 = name;
   while ((p1 = strchr(p1, '$')) != NULL) {
+    p1 += 1;
     j += 1;
   }
 
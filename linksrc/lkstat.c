@@ -0,0 +1,280 @@
+/* lkstat.c */
+
+/*
+ *  Copyright (C) 1989-2017  Alan R. Baldwin
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * Alan R. Baldwin
+ * 721 Berkeley St.
+ * Kent, Ohio  44240
+ */
+
+#include "aslink.h"
+
+/*)Module	lkstat.c
+ *
+ *	The module lkstat.c contains the functions which
+ *	collect and report the linker timing and counter
+ *	statistics selected by the -a (and -aa for JSON)
+ *	option.
+ *
+ *	The elapsed time is charged to the current phase.
+ *	stphase() switches the current phase and returns the
+ *	previous phase so that the caller can restore it.
+ *	The counters in the lkstat structure lkst are updated
+ *	directly by the linker functions.
+ *
+ *	lkstat.c contains the following functions:
+ *		VOID	stinit()
+ *		VOID	stlist(fp)
+ *		int	stphase(ph)
+ *		double	sttime()
+ *
+ *	lkstat.c contains the following local variables:
+ *		int	stph		current phase
+ *		double	sttlast		time of the last phase change
+ *		char *	stname[][]	phase names and JSON keys
+ *		char *	stcnt[][]	counter names and JSON keys
+ */
+
+static int stph = PH_OTHER;
+static double sttlast;
+
+static char *stname[NPHASE][2] = {{"Other", "other"},
+                                  {"Command Parsing", "parse"},
+                                  {"Pass 0 Load", "load"},
+                                  {"Library Search", "search"},
+                                  {"Area Link", "area"},
+                                  {"Symbol Definition", "symdef"},
+                                  {"Map Output", "map"},
+                                  {"Pass 1 Relocation", "reloc"},
+                                  {"Output Formatting", "output"},
+                                  {"Listing Update", "list"}};
+
+static char *stcnt[NSTCNT][2] = {{"REL Lines", "lines"},
+                                 {"Modules", "modules"},
+                                 {"Search Rounds", "search_rounds"},
+                                 {"Library Files", "library_files"},
+                                 {"Library Lines", "library_lines"},
+                                 {"Symbols Resolved", "library_symbols"},
+                                 {"T Records", "t_records"},
+                                 {"R Records", "r_records"},
+                                 {"T Data Bytes", "t_bytes"},
+                                 {"Relocations", "relocations"},
+                                 {"  Symbol", "reloc_symbol"},
+                                 {"  Plain", "reloc_plain"},
+                                 {"  MSB", "reloc_msb"},
+                                 {"  PC Relative", "reloc_pcr"},
+                                 {"  Paged", "reloc_page"},
+                                 {"  PAGX", "reloc_pagx"},
+                                 {"  Merge Mode", "reloc_merge"},
+                                 {"  Errors", "reloc_errors"},
+                                 {"Output Records", "output_records"},
+                                 {"Output Bytes", "output_bytes"},
+                                 {"Listing Lines", "listing_lines"},
+                                 {"Relink Replays", "relink_replays"},
+                                 {"GC Sections Removed", "gc_sections"},
+                                 {"GC Bytes Removed", "gc_bytes"},
+                                 {"GC Library Files", "gc_library_files"},
+                                 {"Relaxable Jumps", "relax_jumps"},
+                                 {"Jumps Relaxed to jr", "relax_jr"},
+                                 {"Relaxation Passes", "relax_passes"}};
+
+/*)Function	double	sttime()
+ *
+ *	The function sttime() returns the current time in
+ *	seconds.  A monotonic wall clock is used when it is
+ *	available else the processor time from clock().
+ *
+ *	local variables:
+ *		struct timespec	ts	time value
+ *
+ *	global variables:
+ *		none
+ *
+ *	functions called:
+ *		int	clock_gettime()	c_library
+ *		clock_t	clock()		c_library
+ *
+ *	side effects:
+ *		none
+ */
+
+double sttime() {
+#ifdef CLOCK_MONOTONIC
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec);
+#else
+  return ((double)clock() / (double)CLOCKS_PER_SEC);
+#endif
+}
+
+/*)Function	VOID	stinit()
+ *
+ *	The function stinit() starts the statistics
+ *	timer in phase PH_PARSE.
+ *
+ *	local variables:
+ *		none
+ *
+ *	global variables:
+ *		int	stph		current phase
+ *		double	sttlast		time of the last phase change
+ *
+ *	functions called:
+ *		double	sttime()	lkstat.c
+ *
+ *	side effects:
+ *		The statistics timer is started.
+ */
+
+VOID stinit() {
+  stph = PH_PARSE;
+  sttlast = sttime();
+}
+
+/*)Function	int	stphase(ph)
+ *
+ *		int	ph		new phase
+ *
+ *	The function stphase() charges the time since the
+ *	last phase change to the current phase and then makes
+ *	ph the current phase.  Without -a only the phase
+ *	number is changed.
+ *
+ *	stphase() returns the previous phase.
+ *
+ *	local variables:
+ *		int	i		previous phase
+ *		double	t		current time
+ *
+ *	global variables:
+ *		int	aflag		-a, link statistics flag
+ *		struct lkstat	lkst	link statistics
+ *		int	stph		current phase
+ *		double	sttlast		time of the last phase change
+ *
+ *	functions called:
+ *		double	sttime()	lkstat.c
+ *
+ *	side effects:
+ *		The current phase is changed.
+ */
+
+int stphase(ph)
+int ph;
+{
+  int i;
+  double t;
+
+  i = stph;
+  if (aflag) {
+    t = sttime();
+    lkst.st_time[i] += t - sttlast;
+    sttlast = t;
+  }
+  stph = ph;
+  return (i);
+}
+
+/*)Function	VOID	stlist(fp)
+ *
+ *		FILE *	fp		output file handle
+ *
+ *	The function stlist() outputs the timing and counter
+ *	statistics of the link.  With -aa the statistics are
+ *	output as a JSON object.
+ *
+ *	local variables:
+ *		double	t		total time
+ *		int	i		loop counter
+ *		int	n		search() rounds reported
+ *
+ *	global variables:
+ *		int	aflag		-a, link statistics flag
+ *		struct lkstat	lkst	link statistics
+ *
+ *	functions called:
+ *		int	fprintf()	c_library
+ *		int	stphase()	lkstat.c
+ *
+ *	side effects:
+ *		The statistics are written to fp.
+ */
+
+VOID stlist(fp)
+FILE *fp;
+{
+  double t;
+  int i, n;
+
+  stphase(stph);
+
+  for (t = 0.0, i = 0; i < NPHASE; i++) {
+    t += lkst.st_time[i];
+  }
+  n = (int)lkst.st_cnt[ST_LBROUND];
+  if (n > NSTRND) {
+    n = NSTRND;
+  }
+
+  if (aflag > 1) {
+    /*
+     * JSON Output
+     */
+    fprintf(fp, "{\"linker\": \"ASxxxx Linker %s\",\n", VERSION);
+    fprintf(fp, " \"time_ms\": %.3f,\n \"phases_ms\": {", 1000.0 * t);
+    for (i = 0; i < NPHASE; i++) {
+      fprintf(fp, "%s\"%s\": %.3f", i ? ", " : "", stname[i][1],
+              1000.0 * lkst.st_time[i]);
+    }
+    fprintf(fp, "},\n \"counters\": {");
+    for (i = 0; i < NSTCNT; i++) {
+      fprintf(fp, "%s\"%s\": %ld", i ? ", " : "", stcnt[i][1],
+              lkst.st_cnt[i]);
+    }
+    fprintf(fp, "},\n \"search_resolved\": [");
+    for (i = 0; i < n; i++) {
+      fprintf(fp, "%s%ld", i ? ", " : "", lkst.st_rnd[i]);
+    }
+    fprintf(fp, "]}\n");
+    return;
+  }
+
+  /*
+   * Formatted Output
+   */
+  fprintf(fp, "\nLinker Statistics (milliseconds)\n");
+  for (i = 0; i < NPHASE; i++) {
+    fprintf(fp, "%-20s %10.3f\n", stname[i][0], 1000.0 * lkst.st_time[i]);
+  }
+  fprintf(fp, "%-20s %10.3f\n\n", "Total", 1000.0 * t);
+
+  fprintf(fp, "Linker Counters\n");
+  for (i = 0; i < NSTCNT; i++) {
+    fprintf(fp, "%-20s %10ld\n", stcnt[i][0], lkst.st_cnt[i]);
+  }
+  if (n != 0) {
+    fprintf(fp, "%-20s", "Resolved Per Round");
+    for (i = 0; i < n; i++) {
+      fprintf(fp, " %ld", lkst.st_rnd[i]);
+    }
+    fprintf(fp, "\n");
+  }
+  fprintf(fp, "\n");
+}